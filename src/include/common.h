@@ -99,6 +99,7 @@ typedef enum : uint8_t
     RATE_FSK_2G4_1000HZ,
     RATE_FSK_900_1000HZ,
     RATE_FSK_900_1000HZ_8CH,
+    RATE_LORA_250HZ_8CH_RS,
 } expresslrs_RFrates_e;
 
 enum {
@@ -166,7 +167,7 @@ typedef struct expresslrs_mod_settings_s
     expresslrs_tlm_ratio_e TLMinterval;        // every X packets is a response TLM packet, should be a power of 2
     uint8_t FHSShopInterval;    // every X packets we hop to a new frequency. Max value of 16 since only 4 bits have been assigned in the sync package.
     int32_t interval;           // interval in us seconds that corresponds to that frequency
-    uint8_t PayloadLength;      // Number of OTA bytes to be sent.
+    uint8_t PayloadLength;      // Number of OTA bytes to be sent. OTA4_PACKET_SIZE, OTA8_PACKET_SIZE or OTA8_RS_PACKET_SIZE (USE_OTA8_RS) for OTA8 with Reed-Solomon parity
     uint8_t numOfSends;         // Number of packets to send.
 } expresslrs_mod_settings_t;
 
@@ -250,6 +251,14 @@ enum eFailsafeMode : uint8_t
     FAILSAFE_SET_POSITION
 };
 
+enum eSbusRate : uint8_t
+{
+    SBUS_RATE_NORMAL,   // 9ms, the rate before the output followed the RF packets
+    SBUS_RATE_FAST_7MS,
+    SBUS_RATE_FAST_5MS,
+    SBUS_RATE_FAST_4MS
+};
+
 enum eAuxChannels : uint8_t
 {
     AUX1 = 4,
@@ -287,7 +296,7 @@ extern SX127xDriver Radio;
 extern LR1121Driver Radio;
 
 #elif defined(RADIO_SX128X)
-#define RATE_MAX 10     // 2xFLRC + 2xDVDA + 4xLoRa + 2xFullRes
+#define RATE_MAX 11     // 2xFLRC + 2xDVDA + 4xLoRa + 2xFullRes + FullRes RS
 #define RATE_BINDING RATE_LORA_50HZ
 
 extern SX1280Driver Radio;
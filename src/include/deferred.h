@@ -1,11 +1,172 @@
 #pragma once
 
-#include <functional>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
 
-void deferExecutionMicros(unsigned long us, std::function<void()> f);
-void executeDeferredFunction(unsigned long now);
+#include "targets.h"
+#include "logging.h"
 
-static inline void deferExecutionMillis(unsigned long ms, std::function<void()> f)
+typedef uint16_t deferred_handle_t;
+#define DEFERRED_HANDLE_NONE 0
+
+/**
+ * @brief A fixed capacity pool of functions to be called once after a delay.
+ *
+ * The functions (function pointers or lambdas) are copied into storage inside the pool, so
+ * deferring one never allocates. A lambda which captures more than STORAGE_SIZE bytes, or
+ * captures something which is not trivially copyable (e.g. a String), fails to compile.
+ *
+ * Each deferred function gets a handle which can be used to cancel it. The handle includes a
+ * generation count, so a stale handle does not cancel a later function which reused the slot.
+ *
+ * @tparam CAPACITY the number of functions which can be pending at once
+ * @tparam STORAGE_SIZE the maximum size of each function, in bytes
+ */
+template <uint8_t CAPACITY, uint8_t STORAGE_SIZE = 16>
+class DeferredQueue
+{
+    static_assert(CAPACITY > 0 && CAPACITY <= 16, "DeferredQueue capacity must be 1-16 to fit in a handle");
+
+public:
+    /**
+     * @brief Call `f` once when `us` microseconds have elapsed since `now`
+     * @return a handle to cancel the call, or DEFERRED_HANDLE_NONE if the pool is full
+     */
+    template <typename F>
+    deferred_handle_t defer(unsigned long now, unsigned long us, F f)
+    {
+        static_assert(sizeof(F) <= STORAGE_SIZE, "Deferred function captures too much to fit in the DeferredQueue");
+        static_assert(alignof(F) <= alignof(void *), "Deferred function alignment is too large for the DeferredQueue");
+        static_assert(std::is_trivially_copyable<F>::value, "Deferred function must only capture trivially copyable values");
+
+        for (uint8_t i = 0; i < CAPACITY; i++)
+        {
+            entry_t &entry = entries[i];
+            if (entry.invoke == nullptr)
+            {
+                memcpy(entry.storage, &f, sizeof(F));
+                entry.invoke = &invoke<F>;
+                entry.deadline = now + us;
+                // Generation 0 is never used so a handle is never DEFERRED_HANDLE_NONE
+                if (++entry.generation == 0)
+                {
+                    entry.generation = 1;
+                }
+                return (entry.generation << 4) | i;
+            }
+        }
+        return DEFERRED_HANDLE_NONE;
+    }
+
+    /**
+     * @brief Cancel a deferred function which has not been called yet
+     * @return true if the function was pending and is now cancelled
+     */
+    bool cancel(deferred_handle_t handle)
+    {
+        const uint8_t i = handle & 0x0f;
+        if (handle == DEFERRED_HANDLE_NONE || i >= CAPACITY)
+        {
+            return false;
+        }
+        entry_t &entry = entries[i];
+        if (entry.invoke == nullptr || entry.generation != (uint8_t)(handle >> 4))
+        {
+            return false;
+        }
+        entry.invoke = nullptr;
+        return true;
+    }
+
+    /**
+     * @brief Call the functions whose time has elapsed, earliest deadline first.
+     * Each function's slot is freed before it is called, so it can defer another function.
+     */
+    void execute(unsigned long now)
+    {
+        for (;;)
+        {
+            entry_t *next = nullptr;
+            for (uint8_t i = 0; i < CAPACITY; i++)
+            {
+                entry_t &entry = entries[i];
+                if (entry.invoke != nullptr && (int32_t)(now - entry.deadline) > 0
+                    && (next == nullptr || (int32_t)(entry.deadline - next->deadline) < 0))
+                {
+                    next = &entry;
+                }
+            }
+            if (next == nullptr)
+            {
+                return;
+            }
+
+            void (* const invokeNext)(const void *) = next->invoke;
+            void *storage[(STORAGE_SIZE + sizeof(void *) - 1) / sizeof(void *)];
+            memcpy(storage, next->storage, STORAGE_SIZE);
+            next->invoke = nullptr;
+            invokeNext(storage);
+        }
+    }
+
+    /**
+     * @return the number of functions waiting to be called
+     */
+    uint8_t pending() const
+    {
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < CAPACITY; i++)
+        {
+            count += entries[i].invoke != nullptr;
+        }
+        return count;
+    }
+
+private:
+    typedef struct {
+        unsigned long deadline;
+        void (*invoke)(const void *storage);
+        uint8_t generation;
+        alignas(void *) uint8_t storage[STORAGE_SIZE];
+    } entry_t;
+
+    entry_t entries[CAPACITY] = {};
+
+    template <typename F>
+    static void invoke(const void *storage)
+    {
+        (*static_cast<const F *>(storage))();
+    }
+};
+
+static constexpr uint8_t maxDeferredFunctions = 4;
+extern DeferredQueue<maxDeferredFunctions> deferredFunctions;
+
+template <typename F>
+static inline deferred_handle_t deferExecutionMicros(unsigned long us, F f)
+{
+    const deferred_handle_t handle = deferredFunctions.defer(micros(), us, f);
+    if (handle == DEFERRED_HANDLE_NONE)
+    {
+        // Bail out, there are no slots available!
+        DBGLN("No more deferred function slots available!");
+    }
+    return handle;
+}
+
+template <typename F>
+static inline deferred_handle_t deferExecutionMillis(unsigned long ms, F f)
+{
+    return deferExecutionMicros(ms * 1000, f);
+}
+
+static inline bool cancelDeferredExecution(deferred_handle_t handle)
+{
+    return deferredFunctions.cancel(handle);
+}
+
+static inline void executeDeferredFunction(unsigned long now)
 {
-    deferExecutionMicros(ms * 1000, f);
-}
\ No newline at end of file
+    deferredFunctions.execute(now);
+}
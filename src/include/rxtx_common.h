@@ -12,6 +12,7 @@
 #include "LQCALC.h"
 #include "OTA.h"
 #include "POWERMGNT.h"
+#include "trace.h"
 #include "deferred.h"
 
 void setupTargetCommon();
@@ -25,6 +25,10 @@
 #define DMA_ATTR
 #endif
 
+#ifndef DRAM_ATTR
+#define DRAM_ATTR
+#endif
+
 /*
  * Features
  * define features based on pins before defining pins as UNDEF_PIN
@@ -263,6 +267,10 @@ extern bool pwmSerialDefined;
 #undef Regulatory_Domain_EU_433
 #undef Regulatory_Domain_US_433
 #undef Regulatory_Domain_US_433_WIDE
+#if !defined(UNIT_TEST)
+// RATE_LORA_250HZ_8CH_RS sends OTA8 with Reed-Solomon parity, native tests opt in per env
+#define USE_OTA8_RS
+#endif
 
 #elif defined(RADIO_SX127X) || defined(RADIO_LR1121)
 #if !(defined(Regulatory_Domain_AU_915) || defined(Regulatory_Domain_FCC_915) || \
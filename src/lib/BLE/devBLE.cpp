@@ -98,7 +98,8 @@ device_t BLE_device = {
   .initialize = initialize,
   .start = NULL,
   .event = event,
-  .timeout = timeout
+  .timeout = timeout,
+  .events = EVENT_CONNECTION_CHANGED
 };
 
 #endif
\ No newline at end of file
@@ -409,5 +409,6 @@ device_t Backpack_device = {
     .initialize = initialize,
     .start = start,
     .event = event,
-    .timeout = timeout
+    .timeout = timeout,
+    .events = EVENT_CONNECTION_CHANGED | EVENT_CONFIG_CHANGED
 };
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <stdint.h>
+#include "crc.h"
+
+#define JOURNAL_CRC16_POLY 0x3D65   // ELRS_CRC16_POLY, which has a lookup table on every target
+#define JOURNAL_MAGIC 0x4A4C        // "LJ"
+
+/**
+ * @brief An append-only journal of the changes to a config struct, kept in a region of NOR flash
+ * alongside a snapshot of the whole struct (e.g. in EEPROM)
+ *
+ * A commit programs a record of just the bytes which changed, instead of erasing and rewriting the
+ * snapshot. When the region is full the caller writes a new snapshot and calls Clear(), which is the
+ * only time the region is erased. The flash must read 0xFF when erased, only be programmed when
+ * erased, and accept writes of a multiple of 4 bytes to 4 byte aligned addresses.
+ *
+ * The journal starts with a header holding the CRC of the snapshot it applies to, so it is ignored
+ * if the snapshot is rewritten by anything else. It is followed by records of
+ *   uint16_t offset:10, (length - 1):5, last:1
+ *   uint16_t CRC16 of the field above and the data
+ *   uint8_t  data[length], padded with 0xFF to a multiple of 4 bytes
+ * The data of a record is written before its header. A commit is the records up to one with `last`
+ * set, and Replay() only applies whole commits, so one cut short by a power loss is lost as a whole
+ * rather than leaving the config half changed.
+ *
+ * Flash provides Read(addr, buf, len), Write(addr, buf, len) and Erase() of the whole region.
+ */
+template <class Flash>
+class ConfigJournal
+{
+public:
+    static constexpr uint8_t HEADER_LEN = 4;
+    static constexpr uint8_t RECORD_HEADER_LEN = 4;
+    static constexpr uint8_t RECORD_MAX_DATA = 32;
+    static constexpr uint16_t CONFIG_MAX_LEN = 1024;
+
+    ConfigJournal(Flash &flash, uint32_t start, uint32_t end)
+        : m_flash(flash), m_start(start), m_end(end), m_writePos(start)
+    {
+        m_crc.init(16, JOURNAL_CRC16_POLY);
+    }
+
+    /**
+     * @brief Apply the journal to `config`, which has just been loaded from the snapshot
+     * @return false if the journal could not all be used, because it is for another snapshot or
+     * ends in a partly written commit. The caller must then write `config` as the snapshot and Clear().
+     */
+    bool Replay(uint8_t *config, uint16_t len)
+    {
+        m_writePos = m_start;
+        uint8_t header[HEADER_LEN];
+        m_flash.Read(m_start, header, HEADER_LEN);
+        if (isErased(header, HEADER_LEN))
+        {
+            return isErasedFrom(m_start + HEADER_LEN);
+        }
+        if (header[0] != (JOURNAL_MAGIC & 0xFF) || header[1] != (JOURNAL_MAGIC >> 8) ||
+            (header[2] | header[3] << 8) != snapshotCrc(config, len))
+        {
+            return false;
+        }
+
+        // Find the end of the last whole commit before applying any of it
+        const uint32_t first = m_start + HEADER_LEN;
+        uint32_t pos = first;
+        uint32_t committed = first;
+        uint8_t record[RECORD_HEADER_LEN + RECORD_MAX_DATA];
+        uint16_t offset = 0;
+        uint8_t length = 0;
+        bool last = false;
+        while (readRecord(pos, record, len, &offset, &length, &last))
+        {
+            pos += recordSize(length);
+            if (last)
+            {
+                committed = pos;
+            }
+        }
+
+        for (pos = first; pos < committed; pos += recordSize(length))
+        {
+            readRecord(pos, record, len, &offset, &length, &last);
+            for (uint8_t i = 0; i < length; i++)
+            {
+                config[offset + i] = record[RECORD_HEADER_LEN + i];
+            }
+        }
+        m_writePos = committed;
+        return isErasedFrom(committed);
+    }
+
+    /**
+     * @brief Append a commit of the bytes of `config` which differ from `persisted`, the config as
+     * of the last commit, or the snapshot when the journal is empty
+     * @return false if there is no room, the caller must write `config` as the snapshot and Clear()
+     */
+    bool Append(const uint8_t *config, const uint8_t *persisted, uint16_t len)
+    {
+        // Sized first, so the commit is either written whole or not at all
+        uint32_t needed = m_writePos == m_start ? HEADER_LEN : 0;
+        uint16_t start, length;
+        bool any = false;
+        for (uint16_t from = 0; nextRun(config, persisted, len, from, &start, &length); from = start + length)
+        {
+            needed += recordSize(length);
+            any = true;
+        }
+        if (!any)
+        {
+            return true;
+        }
+        if (len > CONFIG_MAX_LEN || needed > m_end - m_writePos)
+        {
+            return false;
+        }
+
+        if (m_writePos == m_start)
+        {
+            const uint16_t crc = snapshotCrc(persisted, len);
+            const uint8_t header[HEADER_LEN] = {JOURNAL_MAGIC & 0xFF, JOURNAL_MAGIC >> 8, (uint8_t)crc, (uint8_t)(crc >> 8)};
+            m_flash.Write(m_writePos, header, HEADER_LEN);
+            m_writePos += HEADER_LEN;
+        }
+
+        uint8_t record[RECORD_HEADER_LEN + RECORD_MAX_DATA];
+        nextRun(config, persisted, len, 0, &start, &length);
+        bool more;
+        do
+        {
+            uint16_t nextStart = 0, nextLength = 0;
+            more = nextRun(config, persisted, len, start + length, &nextStart, &nextLength);
+
+            const uint16_t field = start | (length - 1) << 10 | (more ? 0 : 0x8000);
+            record[0] = field;
+            record[1] = field >> 8;
+            const uint8_t size = recordSize(length);
+            for (uint8_t i = 0; i < size - RECORD_HEADER_LEN; i++)
+            {
+                record[RECORD_HEADER_LEN + i] = i < length ? config[start + i] : 0xFF;
+            }
+            const uint16_t crc = recordCrc(record, length);
+            record[2] = crc;
+            record[3] = crc >> 8;
+            // The header goes last, so a record is not there until all of its data is
+            m_flash.Write(m_writePos + RECORD_HEADER_LEN, &record[RECORD_HEADER_LEN], size - RECORD_HEADER_LEN);
+            m_flash.Write(m_writePos, record, RECORD_HEADER_LEN);
+            m_writePos += size;
+
+            start = nextStart;
+            length = nextLength;
+        } while (more);
+        return true;
+    }
+
+    /**
+     * @brief Erase the journal, after the snapshot has been written with everything in it
+     */
+    void Clear()
+    {
+        m_flash.Erase();
+        m_writePos = m_start;
+    }
+
+    uint32_t BytesUsed() const { return m_writePos - m_start; }
+
+private:
+    static uint8_t recordSize(uint8_t length)
+    {
+        return RECORD_HEADER_LEN + ((length + 3) & ~3);
+    }
+
+    static bool isErased(const uint8_t *buf, uint8_t len)
+    {
+        for (uint8_t i = 0; i < len; i++)
+        {
+            if (buf[i] != 0xFF)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isErasedFrom(uint32_t pos)
+    {
+        uint8_t buf[32];
+        while (pos < m_end)
+        {
+            const uint8_t chunk = m_end - pos < sizeof(buf) ? m_end - pos : sizeof(buf);
+            m_flash.Read(pos, buf, chunk);
+            if (!isErased(buf, chunk))
+            {
+                return false;
+            }
+            pos += chunk;
+        }
+        return true;
+    }
+
+    uint16_t snapshotCrc(const uint8_t *config, uint16_t len)
+    {
+        uint16_t crc = 0;
+        for (uint16_t pos = 0; pos < len; pos += 128)
+        {
+            crc = m_crc.calc(const_cast<uint8_t *>(config + pos), len - pos < 128 ? len - pos : 128, crc);
+        }
+        return crc;
+    }
+
+    uint16_t recordCrc(uint8_t *record, uint8_t length)
+    {
+        return m_crc.calc(&record[RECORD_HEADER_LEN], length, m_crc.calc(record, 2, 0));
+    }
+
+    /**
+     * @brief Read and check the record at pos
+     * @return false if there is none, or it is not whole
+     */
+    bool readRecord(uint32_t pos, uint8_t *record, uint16_t len, uint16_t *offset, uint8_t *length, bool *last)
+    {
+        if (m_end - pos < RECORD_HEADER_LEN)
+        {
+            return false;
+        }
+        m_flash.Read(pos, record, RECORD_HEADER_LEN);
+        const uint16_t field = record[0] | record[1] << 8;
+        *offset = field & 0x3FF;
+        *length = ((field >> 10) & 0x1F) + 1;
+        *last = field & 0x8000;
+        // An erased record header also fails here, its offset and length run past any config
+        if (*offset + *length > len || m_end - pos < recordSize(*length))
+        {
+            return false;
+        }
+        m_flash.Read(pos + RECORD_HEADER_LEN, &record[RECORD_HEADER_LEN], *length);
+        return (record[2] | record[3] << 8) == recordCrc(record, *length);
+    }
+
+    /**
+     * @brief Find the next run of changed bytes at or after `from`, which fits in one record.
+     * Unchanged bytes between two changes are included if that is smaller than another record.
+     */
+    static bool nextRun(const uint8_t *config, const uint8_t *persisted, uint16_t len, uint16_t from,
+                        uint16_t *start, uint16_t *length)
+    {
+        while (from < len && config[from] == persisted[from])
+        {
+            from++;
+        }
+        if (from == len)
+        {
+            return false;
+        }
+        uint16_t end = from + 1;
+        for (uint16_t pos = end; pos < len && pos < end + RECORD_HEADER_LEN && pos < from + RECORD_MAX_DATA; pos++)
+        {
+            if (config[pos] != persisted[pos])
+            {
+                end = pos + 1;
+            }
+        }
+        *start = from;
+        *length = end - from;
+        return true;
+    }
+
+    Flash &m_flash;
+    const uint32_t m_start;
+    const uint32_t m_end;
+    uint32_t m_writePos;
+    Crc2Byte m_crc;
+};
@@ -6,6 +6,112 @@
 #include "helpers.h"
 #include "logging.h"
 
+#if defined(PLATFORM_ESP8266)
+#include "flash_hal.h"
+#include "ConfigJournal.h"
+
+#define EMPTY_SECTOR ((FS_start - 0x1000 - 0x40200000) / SPI_FLASH_SEC_SIZE) // empty sector before FS area start
+#define POWER_ON_COUNTER_LEN 64 // the RX power on counter is the first bytes of EMPTY_SECTOR
+#define POWER_ON_COUNTED 0x0F   // a counter byte for a power on which has not been reset
+#define POWER_ON_SPENT 0x00     // a counter byte which has been reset
+
+static int realPowerOnCounter = -1;
+
+/**
+ * The power on counter takes an erased counter byte per power on, programmed to POWER_ON_COUNTED,
+ * and is reset by programming those bytes to POWER_ON_SPENT, so neither erases the sector the
+ * journal is in. Only once every byte has been used does the sector need erasing.
+ * @return false if there are not enough unused bytes left for `count`
+ */
+static bool PowerOnCounterWrite(uint8_t count)
+{
+    uint8_t cells[POWER_ON_COUNTER_LEN];
+    ESP.flashRead(EMPTY_SECTOR * SPI_FLASH_SEC_SIZE, cells, sizeof(cells));
+    uint8_t counted = 0;
+    for (uint8_t i = 0; i < sizeof(cells); i++)
+    {
+        counted += cells[i] == POWER_ON_COUNTED;
+    }
+    if (count < counted)
+    {
+        for (uint8_t i = 0; i < sizeof(cells); i++)
+        {
+            if (cells[i] == POWER_ON_COUNTED)
+                cells[i] = POWER_ON_SPENT;
+        }
+        counted = 0;
+    }
+    for (uint8_t i = 0; i < sizeof(cells) && counted < count; i++)
+    {
+        if (cells[i] == 0xFF)
+        {
+            cells[i] = POWER_ON_COUNTED;
+            counted++;
+        }
+    }
+    if (counted < count)
+    {
+        return false;
+    }
+    // Bytes which are not changing are programmed with what they already hold, which leaves them as they are
+    ESP.flashWrite(EMPTY_SECTOR * SPI_FLASH_SEC_SIZE, cells, sizeof(cells));
+    return true;
+}
+
+/**
+ * EEPROM emulation erases and rewrites its whole sector on every commit, so config changes are
+ * journalled in the rest of EMPTY_SECTOR instead, and the EEPROM snapshot is only rewritten when
+ * that is full. The EEPROM's RAM copy is kept up to date without committing it, and is what the
+ * next commit is compared against.
+ */
+class EmptySectorFlash
+{
+public:
+    void Read(uint32_t addr, uint8_t *buf, uint32_t len) { ESP.flashRead(addr, buf, len); }
+    void Write(uint32_t addr, const uint8_t *buf, uint32_t len) { ESP.flashWrite(addr, buf, len); }
+    void Erase()
+    {
+        ESP.flashEraseSector(EMPTY_SECTOR);
+        // Put back the power on counter which shares the sector
+        if (realPowerOnCounter > 0)
+        {
+            PowerOnCounterWrite(realPowerOnCounter);
+        }
+    }
+};
+
+static EmptySectorFlash emptySectorFlash;
+static ConfigJournal<EmptySectorFlash> journal(emptySectorFlash,
+    EMPTY_SECTOR * SPI_FLASH_SEC_SIZE + POWER_ON_COUNTER_LEN, (EMPTY_SECTOR + 1) * SPI_FLASH_SEC_SIZE);
+
+template <typename T> static void JournalReplay(ELRS_EEPROM *eeprom, T &config)
+{
+    static_assert(sizeof(T) <= ConfigJournal<EmptySectorFlash>::CONFIG_MAX_LEN, "config too large to journal");
+    const bool replayed = journal.Replay((uint8_t *)&config, sizeof(T));
+    eeprom->Put(0, config);
+    if (!replayed)
+    {
+        // Stale or torn journal, start again from what could be used of it
+        eeprom->Commit();
+        journal.Clear();
+    }
+}
+
+template <typename T> static void JournalCommit(ELRS_EEPROM *eeprom, const T &config)
+{
+    T persisted;
+    eeprom->Get(0, persisted);
+    const bool appended = journal.Append((const uint8_t *)&config, (const uint8_t *)&persisted, sizeof(T));
+    eeprom->Put(0, config);
+    if (!appended)
+    {
+        // Journal full, fold it into a new snapshot
+        eeprom->Commit();
+        journal.Clear();
+    }
+}
+#endif
+
 #if defined(TARGET_TX)
 
 #define MODEL_CHANGED       bit(1)
@@ -215,6 +321,9 @@ void TxConfig::Load()
 {
     m_modified = 0;
     m_eeprom->Get(0, m_config);
+#if defined(PLATFORM_ESP8266)
+    JournalReplay(m_eeprom, m_config);
+#endif
 
     uint32_t version = 0;
     if ((m_config.version & CONFIG_MAGIC_MASK) == TX_CONFIG_MAGIC)
@@ -351,6 +460,8 @@ TxConfig::Commit()
     }
     nvs_set_u32(handle, "tx_version", m_config.version);
     nvs_commit(handle);
+#elif defined(PLATFORM_ESP8266)
+    JournalCommit(m_eeprom, m_config);
 #else
     // Write the struct to eeprom
     m_eeprom->Put(0, m_config);
@@ -705,10 +816,6 @@ TxConfig::SetModelId(uint8_t modelId)
 
 #if defined(TARGET_RX)
 
-#if defined(PLATFORM_ESP8266)
-#include "flash_hal.h"
-#endif
-
 RxConfig::RxConfig()
 {
 }
@@ -717,6 +824,11 @@ void RxConfig::Load()
 {
     m_modified = false;
     m_eeprom->Get(0, m_config);
+#if defined(PLATFORM_ESP8266)
+    // Count the power on before the journal, which shares its sector, could be erased
+    GetPowerOnCounter();
+    JournalReplay(m_eeprom, m_config);
+#endif
 
     uint32_t version = 0;
     if ((m_config.version & CONFIG_MAGIC_MASK) == RX_CONFIG_MAGIC)
@@ -950,20 +1062,18 @@ bool RxConfig::IsOnLoan() const
 }
 
 #if defined(PLATFORM_ESP8266)
-#define EMPTY_SECTOR ((FS_start - 0x1000 - 0x40200000) / SPI_FLASH_SEC_SIZE) // empty sector before FS area start
 static bool erase_power_on_count = false;
-static int realPowerOnCounter = -1;
+static bool reset_power_on_count = false;
 uint8_t
 RxConfig::GetPowerOnCounter() const
 {
     if (realPowerOnCounter == -1) {
-        byte zeros[16];
-        ESP.flashRead(EMPTY_SECTOR * SPI_FLASH_SEC_SIZE, zeros, sizeof(zeros));
-        realPowerOnCounter = sizeof(zeros);
-        for (int i=0 ; i<sizeof(zeros) ; i++) {
-            if (zeros[i] != 0) {
-                realPowerOnCounter = i;
-                break;
+        byte cells[POWER_ON_COUNTER_LEN];
+        ESP.flashRead(EMPTY_SECTOR * SPI_FLASH_SEC_SIZE, cells, sizeof(cells));
+        realPowerOnCounter = 0;
+        for (unsigned i=0 ; i<sizeof(cells) ; i++) {
+            if (cells[i] == POWER_ON_COUNTED) {
+                realPowerOnCounter++;
             }
         }
     }
@@ -977,8 +1087,16 @@ RxConfig::Commit()
 #if defined(PLATFORM_ESP8266)
     if (erase_power_on_count)
     {
-        ESP.flashEraseSector(EMPTY_SECTOR);
+        // Erasing the sector also erases the journal, so fold it into the snapshot first
+        m_eeprom->Commit();
+        journal.Clear();
         erase_power_on_count = false;
+        reset_power_on_count = false;
+    }
+    else if (reset_power_on_count)
+    {
+        PowerOnCounterWrite(0);
+        reset_power_on_count = false;
     }
 #endif
     if (!m_modified)
@@ -987,9 +1105,13 @@ RxConfig::Commit()
         return;
     }
 
+#if defined(PLATFORM_ESP8266)
+    JournalCommit(m_eeprom, m_config);
+#else
     // Write the struct to eeprom
     m_eeprom->Put(0, m_config);
     m_eeprom->Commit();
+#endif
 
     m_modified = false;
 }
@@ -1012,13 +1134,18 @@ RxConfig::SetPowerOnCounter(uint8_t powerOnCounter)
     realPowerOnCounter = powerOnCounter;
     if (powerOnCounter == 0)
     {
-        erase_power_on_count = true;
+        // Programmed on the next commit, which only writes the counter bytes
+        reset_power_on_count = true;
         m_modified = true;
     }
     else
     {
-        byte zeros[16] = {0};
-        ESP.flashWrite(EMPTY_SECTOR * SPI_FLASH_SEC_SIZE, zeros, std::min((size_t)powerOnCounter, sizeof(zeros)));
+        reset_power_on_count = false;
+        if (!PowerOnCounterWrite(powerOnCounter))
+        {
+            // Every counter byte has been used, erase the sector on the next commit
+            erase_power_on_count = true;
+        }
     }
 #else
     if (m_config.powerOnCounter != powerOnCounter)
@@ -1224,6 +1351,15 @@ void RxConfig::SetFailsafeMode(eFailsafeMode failsafeMode)
     }
 }
 
+void RxConfig::SetSbusRate(eSbusRate sbusRate)
+{
+    if (m_config.sbusRate != sbusRate)
+    {
+        m_config.sbusRate = sbusRate;
+        m_modified = true;
+    }
+}
+
 void RxConfig::SetBindStorage(rx_config_bindstorage_t value)
 {
     if (m_config.bindStorage != value)
@@ -1,30 +1,97 @@
 #include "crc.h"
 
-GENERIC_CRC8::GENERIC_CRC8(uint8_t poly)
+/***
+ * Compile-time table generation
+ *
+ * Slice k of a table is the CRC register after feeding byte i followed by k
+ * zero bytes, which lets CRC_SLICE_BY bytes be folded in with one lookup each.
+ * 16-bit tables hold the polynomial left-aligned so that CRC14 and CRC16 share
+ * the same calculation.
+ ***/
+template <unsigned... I> struct CrcIndices {};
+
+template <typename A, typename B> struct CrcConcat;
+template <unsigned... A, unsigned... B> struct CrcConcat<CrcIndices<A...>, CrcIndices<B...>>
 {
-    uint8_t crc;
+    typedef CrcIndices<A..., (sizeof...(A) + B)...> type;
+};
 
-    for (uint16_t i = 0; i < crclen; i++)
-    {
-        crc = i;
-        for (uint8_t j = 0; j < 8; j++)
-        {
-            crc = (crc << 1) ^ ((crc & 0x80) ? poly : 0);
-        }
-        crc8tab[i] = crc & 0xFF;
-    }
+template <unsigned N> struct CrcMakeIndices
+{
+    typedef typename CrcConcat<typename CrcMakeIndices<N / 2>::type, typename CrcMakeIndices<N - N / 2>::type>::type type;
+};
+template <> struct CrcMakeIndices<0> { typedef CrcIndices<> type; };
+template <> struct CrcMakeIndices<1> { typedef CrcIndices<0> type; };
+
+typedef CrcMakeIndices<CRC_SLICE_BY * crclen>::type CrcTableIndices;
+
+static constexpr uint8_t crc8Shift(uint8_t poly, uint8_t crc, unsigned bits)
+{
+    return bits == 0 ? crc : crc8Shift(poly, (uint8_t)((crc << 1) ^ ((crc & 0x80) ? poly : 0)), bits - 1);
+}
+
+static constexpr uint16_t crc16Shift(uint16_t poly, uint16_t crc, unsigned bits)
+{
+    return bits == 0 ? crc : crc16Shift(poly, (uint16_t)((crc << 1) ^ ((crc & 0x8000) ? poly : 0)), bits - 1);
+}
+
+struct Crc8Tables { uint8_t t[CRC_SLICE_BY][crclen]; };
+struct Crc16Tables { uint16_t t[CRC_SLICE_BY][crclen]; };
+
+template <unsigned... I>
+static constexpr Crc8Tables crc8Tables(uint8_t poly, CrcIndices<I...>)
+{
+    return Crc8Tables{{ crc8Shift(poly, I % crclen, 8 * (I / crclen + 1))... }};
+}
+
+template <unsigned... I>
+static constexpr Crc16Tables crc16Tables(uint16_t poly, CrcIndices<I...>)
+{
+    return Crc16Tables{{ crc16Shift(poly, (I % crclen) << 8, 8 * (I / crclen + 1))... }};
+}
+
+// Tables are read from ISRs so must stay out of flash
+static DRAM_ATTR const Crc8Tables crc8_D5 = crc8Tables(0xD5, CrcTableIndices()); // CRSF_CRC_POLY, SMARTAUDIO_CRC_POLY
+static DRAM_ATTR const Crc16Tables crc16_B95C = crc16Tables(0x2E57 << 2, CrcTableIndices()); // CRC14 ELRS_CRC14_POLY
+static DRAM_ATTR const Crc16Tables crc16_3D65 = crc16Tables(0x3D65, CrcTableIndices()); // CRC16 ELRS_CRC16_POLY
+#if defined(TARGET_RX) || defined(UNIT_TEST)
+static DRAM_ATTR const Crc16Tables crc16_1021 = crc16Tables(0x1021, CrcTableIndices()); // SUMD
+#endif
+
+GENERIC_CRC8::GENERIC_CRC8(uint8_t poly)
+{
+    crcpoly = poly;
+    crc8tab = (poly == 0xD5) ? crc8_D5.t : nullptr;
 }
 
 uint8_t ICACHE_RAM_ATTR GENERIC_CRC8::calc(const uint8_t data)
 {
-    return crc8tab[data];
+    if (!crc8tab)
+        return crc8Shift(crcpoly, data, 8);
+    return crc8tab[0][data];
 }
 
 uint8_t ICACHE_RAM_ATTR GENERIC_CRC8::calc(const uint8_t *data, uint16_t len, uint8_t crc)
 {
+    if (!crc8tab)
+    {
+        while (len--)
+            crc = crc8Shift(crcpoly, crc ^ *data++, 8);
+        return crc;
+    }
+
+    while (len >= CRC_SLICE_BY)
+    {
+        uint8_t c = crc8tab[CRC_SLICE_BY - 1][crc ^ data[0]];
+        for (unsigned k = 1; k < CRC_SLICE_BY; k++)
+            c ^= crc8tab[CRC_SLICE_BY - 1 - k][data[k]];
+        crc = c;
+        data += CRC_SLICE_BY;
+        len -= CRC_SLICE_BY;
+    }
     while (len--)
     {
-        crc = crc8tab[crc ^ *data++];
+        crc = crc8tab[0][crc ^ *data++];
     }
     return crc;
 }
@@ -36,24 +103,56 @@ void Crc2Byte::init(uint8_t bits, uint16_t poly)
     _poly = poly;
     _bits = bits;
     _bitmask = (1 << _bits) - 1;
-    uint16_t highbit = 1 << (_bits - 1);
-    uint16_t crc;
-    for (uint16_t i = 0; i < crclen; i++)
+
+    uint16_t const alignedPoly = poly << (16 - bits);
+    switch (alignedPoly)
     {
-        crc = i << (bits - 8);
-        for (uint8_t j = 0; j < 8; j++)
-        {
-            crc = (crc << 1) ^ ((crc & highbit) ? poly : 0);
-        }
-        _crctab[i] = crc;
+    case 0x2E57 << 2:
+        _crctab = crc16_B95C.t;
+        break;
+    case 0x3D65:
+        _crctab = crc16_3D65.t;
+        break;
+#if defined(TARGET_RX) || defined(UNIT_TEST)
+    case 0x1021:
+        _crctab = crc16_1021.t;
+        break;
+#endif
+    default:
+        _crctab = nullptr;
+        break;
     }
 }
 
 uint16_t ICACHE_RAM_ATTR Crc2Byte::calc(uint8_t *data, uint8_t len, uint16_t crc)
 {
+    // Work with the CRC left-aligned in 16 bits, bits above _bits in the initial value are ignored
+    uint8_t const shift = 16 - _bits;
+    uint16_t c = (crc & _bitmask) << shift;
+
+    if (!_crctab)
+    {
+        uint16_t const alignedPoly = _poly << shift;
+        while (len--)
+            c = crc16Shift(alignedPoly, c ^ ((uint16_t)*data++ << 8), 8);
+        return c >> shift;
+    }
+
+#if CRC_SLICE_BY > 1
+    // Each round shifts the register by at least 16 bits, so only the table terms remain
+    while (len >= CRC_SLICE_BY)
+    {
+        uint16_t n = _crctab[CRC_SLICE_BY - 1][(c >> 8) ^ data[0]] ^ _crctab[CRC_SLICE_BY - 2][(c & 0xFF) ^ data[1]];
+        for (unsigned k = 2; k < CRC_SLICE_BY; k++)
+            n ^= _crctab[CRC_SLICE_BY - 1 - k][data[k]];
+        c = n;
+        data += CRC_SLICE_BY;
+        len -= CRC_SLICE_BY;
+    }
+#endif
     while (len--)
     {
-        crc = (crc << 8) ^ _crctab[((crc >> (_bits - 8)) ^ (uint16_t) *data++) & 0x00FF];
+        c = (c << 8) ^ _crctab[0][(c >> 8) ^ *data++];
     }
-    return crc & _bitmask;
+    return c >> shift;
 }
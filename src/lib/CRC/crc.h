@@ -4,10 +4,30 @@
 
 #define crclen 256
 
+// Number of bytes processed per table lookup round (slicing-by-N), 1, 2, 4 or 8
+// Each extra slice costs another 256 entries per polynomial in DRAM, 1.25KB on a TX and
+// 1.75KB on an RX, so the ESP8285 stops at 2 (2.5KB TX, 3.5KB RX)
+#ifndef CRC_SLICE_BY
+#if defined(PLATFORM_ESP8266)
+#define CRC_SLICE_BY 2
+#else
+#define CRC_SLICE_BY 4
+#endif
+#endif
+
+#if CRC_SLICE_BY != 1 && CRC_SLICE_BY != 2 && CRC_SLICE_BY != 4 && CRC_SLICE_BY != 8
+#error "CRC_SLICE_BY must be 1, 2, 4 or 8"
+#endif
+
+/**
+ * CRC lookup tables are generated at compile time for the polynomials used by
+ * the project (see crc.cpp), so constructing/init() only selects a table.
+ * Any other polynomial falls back to a bitwise calculation.
+ */
 class GENERIC_CRC8
 {
 private:
-    uint8_t crc8tab[crclen];
+    const uint8_t (*crc8tab)[crclen];
     uint8_t crcpoly;
 
 public:
@@ -19,7 +39,7 @@ public:
 class Crc2Byte
 {
 private:
-    uint16_t _crctab[crclen];
+    const uint16_t (*_crctab)[crclen]; // tables for the polynomial left-aligned to 16 bits
     uint8_t  _bits;
     uint16_t _bitmask;
     uint16_t _poly;
@@ -391,10 +391,35 @@ static uint16_t ICACHE_RAM_ATTR fmap(uint16_t x, uint16_t in_min, uint16_t in_ma
     return ((x - in_min) * (out_max - out_min) * 2 / (in_max - in_min) + out_min * 2 + 1) / 2;
 }
 
+/***
+ * @brief: fmap() from the CRSF channel range as a multiply and shift, without the division
+ * @desc: out = (val * mul + add) >> 16, with separate constants below CRSF_CHANNEL_VALUE_MIN
+ *        where fmap()'s division truncates toward zero. The constants were searched for so the
+ *        result is the same as fmap() for every 11-bit val, which test_fmap checks
+ ***/
+typedef struct crsfChannelMap_s
+{
+    uint32_t mulLow;
+    uint32_t addLow;
+    uint32_t mul;
+    uint32_t add;
+} crsfChannelMap_t;
+
+static constexpr crsfChannelMap_t CRSF_MAP_US = {40908, 57778525, 40945, 57739800};         // 988-2012
+static constexpr crsfChannelMap_t CRSF_MAP_DJI_RS_PRO = {53728, 13891247, 53740, 13858683}; // 352-1696
+static constexpr crsfChannelMap_t CRSF_MAP_DJI_RS_PRO_HALF = {26860, 6978945, 26870, 6945725}; // 176-848
+
+static inline uint16_t ICACHE_RAM_ATTR CRSF_map(uint16_t val, const crsfChannelMap_t &map)
+{
+    if (val < CRSF_CHANNEL_VALUE_MIN)
+        return (val * map.mulLow + map.addLow) >> 16;
+    return (val * map.mul + map.add) >> 16;
+}
+
 // Scale a -100& to +100% crossfire value to 988-2012 (Taranis channel uS)
 static inline uint16_t ICACHE_RAM_ATTR CRSF_to_US(uint16_t val)
 {
-    return fmap(val, CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 988, 2012);
+    return CRSF_map(val, CRSF_MAP_US);
 }
 
 // Scale down a 10-bit value to a -100& to +100% crossfire value
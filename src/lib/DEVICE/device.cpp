@@ -4,6 +4,8 @@
 #include "helpers.h"
 #include "device.h"
 
+#include <atomic>
+
 ///////////////////////////////////////
 // Even though we aren't using anything this keeps the PIO dependency analyzer happy!
 
@@ -26,14 +28,27 @@
 
 extern bool connectionHasModelMatch;
 
+static constexpr uint8_t MAX_DEVICES = 16;
+static constexpr uint8_t NOT_SCHEDULED = 0xFF;
+
 static device_affinity_t *uiDevices;
 static uint8_t deviceCount;
 
-static bool eventFired[2] = {false, false};
+// Fired from other tasks and the other core (e.g. the ESP32 UART event task), so they are
+// only ever set and taken atomically, an event fired between a read and a clear is not lost
+static std::atomic<uint32_t> eventsFired[2] = {{0}, {0}};
 static connectionState_e lastConnectionState[2] = {disconnected, disconnected};
 static bool lastModelMatch[2] = {false, false};
 
-static unsigned long deviceTimeout[16] = {0};
+/**
+ * The devices with a pending timeout() on each core are kept in a binary min-heap ordered by
+ * their deadline, so finding the expired ones does not mean looking at every device.
+ * deviceHeapPos is the index of each device in its core's heap, or NOT_SCHEDULED.
+ */
+static unsigned long deviceTimeout[MAX_DEVICES] = {0};
+static uint8_t deviceHeapPos[MAX_DEVICES];
+static uint8_t deviceHeap[2][MAX_DEVICES];
+static uint8_t deviceHeapSize[2] = {0, 0};
 
 #if MULTICORE
 static TaskHandle_t xDeviceTask = NULL;
@@ -45,10 +60,105 @@ static void deviceTask(void *pvArgs);
 #define CURRENT_CORE -1
 #endif
 
+// Earlier deadline first, then the order the devices were registered in
+static bool heapBefore(uint8_t a, uint8_t b)
+{
+    const int32_t diff = (int32_t)(deviceTimeout[a] - deviceTimeout[b]);
+    return diff < 0 || (diff == 0 && a < b);
+}
+
+static void heapSet(uint8_t *heap, uint8_t pos, uint8_t device)
+{
+    heap[pos] = device;
+    deviceHeapPos[device] = pos;
+}
+
+static void heapSiftUp(uint8_t *heap, uint8_t pos)
+{
+    const uint8_t device = heap[pos];
+    while (pos > 0)
+    {
+        const uint8_t parent = (pos - 1) / 2;
+        if (!heapBefore(device, heap[parent]))
+        {
+            break;
+        }
+        heapSet(heap, pos, heap[parent]);
+        pos = parent;
+    }
+    heapSet(heap, pos, device);
+}
+
+static void heapSiftDown(uint8_t *heap, uint8_t size, uint8_t pos)
+{
+    const uint8_t device = heap[pos];
+    for (;;)
+    {
+        uint8_t child = 2 * pos + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && heapBefore(heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if (!heapBefore(heap[child], device))
+        {
+            break;
+        }
+        heapSet(heap, pos, heap[child]);
+        pos = child;
+    }
+    heapSet(heap, pos, device);
+}
+
+static void unscheduleTimeout(int32_t coreMulti, uint8_t device)
+{
+    const uint8_t pos = deviceHeapPos[device];
+    if (pos == NOT_SCHEDULED)
+    {
+        return;
+    }
+    uint8_t *heap = deviceHeap[coreMulti];
+    const uint8_t last = --deviceHeapSize[coreMulti];
+    deviceHeapPos[device] = NOT_SCHEDULED;
+    if (pos != last)
+    {
+        heapSet(heap, pos, heap[last]);
+        heapSiftDown(heap, last, pos);
+        heapSiftUp(heap, pos);
+    }
+}
+
+/**
+ * Set the timeout of the device to `delay` ms from now, DURATION_NEVER removes it from the heap
+ */
+static void scheduleTimeout(int32_t coreMulti, uint8_t device, unsigned long now, int delay)
+{
+    unscheduleTimeout(coreMulti, device);
+    if (delay == DURATION_NEVER || !uiDevices[device].device->timeout)
+    {
+        return;
+    }
+    deviceTimeout[device] = now + delay;
+    uint8_t *heap = deviceHeap[coreMulti];
+    const uint8_t pos = deviceHeapSize[coreMulti]++;
+    heapSet(heap, pos, device);
+    heapSiftUp(heap, pos);
+}
+
 void devicesRegister(device_affinity_t *devices, uint8_t count)
 {
+    if (count > MAX_DEVICES)
+    {
+        ERRLN("Too many devices %u", count);
+        count = MAX_DEVICES;
+    }
     uiDevices = devices;
     deviceCount = count;
+    memset(deviceHeapPos, NOT_SCHEDULED, sizeof(deviceHeapPos));
+    deviceHeapSize[0] = deviceHeapSize[1] = 0;
 
     #if MULTICORE
         taskSemaphore = xSemaphoreCreateBinary();
@@ -81,17 +191,18 @@ void devicesInit()
 void devicesStart()
 {
     int32_t core = CURRENT_CORE;
+    const int32_t coreMulti = (core == -1) ? 0 : core;
     unsigned long now = millis();
 
     for(size_t i=0 ; i<deviceCount ; i++)
     {
         if (uiDevices[i].core == core || core == -1) {
-            deviceTimeout[i] = 0xFFFFFFFF;
+            int delay = DURATION_NEVER;
             if (uiDevices[i].device->start)
             {
-                int delay = (uiDevices[i].device->start)();
-                deviceTimeout[i] = delay == DURATION_NEVER ? 0xFFFFFFFF : now + delay;
+                delay = (uiDevices[i].device->start)();
             }
+            scheduleTimeout(coreMulti, i, now, delay);
         }
     }
     #if MULTICORE
@@ -110,10 +221,10 @@ void devicesStop()
     #endif
 }
 
-void devicesTriggerEvent()
+void devicesTriggerEvent(uint32_t events)
 {
-    eventFired[0] = true;
-    eventFired[1] = true;
+    eventsFired[0].fetch_or(events);
+    eventsFired[1].fetch_or(events);
     #if MULTICORE
     // Release teh semaphore so the tasks on core 0 run now
     xSemaphoreGive(taskSemaphore);
@@ -126,48 +237,57 @@ static int _devicesUpdate(unsigned long now)
     const int32_t coreMulti = (core == -1) ? 0 : core;
 
     bool newModelMatch = connectionHasModelMatch && teamraceHasModelMatch;
-    bool handleEvents = eventFired[coreMulti] || lastConnectionState[coreMulti] != connectionState || lastModelMatch[coreMulti] != newModelMatch;
-    eventFired[coreMulti] = false;
+    uint32_t events = eventsFired[coreMulti].exchange(0);
+    if (lastConnectionState[coreMulti] != connectionState || lastModelMatch[coreMulti] != newModelMatch)
+    {
+        events |= EVENT_CONNECTION_CHANGED;
+    }
     lastConnectionState[coreMulti] = connectionState;
     lastModelMatch[coreMulti] = newModelMatch;
 
-    for(size_t i=0 ; i<deviceCount ; i++)
+    if (events)
     {
-        if (uiDevices[i].core == core || core == -1) {
-            if (handleEvents && uiDevices[i].device->event)
+        for(size_t i=0 ; i<deviceCount ; i++)
+        {
+            const device_t *device = uiDevices[i].device;
+            if ((uiDevices[i].core == core || core == -1) && device->event && (device->events == 0 || (device->events & events)))
             {
-                int delay = (uiDevices[i].device->event)();
+                int delay = (device->event)();
                 if (delay != DURATION_IGNORE)
                 {
-                    deviceTimeout[i] = delay == DURATION_NEVER ? 0xFFFFFFFF : now + delay;
+                    scheduleTimeout(coreMulti, i, now, delay);
                 }
             }
         }
     }
 
-    int smallest_delay = DURATION_NEVER;
-    for(size_t i=0 ; i<deviceCount ; i++)
+    // Take all the expired devices off the heap first, so a timeout() which returns
+    // DURATION_IMMEDIATELY is called again on the next update and not in this one
+    uint8_t *heap = deviceHeap[coreMulti];
+    uint8_t expired[MAX_DEVICES];
+    uint8_t expiredCount = 0;
+    while (deviceHeapSize[coreMulti] > 0 && (int32_t)(now - deviceTimeout[heap[0]]) >= 0)
     {
-        if ((uiDevices[i].core == core || core == -1) && uiDevices[i].device->timeout)
-        {
-            int delay = deviceTimeout[i] == 0xFFFFFFFF ? DURATION_NEVER : (int)(deviceTimeout[i]-now);
-            if (now >= deviceTimeout[i])
-            {
-                delay = (uiDevices[i].device->timeout)();
-                deviceTimeout[i] = delay == DURATION_NEVER ? 0xFFFFFFFF : now + delay;
-            }
-            if (delay != DURATION_NEVER)
-            {
-                smallest_delay = (smallest_delay == DURATION_NEVER) ? delay : std::min(smallest_delay, delay);
-            }
-        }
+        expired[expiredCount++] = heap[0];
+        unscheduleTimeout(coreMulti, heap[0]);
+    }
+    for (uint8_t i = 0 ; i < expiredCount ; i++)
+    {
+        int delay = (uiDevices[expired[i]].device->timeout)();
+        scheduleTimeout(coreMulti, expired[i], now, delay);
+    }
+
+    if (deviceHeapSize[coreMulti] == 0)
+    {
+        return DURATION_NEVER;
     }
-    return smallest_delay;
+    const int32_t delay = (int32_t)(deviceTimeout[heap[0]] - now);
+    return delay < 0 ? DURATION_IMMEDIATELY : delay;
 }
 
-void devicesUpdate(unsigned long now)
+int devicesUpdate(unsigned long now)
 {
-    _devicesUpdate(now);
+    return _devicesUpdate(now);
 }
 
 #if MULTICORE
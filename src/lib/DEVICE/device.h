@@ -7,6 +7,15 @@
 #define DURATION_NEVER -1       // timeout() will not be called, only event()
 #define DURATION_IMMEDIATELY 0  // timeout() will be called each loop
 
+// event bits which can be passed to devicesTriggerEvent() and subscribed to in device_t.events
+#define EVENT_CONNECTION_CHANGED (1 << 0) // connectionState or the model match changed, fired by devicesUpdate()
+#define EVENT_CONFIG_CHANGED     (1 << 1) // the configuration was changed or committed
+#define EVENT_POWER_CHANGED      (1 << 2) // the RF output power changed
+#define EVENT_ARM_CHANGED        (1 << 3) // the arming state from the handset changed
+#define EVENT_BINDING_CHANGED    (1 << 4) // binding mode was entered or exited
+#define EVENT_VTX_CHANGED        (1 << 5) // the VTX settings changed
+#define EVENT_ALL                0xFFFFFFFF
+
 typedef struct {
     /**
      * @brief Called at the beginning of setup() so the device can configure IO pins etc.
@@ -32,6 +41,12 @@ typedef struct {
      * a new duration, this function should not return DURATION_IGNORE.
      */
     int (*timeout)();
+
+    /**
+     * @brief The EVENT_* bits which cause event() to be called.
+     * If not set (0) then event() is called for all events.
+     */
+    uint32_t events;
 } device_t;
 
 typedef struct {
@@ -69,14 +84,18 @@ void devicesStart();
  * are processing in a seperate FreeRTOS task running on the alternate core(s).
  *
  * @param now current time in millisecods
+ * @return the number of milliseconds until the next timeout() is due, or DURATION_NEVER
+ * if there is none, so the caller can sleep until then if there is nothing else to do
  */
-void devicesUpdate(unsigned long now);
+int devicesUpdate(unsigned long now);
 
 /**
  * @brief Notify the device framework that an event has occurred and on the next call to
- * deviceUpdate() the event() function of the devices should be called.
+ * deviceUpdate() the event() function of the devices subscribed to it should be called.
+ *
+ * @param events the EVENT_* bits for the event(s) that occurred
  */
-void devicesTriggerEvent();
+void devicesTriggerEvent(uint32_t events = EVENT_ALL);
 
 /**
  * @brief Stop all the devices.
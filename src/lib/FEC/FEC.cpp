@@ -1,43 +1,106 @@
+#include "targets.h"
 #include "FEC.h"
+#include "FecIndices.h"
 
-void FECEncode(uint8_t *incomingData, uint8_t *FECBuffer)
+/***
+ * Compile-time table generation
+ *
+ * The byte encode table holds the Hamming(7,4) codes of both nibbles of a byte,
+ * the LSB nibble's code in the low byte. The decode table maps every 7 bit word
+ * to the nibble whose code is nearest, which for a perfect code like Hamming(7,4)
+ * is the one at most a single bit away.
+ ***/
+
+// Same codes as hammingCodes[] in hamming.cpp
+static constexpr uint8_t nibbleCodes[DATA_VALUES] = {
+    0x00, 0x71, 0x62, 0x13, 0x54, 0x25, 0x36, 0x47, 0x38, 0x49, 0x5A, 0x2B, 0x6C, 0x1D, 0x0E, 0x7F
+};
+
+static constexpr unsigned bitCount(unsigned x)
+{
+    return x == 0 ? 0 : (x & 1) + bitCount(x >> 1);
+}
+
+static constexpr uint8_t nearestNibble(uint8_t code, uint8_t nibble = 0)
+{
+    return nibble == DATA_VALUES - 1 || bitCount(code ^ nibbleCodes[nibble]) <= 1 ? nibble : nearestNibble(code, nibble + 1);
+}
+
+struct FecEncodeTable { uint16_t t[256]; };
+struct FecDecodeTable { uint8_t t[CODE_VALUES]; };
+
+template <unsigned... I>
+static constexpr FecEncodeTable fecEncodeTable(FecIndices<I...>)
+{
+    return FecEncodeTable{{ (uint16_t)(nibbleCodes[I & 0x0F] | (nibbleCodes[I >> 4] << 8))... }};
+}
+
+template <unsigned... I>
+static constexpr FecDecodeTable fecDecodeTable(FecIndices<I...>)
+{
+    return FecDecodeTable{{ nearestNibble(I)... }};
+}
+
+// Tables are read from ISRs so must stay out of flash
+static DRAM_ATTR const FecEncodeTable fecEncode = fecEncodeTable(FecMakeIndices<256>::type());
+static DRAM_ATTR const FecDecodeTable fecDecode = fecDecodeTable(FecMakeIndices<CODE_VALUES>::type());
+
+/**
+ * @brief Transpose an 8x8 bit matrix, bit c of byte r becomes bit r of byte c
+ */
+static inline uint64_t transpose8x8(uint64_t x)
 {
-    // Encode Hamming(7,4) 
-    uint8_t encodedBuffer[8 * 2] = {0};
-    for (uint8_t i = 0; i < 8; i++)
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+void ICACHE_RAM_ATTR FECEncode(uint8_t *incomingData, uint8_t *FECBuffer)
+{
+    // Encode Hamming(7,4), each byte is two 7 bit codewords, LSB nibble first.
+    // Bytes 0-3 give the 8 codewords interleaved into the even bytes, 4-7 the odd bytes
+    uint64_t codes[2];
+    for (uint8_t half = 0; half < 2; half++)
     {
-        encodedBuffer[i * 2 + 0] = HammingTableEncode(incomingData[i] & 0x0F);  // LSB nibble
-        encodedBuffer[i * 2 + 1] = HammingTableEncode(incomingData[i] >> 4);    // MSB nibble
+        const uint8_t *data = &incomingData[half * 4];
+        codes[half] = transpose8x8((uint64_t)fecEncode.t[data[0]]
+            | ((uint64_t)fecEncode.t[data[1]] << 16)
+            | ((uint64_t)fecEncode.t[data[2]] << 32)
+            | ((uint64_t)fecEncode.t[data[3]] << 48));
     }
 
-    // Interleaving
+    // Interleaving, bit j of FEC byte i*2 is bit i of codeword j
     for (uint8_t i = 0; i < (14 / 2); i++)
     {
-        for (uint8_t j = 0; j < 8; j++)
-        {
-            FECBuffer[i * 2 + 0] |= ((encodedBuffer[j + 0] >> i) & 0x01) << j; 
-            FECBuffer[i * 2 + 1] |= ((encodedBuffer[j + 8] >> i) & 0x01) << j; 
-        }
+        FECBuffer[i * 2 + 0] = codes[0] >> (i * 8);
+        FECBuffer[i * 2 + 1] = codes[1] >> (i * 8);
     }
 }
 
-void FECDecode(uint8_t *incomingFECBuffer, uint8_t *outgoingData)
+void ICACHE_RAM_ATTR FECDecode(uint8_t *incomingFECBuffer, uint8_t *outgoingData)
 {
     // Interleaving
-    uint8_t encodedBuffer[16] = {0};
-    for (uint8_t i = 0; i < 8; i++)
+    uint64_t rows[2] = {0, 0};
+    for (uint8_t j = 0; j < 7; j++)
     {
-        for (uint8_t j = 0; j < 7; j++)
-        {
-            encodedBuffer[i + 0] |= ((incomingFECBuffer[j * 2 + 0] >> i) & 0x01) << j; 
-            encodedBuffer[i + 8] |= ((incomingFECBuffer[j * 2 + 1] >> i) & 0x01) << j; 
-        }
+        rows[0] |= (uint64_t)incomingFECBuffer[j * 2 + 0] << (j * 8);
+        rows[1] |= (uint64_t)incomingFECBuffer[j * 2 + 1] << (j * 8);
     }
 
-    // Decode Hamming(7,4) 
-    for (uint8_t i = 0; i < 8; i++)
+    // Decode Hamming(7,4)
+    for (uint8_t half = 0; half < 2; half++)
     {
-        outgoingData[i] =  HammingTableDecode(encodedBuffer[i * 2 + 0]);         // LSB nibble
-        outgoingData[i] |= HammingTableDecode(encodedBuffer[i * 2 + 1]) << 4;    // MSB nibble
+        const uint64_t codes = transpose8x8(rows[half]);
+        uint8_t *data = &outgoingData[half * 4];
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            data[i] = fecDecode.t[(codes >> (i * 16)) & 0x7F]              // LSB nibble
+                    | (fecDecode.t[(codes >> (i * 16 + 8)) & 0x7F] << 4);  // MSB nibble
+        }
     }
 }
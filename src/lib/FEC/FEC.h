@@ -16,6 +16,10 @@
  * A single bit is placed in every second byte of the payload.  This 
  * should provide the best defence against burst interference, and single 
  * bit errors in each codeword can be repaired.
+ *
+ * Both use lookup tables for the Hamming code and an 8x8 bit matrix
+ * transpose for the interleaving. FECEncode writes all 14 bytes of the
+ * FECBuffer.
  */
 
 void FECEncode(uint8_t *incomingData, uint8_t *FECBuffer);
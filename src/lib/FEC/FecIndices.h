@@ -0,0 +1,22 @@
+#pragma once
+
+/***
+ * Compile-time index lists for generating the FEC lookup tables, the C++11
+ * equivalent of std::make_integer_sequence. FecMakeIndices<N>::type is
+ * FecIndices<0, 1, ..., N - 1>, which a constexpr function can expand
+ * into the initializer of an N entry table.
+ ***/
+template <unsigned... I> struct FecIndices {};
+
+template <typename A, typename B> struct FecConcat;
+template <unsigned... A, unsigned... B> struct FecConcat<FecIndices<A...>, FecIndices<B...>>
+{
+    typedef FecIndices<A..., (sizeof...(A) + B)...> type;
+};
+
+template <unsigned N> struct FecMakeIndices
+{
+    typedef typename FecConcat<typename FecMakeIndices<N / 2>::type, typename FecMakeIndices<N - N / 2>::type>::type type;
+};
+template <> struct FecMakeIndices<0> { typedef FecIndices<> type; };
+template <> struct FecMakeIndices<1> { typedef FecIndices<0> type; };
@@ -0,0 +1,242 @@
+#include "targets.h"
+#include "ReedSolomon.h"
+#include "FecIndices.h"
+
+#if defined(USE_OTA8_RS)
+
+/***
+ * Compile-time table generation
+ *
+ * gfExp[i] is a^i, doubled in length so the sum of two logs can index it
+ * without a modulo. gfLog[x] is the inverse, with gfLog[0] unused.
+ * rsGenerator is the generator polynomial, lowest degree first without the
+ * leading x^RS_PARITY_LEN term.
+ ***/
+
+#define GF_POLY 0x1D // x^8 + x^4 + x^3 + x^2 + 1, the x^8 is implicit
+
+static constexpr uint8_t gfDouble(uint8_t x)
+{
+    return (uint8_t)(x << 1) ^ ((x & 0x80) ? GF_POLY : 0);
+}
+
+static constexpr uint8_t gfPow(unsigned i)
+{
+    return i == 0 ? 1 : gfDouble(gfPow(i - 1));
+}
+
+static constexpr uint8_t gfLogSearch(uint8_t x, unsigned i = 0, uint8_t power = 1)
+{
+    return power == x || i == 254 ? i : gfLogSearch(x, i + 1, gfDouble(power));
+}
+
+static constexpr uint8_t gfMulBitwise(uint8_t a, uint8_t b)
+{
+    return b == 0 ? 0 : ((b & 1) ? a : 0) ^ gfMulBitwise(gfDouble(a), b >> 1);
+}
+
+// Coefficient of x^j in (x + a^0)(x + a^1)...(x + a^(k-1))
+static constexpr uint8_t rsGeneratorCoef(unsigned k, unsigned j)
+{
+    return k == 0 ? (j == 0 ? 1 : 0)
+        : (j > 0 ? rsGeneratorCoef(k - 1, j - 1) : 0) ^ gfMulBitwise(rsGeneratorCoef(k - 1, j), gfPow(k - 1));
+}
+
+struct GfExpTable { uint8_t t[512]; };
+struct GfLogTable { uint8_t t[256]; };
+struct RsGenerator { uint8_t t[RS_PARITY_LEN]; };
+
+template <unsigned... I>
+static constexpr GfExpTable gfExpTable(FecIndices<I...>)
+{
+    return GfExpTable{{ gfPow(I % 255)... }};
+}
+
+template <unsigned... I>
+static constexpr GfLogTable gfLogTable(FecIndices<I...>)
+{
+    return GfLogTable{{ (uint8_t)(I == 0 ? 0 : gfLogSearch(I))... }};
+}
+
+template <unsigned... I>
+static constexpr RsGenerator rsGenerator(FecIndices<I...>)
+{
+    return RsGenerator{{ rsGeneratorCoef(RS_PARITY_LEN, I)... }};
+}
+
+// Tables are read from ISRs so must stay out of flash
+static DRAM_ATTR const GfExpTable gfExp = gfExpTable(FecMakeIndices<512>::type());
+static DRAM_ATTR const GfLogTable gfLog = gfLogTable(FecMakeIndices<256>::type());
+static DRAM_ATTR const RsGenerator rsGen = rsGenerator(FecMakeIndices<RS_PARITY_LEN>::type());
+
+static inline uint8_t ICACHE_RAM_ATTR gfMul(uint8_t a, uint8_t b)
+{
+    return (a == 0 || b == 0) ? 0 : gfExp.t[gfLog.t[a] + gfLog.t[b]];
+}
+
+static inline uint8_t ICACHE_RAM_ATTR gfDiv(uint8_t a, uint8_t b)
+{
+    return a == 0 ? 0 : gfExp.t[gfLog.t[a] + 255 - gfLog.t[b]];
+}
+
+// Evaluate a polynomial, lowest degree first
+static uint8_t ICACHE_RAM_ATTR gfPolyEval(const uint8_t *poly, uint8_t len, uint8_t x)
+{
+    uint8_t y = 0;
+    for (int8_t i = len - 1; i >= 0; i--)
+    {
+        y = gfMul(y, x) ^ poly[i];
+    }
+    return y;
+}
+
+void ICACHE_RAM_ATTR RSEncode(uint8_t *buf, uint8_t dataLen)
+{
+    // The parity is the remainder of data * x^RS_PARITY_LEN divided by the generator,
+    // buf[0] is the highest degree
+    uint8_t * const parity = &buf[dataLen];
+    for (uint8_t j = 0; j < RS_PARITY_LEN; j++)
+    {
+        parity[j] = 0;
+    }
+    for (uint8_t i = 0; i < dataLen; i++)
+    {
+        const uint8_t feedback = buf[i] ^ parity[0];
+        for (uint8_t j = 0; j < RS_PARITY_LEN - 1; j++)
+        {
+            parity[j] = parity[j + 1] ^ gfMul(feedback, rsGen.t[RS_PARITY_LEN - 1 - j]);
+        }
+        parity[RS_PARITY_LEN - 1] = gfMul(feedback, rsGen.t[0]);
+    }
+}
+
+int8_t ICACHE_RAM_ATTR RSDecode(uint8_t *buf, uint8_t dataLen)
+{
+    const uint8_t len = dataLen + RS_PARITY_LEN;
+
+    // Syndromes, the received polynomial evaluated at each root of the generator
+    uint8_t syndromes[RS_PARITY_LEN];
+    uint8_t anyError = 0;
+    for (uint8_t j = 0; j < RS_PARITY_LEN; j++)
+    {
+        uint8_t s = 0;
+        for (uint8_t i = 0; i < len; i++)
+        {
+            s = gfMul(s, gfExp.t[j]) ^ buf[i];
+        }
+        syndromes[j] = s;
+        anyError |= s;
+    }
+    if (anyError == 0)
+    {
+        return 0;
+    }
+
+    // Berlekamp-Massey, find the error locator polynomial (lowest degree first)
+    uint8_t locator[RS_PARITY_LEN + 1] = {1};
+    uint8_t prev[RS_PARITY_LEN + 1] = {1};
+    uint8_t errors = 0;
+    uint8_t shift = 1;
+    uint8_t prevDiscrepancy = 1;
+    for (uint8_t r = 0; r < RS_PARITY_LEN; r++)
+    {
+        uint8_t discrepancy = syndromes[r];
+        for (uint8_t i = 1; i <= errors; i++)
+        {
+            discrepancy ^= gfMul(locator[i], syndromes[r - i]);
+        }
+        if (discrepancy == 0)
+        {
+            shift++;
+            continue;
+        }
+
+        uint8_t last[RS_PARITY_LEN + 1];
+        for (uint8_t i = 0; i <= RS_PARITY_LEN; i++)
+        {
+            last[i] = locator[i];
+        }
+        const uint8_t scale = gfDiv(discrepancy, prevDiscrepancy);
+        for (uint8_t i = shift; i <= RS_PARITY_LEN; i++)
+        {
+            locator[i] ^= gfMul(scale, prev[i - shift]);
+        }
+        if (2 * errors <= r)
+        {
+            errors = r + 1 - errors;
+            for (uint8_t i = 0; i <= RS_PARITY_LEN; i++)
+            {
+                prev[i] = last[i];
+            }
+            prevDiscrepancy = discrepancy;
+            shift = 1;
+        }
+        else
+        {
+            shift++;
+        }
+    }
+    if (errors > RS_PARITY_LEN / 2)
+    {
+        return -1;
+    }
+
+    // Chien search, an error in buf[i] is a root of the locator at a^-(len - 1 - i)
+    uint8_t positions[RS_PARITY_LEN / 2];
+    uint8_t found = 0;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        const uint8_t power = len - 1 - i;
+        if (gfPolyEval(locator, errors + 1, gfExp.t[255 - power]) == 0)
+        {
+            if (found == errors)
+            {
+                return -1;
+            }
+            positions[found++] = i;
+        }
+    }
+    if (found != errors)
+    {
+        return -1;
+    }
+
+    // Forney, the error evaluator is syndromes * locator mod x^RS_PARITY_LEN
+    uint8_t evaluator[RS_PARITY_LEN];
+    for (uint8_t i = 0; i < RS_PARITY_LEN; i++)
+    {
+        uint8_t e = 0;
+        for (uint8_t k = 0; k <= i && k <= errors; k++)
+        {
+            e ^= gfMul(locator[k], syndromes[i - k]);
+        }
+        evaluator[i] = e;
+    }
+    // Formal derivative of the locator, only the odd terms remain
+    uint8_t derivative[RS_PARITY_LEN];
+    for (uint8_t i = 0; i < RS_PARITY_LEN; i++)
+    {
+        derivative[i] = (i & 1) ? 0 : locator[i + 1];
+    }
+
+    uint8_t magnitudes[RS_PARITY_LEN / 2];
+    for (uint8_t k = 0; k < found; k++)
+    {
+        const uint8_t power = len - 1 - positions[k];
+        const uint8_t xInv = gfExp.t[255 - power];
+        const uint8_t denominator = gfPolyEval(derivative, RS_PARITY_LEN, xInv);
+        if (denominator == 0)
+        {
+            return -1;
+        }
+        magnitudes[k] = gfMul(gfExp.t[power], gfDiv(gfPolyEval(evaluator, RS_PARITY_LEN, xInv), denominator));
+    }
+
+    for (uint8_t k = 0; k < found; k++)
+    {
+        buf[positions[k]] ^= magnitudes[k];
+    }
+    return found;
+}
+
+#endif // USE_OTA8_RS
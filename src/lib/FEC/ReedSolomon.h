@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Systematic Reed-Solomon code over GF(2^8)
+ *
+ * RS_PARITY_LEN parity bytes are appended to the data, which allows up to
+ * RS_PARITY_LEN / 2 corrupted bytes anywhere in the data or the parity to be
+ * corrected. A burst of bit errors within one byte costs only one byte of the
+ * correction capability.
+ *
+ * The field uses the primitive polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11D)
+ * and the generator's roots are a^0 .. a^(RS_PARITY_LEN - 1).
+ *
+ * Only built with USE_OTA8_RS, the OTA8 RS packet mode is its only user.
+ *
+ * @param buf dataLen bytes of data, followed by room for the RS_PARITY_LEN parity bytes
+ */
+#define RS_PARITY_LEN 4
+
+void RSEncode(uint8_t *buf, uint8_t dataLen);
+
+/**
+ * @brief Correct the errors in a buffer encoded by RSEncode, in place
+ *
+ * @return the number of bytes corrected, or -1 if there were too many errors to correct.
+ * More errors than the code can correct may also be "corrected" to the wrong data,
+ * so the result must still be checked, e.g. with a CRC.
+ */
+int8_t RSDecode(uint8_t *buf, uint8_t dataLen);
@@ -1,6 +1,7 @@
 #include "FHSS.h"
 #include "logging.h"
 #include "options.h"
+#include "helpers.h"
 #include <string.h>
 
 #if defined(RADIO_SX127X) || defined(RADIO_LR1121)
@@ -11,7 +12,7 @@
 #include "SX127xDriver.h"
 #endif
 
-const fhss_config_t domains[] = {
+constexpr fhss_config_t domains[] = {
     {"AU915",  FREQ_HZ_TO_REG_VAL(915500000), FREQ_HZ_TO_REG_VAL(926900000), 20, 921000000},
     {"FCC915", FREQ_HZ_TO_REG_VAL(903500000), FREQ_HZ_TO_REG_VAL(926900000), 40, 915000000},
     {"EU868",  FREQ_HZ_TO_REG_VAL(865275000), FREQ_HZ_TO_REG_VAL(869575000), 13, 868000000},
@@ -23,7 +24,7 @@ const fhss_config_t domains[] = {
 };
 
 #if defined(RADIO_LR1121)
-const fhss_config_t domainsDualBand[] = {
+constexpr fhss_config_t domainsDualBand[] = {
     {"ISM2G4", FREQ_HZ_TO_REG_VAL(2400400000), FREQ_HZ_TO_REG_VAL(2479400000), 80, 2440000000}
 };
 #endif
@@ -31,7 +32,7 @@ const fhss_config_t domainsDualBand[] = {
 #elif defined(RADIO_SX128X)
 #include "SX1280Driver.h"
 
-const fhss_config_t domains[] = {
+constexpr fhss_config_t domains[] = {
     {
     #if defined(Regulatory_Domain_EU_CE_2400)
         "CE_LBT",
@@ -42,6 +43,15 @@ const fhss_config_t domains[] = {
 };
 #endif
 
+static constexpr bool FHSSfreqCountsFit(const fhss_config_t *configs, size_t count)
+{
+    return count == 0 || (configs[0].freq_count <= FHSS_MAX_FREQ_COUNT && FHSSfreqCountsFit(configs + 1, count - 1));
+}
+static_assert(FHSSfreqCountsFit(domains, ARRAY_SIZE(domains)), "Domain freq_count exceeds FHSS_MAX_FREQ_COUNT");
+#if defined(RADIO_LR1121)
+static_assert(FHSSfreqCountsFit(domainsDualBand, ARRAY_SIZE(domainsDualBand)), "Domain freq_count exceeds FHSS_MAX_FREQ_COUNT");
+#endif
+
 // Our table of FHSS frequencies. Define a regulatory domain to select the correct set for your location and radio
 const fhss_config_t *FHSSconfig;
 const fhss_config_t *FHSSconfigDualBand;
@@ -72,6 +82,28 @@ bool FHSSuseDualBand = false;
 uint16_t primaryBandCount;
 uint16_t secondaryBandCount;
 
+// Frequency register values indexed by channel, so a hop is a lookup rather than a multiply and divide
+uint32_t FHSSfreqRegs[FHSS_MAX_FREQ_COUNT];
+uint32_t FHSSgeminiFreqRegs[FHSS_MAX_FREQ_COUNT];
+#if defined(RADIO_LR1121)
+uint32_t FHSSfreqRegs_DualBand[FHSS_MAX_FREQ_COUNT];
+uint32_t FHSSgeminiFreqRegs_DualBand[FHSS_MAX_FREQ_COUNT];
+#endif
+
+static void FHSSbuildFreqRegs(const fhss_config_t *config, uint32_t spread, uint32_t *freqRegs, uint32_t *geminiFreqRegs)
+{
+    uint32_t const freqCount = config->freq_count;
+    for (uint32_t ch = 0; ch < freqCount; ch++)
+    {
+        freqRegs[ch] = config->freq_start + (spread * ch / FREQ_SPREAD_SCALE);
+    }
+    // Gemini uses the channel offset by half of the domain frequency range
+    for (uint32_t ch = 0; ch < freqCount; ch++)
+    {
+        geminiFreqRegs[ch] = freqRegs[(ch + (freqCount / 2)) % freqCount];
+    }
+}
+
 void FHSSrandomiseFHSSsequence(const uint32_t seed)
 {
     FHSSconfig = &domains[firmwareOptions.domain];
@@ -83,6 +115,8 @@ void FHSSrandomiseFHSSsequence(const uint32_t seed)
     DBGLN("Number of FHSS frequencies = %u", FHSSconfig->freq_count);
     DBGLN("Sync channel = %u", sync_channel);
 
+    FHSSbuildFreqRegs(FHSSconfig, freq_spread, FHSSfreqRegs, FHSSgeminiFreqRegs);
+
     FHSSrandomiseFHSSsequenceBuild(seed, FHSSconfig->freq_count, sync_channel, FHSSsequence);
 
 #if defined(RADIO_LR1121)
@@ -95,6 +129,8 @@ void FHSSrandomiseFHSSsequence(const uint32_t seed)
     DBGLN("Number of FHSS frequencies = %u", FHSSconfigDualBand->freq_count);
     DBGLN("Sync channel Dual Band = %u", sync_channel_DualBand);
 
+    FHSSbuildFreqRegs(FHSSconfigDualBand, freq_spread_DualBand, FHSSfreqRegs_DualBand, FHSSgeminiFreqRegs_DualBand);
+
     FHSSusePrimaryFreqBand = false;
     FHSSrandomiseFHSSsequenceBuild(seed, FHSSconfigDualBand->freq_count, sync_channel_DualBand, FHSSsequence_DualBand);
     FHSSusePrimaryFreqBand = true;
@@ -21,6 +21,12 @@
 #endif
 
 #define FHSS_SEQUENCE_LEN 256
+// Largest freq_count of any domain, sizes the precomputed frequency register tables
+#if defined(RADIO_SX127X)
+#define FHSS_MAX_FREQ_COUNT 40
+#else
+#define FHSS_MAX_FREQ_COUNT 80
+#endif
 
 typedef struct {
     const char  *domain;
@@ -40,6 +46,9 @@ extern uint32_t freq_spread;
 extern uint8_t FHSSsequence[];
 extern uint_fast8_t sync_channel;
 extern const fhss_config_t *FHSSconfig;
+// Radio frequency register value of each channel, and of the channel half the band away for Gemini
+extern uint32_t FHSSfreqRegs[];
+extern uint32_t FHSSgeminiFreqRegs[];
 
 // DualBand Variables
 extern bool FHSSusePrimaryFreqBand;
@@ -49,6 +58,10 @@ extern uint32_t freq_spread_DualBand;
 extern uint8_t FHSSsequence_DualBand[];
 extern uint_fast8_t sync_channel_DualBand;
 extern const fhss_config_t *FHSSconfigDualBand;
+#if defined(RADIO_LR1121)
+extern uint32_t FHSSfreqRegs_DualBand[];
+extern uint32_t FHSSgeminiFreqRegs_DualBand[];
+#endif
 
 // create and randomise an FHSS sequence
 void FHSSrandomiseFHSSsequence(uint32_t seed);
@@ -105,14 +118,13 @@ static inline uint16_t FHSSgetSequenceCount()
 // get the initial frequency, which is also the sync channel
 static inline uint32_t FHSSgetInitialFreq()
 {
-    if (FHSSusePrimaryFreqBand)
-    {
-        return FHSSconfig->freq_start + (sync_channel * freq_spread / FREQ_SPREAD_SCALE) - FreqCorrection;
-    }
-    else
+#if defined(RADIO_LR1121)
+    if (!FHSSusePrimaryFreqBand)
     {
-        return FHSSconfigDualBand->freq_start + (sync_channel_DualBand * freq_spread_DualBand / FREQ_SPREAD_SCALE);
+        return FHSSfreqRegs_DualBand[sync_channel_DualBand];
     }
+#endif
+    return FHSSfreqRegs[sync_channel] - FreqCorrection;
 }
 
 // Get the current sequence pointer
@@ -141,18 +153,21 @@ static inline void FHSSsetCurrIndex(const uint8_t value)
 }
 
 // Advance the pointer to the next hop and return the frequency of that channel
+// FHSSptr is always less than the sequence count, so wrap with a compare rather than a modulo
 static inline uint32_t FHSSgetNextFreq()
 {
-    FHSSptr = (FHSSptr + 1) % FHSSgetSequenceCount();
+    uint_fast16_t next = FHSSptr + 1;
+    if (next >= FHSSgetSequenceCount())
+        next = 0;
+    FHSSptr = next;
 
-    if (FHSSusePrimaryFreqBand)
-    {
-        return FHSSconfig->freq_start + (freq_spread * FHSSsequence[FHSSptr] / FREQ_SPREAD_SCALE) - FreqCorrection;
-    }
-    else
+#if defined(RADIO_LR1121)
+    if (!FHSSusePrimaryFreqBand)
     {
-        return FHSSconfigDualBand->freq_start + (freq_spread_DualBand * FHSSsequence_DualBand[FHSSptr] / FREQ_SPREAD_SCALE);
+        return FHSSfreqRegs_DualBand[FHSSsequence_DualBand[next]];
     }
+#endif
+    return FHSSfreqRegs[FHSSsequence[next]] - FreqCorrection;
 }
 
 static inline const char *FHSSgetRegulatoryDomain()
@@ -170,57 +185,48 @@ static inline const char *FHSSgetRegulatoryDomain()
 // Get frequency offset by half of the domain frequency range
 static inline uint32_t FHSSGeminiFreq(uint8_t FHSSsequenceIdx)
 {
-    uint32_t freq;
-    uint32_t numfhss = FHSSgetChannelCount();
-    uint8_t offSetIdx = (FHSSsequenceIdx + (numfhss / 2)) % numfhss; 
-
-    if (FHSSusePrimaryFreqBand)
-    {
-        freq = FHSSconfig->freq_start + (freq_spread * offSetIdx / FREQ_SPREAD_SCALE) - FreqCorrection_2;
-    }
-    else
+#if defined(RADIO_LR1121)
+    if (!FHSSusePrimaryFreqBand)
     {
-        freq = FHSSconfigDualBand->freq_start + (freq_spread_DualBand * offSetIdx / FREQ_SPREAD_SCALE);
+        return FHSSgeminiFreqRegs_DualBand[FHSSsequenceIdx];
     }
-
-    return freq;
+#endif
+    return FHSSgeminiFreqRegs[FHSSsequenceIdx] - FreqCorrection_2;
 }
 
 static inline uint32_t FHSSgetGeminiFreq()
 {
+#if defined(RADIO_LR1121)
     if (FHSSuseDualBand)
     {
         // When using Dual Band there is no need to calculate an offset frequency. Unlike Gemini with 2 frequencies in the same band.
-        return FHSSconfigDualBand->freq_start + (FHSSsequence_DualBand[FHSSptr] * freq_spread_DualBand / FREQ_SPREAD_SCALE);
+        return FHSSfreqRegs_DualBand[FHSSsequence_DualBand[FHSSptr]];
+    }
+#endif
+    if (FHSSusePrimaryFreqBand)
+    {
+        return FHSSGeminiFreq(FHSSsequence[FHSSgetCurrIndex()]);
     }
     else
     {
-        if (FHSSusePrimaryFreqBand)
-        {
-            return FHSSGeminiFreq(FHSSsequence[FHSSgetCurrIndex()]);
-        }
-        else
-        {
-            return FHSSGeminiFreq(FHSSsequence_DualBand[FHSSgetCurrIndex()]);
-        }
+        return FHSSGeminiFreq(FHSSsequence_DualBand[FHSSgetCurrIndex()]);
     }
 }
 
 static inline uint32_t FHSSgetInitialGeminiFreq()
 {
+#if defined(RADIO_LR1121)
     if (FHSSuseDualBand)
     {
-        return FHSSconfigDualBand->freq_start + (sync_channel_DualBand * freq_spread_DualBand / FREQ_SPREAD_SCALE);
+        return FHSSfreqRegs_DualBand[sync_channel_DualBand];
+    }
+#endif
+    if (FHSSusePrimaryFreqBand)
+    {
+        return FHSSGeminiFreq(sync_channel);
     }
     else
     {
-        if (FHSSusePrimaryFreqBand)
-        {
-            return FHSSGeminiFreq(sync_channel);
-        }
-        else
-        {
-            return FHSSGeminiFreq(sync_channel_DualBand);
-        }
+        return FHSSGeminiFreq(sync_channel_DualBand);
     }
 }
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "targets.h"
+#include <atomic>
+#include <string.h>
+
+/**
+ * @brief A lock-free single-producer/single-consumer FIFO.
+ *
+ * One context may push and another may pop without masking interrupts or taking a lock.
+ * The head and tail are free-running counters, only the producer writes `tail` and only
+ * the consumer writes `head`, and they are published with release/acquire ordering so
+ * the bytes they cover are always visible before the index is.
+ *
+ * Producers can write a "packet" in several pieces with `writeBytes` and make it visible
+ * in one go with `commitWrite`, so the consumer never sees a partially written packet.
+ * Consumers can read without copying using `peekSpan`/`commitRead`.
+ *
+ * Unlike FIFO, a write that does not fit is rejected rather than flushing the FIFO,
+ * because the producer is not allowed to move the head.
+ *
+ * @tparam FIFO_SIZE size of the FIFO in bytes, must be a power of two
+ */
+template <uint32_t FIFO_SIZE>
+class SPSCFIFO
+{
+    static_assert(FIFO_SIZE != 0 && (FIFO_SIZE & (FIFO_SIZE - 1)) == 0, "SPSCFIFO size must be a power of two");
+    static constexpr uint32_t INDEX_MASK = FIFO_SIZE - 1;
+
+private:
+    uint8_t buffer[FIFO_SIZE] = {0};
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    // Producer-only, the end of bytes written but not yet committed
+    uint32_t writeTail = 0;
+
+public:
+    /********** Producer methods **********/
+
+    /**
+     * @brief return the number of bytes the producer can still write
+     */
+    ICACHE_RAM_ATTR uint16_t inline free() const
+    {
+        return FIFO_SIZE - (writeTail - head.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Write bytes to the FIFO without making them visible to the consumer
+     * The copy is at most two memcpy calls, one either side of the wraparound
+     *
+     * @return false if all `len` bytes do not fit, in which case nothing is written
+     */
+    ICACHE_RAM_ATTR bool inline writeBytes(const uint8_t *data, uint16_t len)
+    {
+        if (len > free())
+        {
+            return false;
+        }
+        uint32_t const idx = writeTail & INDEX_MASK;
+        uint32_t const firstLen = (len < FIFO_SIZE - idx) ? len : FIFO_SIZE - idx;
+        memcpy(&buffer[idx], data, firstLen);
+        memcpy(&buffer[0], data + firstLen, len - firstLen);
+        writeTail += len;
+        return true;
+    }
+
+    ICACHE_RAM_ATTR bool inline write(const uint8_t data)
+    {
+        return writeBytes(&data, 1);
+    }
+
+    /**
+     * @brief Make all bytes written since the last commit visible to the consumer
+     */
+    ICACHE_RAM_ATTR void inline commitWrite()
+    {
+        tail.store(writeTail, std::memory_order_release);
+    }
+
+    /**
+     * @brief Discard all bytes written since the last commit
+     */
+    ICACHE_RAM_ATTR void inline abortWrite()
+    {
+        writeTail = tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Write and commit all bytes, or none if they do not fit
+     */
+    ICACHE_RAM_ATTR bool inline pushBytes(const uint8_t *data, uint16_t len)
+    {
+        if (!writeBytes(data, len))
+        {
+            return false;
+        }
+        commitWrite();
+        return true;
+    }
+
+    ICACHE_RAM_ATTR bool inline push(const uint8_t data)
+    {
+        return pushBytes(&data, 1);
+    }
+
+    /********** Consumer methods **********/
+
+    /**
+     * @brief return the number of committed bytes available to the consumer
+     */
+    ICACHE_RAM_ATTR uint16_t inline size() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief return the first byte in the FIFO without removing it (0 if empty)
+     */
+    ICACHE_RAM_ATTR uint8_t inline peek() const
+    {
+        if (size() == 0)
+        {
+            return 0;
+        }
+        return buffer[head.load(std::memory_order_relaxed) & INDEX_MASK];
+    }
+
+    /**
+     * @brief Pop a single byte (returns 0 if no bytes left)
+     */
+    ICACHE_RAM_ATTR uint8_t inline pop()
+    {
+        uint8_t data = 0;
+        popBytes(&data, 1);
+        return data;
+    }
+
+    /**
+     * @brief Pop `len` bytes into `data`, in at most two memcpy calls
+     *
+     * @return false if fewer than `len` bytes are available, in which case nothing is read
+     */
+    ICACHE_RAM_ATTR bool inline popBytes(uint8_t *data, uint16_t len)
+    {
+        if (size() < len)
+        {
+            return false;
+        }
+        uint32_t const h = head.load(std::memory_order_relaxed);
+        uint32_t const idx = h & INDEX_MASK;
+        uint32_t const firstLen = (len < FIFO_SIZE - idx) ? len : FIFO_SIZE - idx;
+        memcpy(data, &buffer[idx], firstLen);
+        memcpy(data + firstLen, &buffer[0], len - firstLen);
+        head.store(h + len, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the longest contiguous run of committed bytes at the head of the FIFO
+     * The bytes stay in the FIFO until `commitRead` is called
+     *
+     * @param data set to point at the first byte
+     * @return the number of bytes at `data`, which may be less than `size()` if the data wraps
+     */
+    ICACHE_RAM_ATTR uint16_t inline peekSpan(const uint8_t **data) const
+    {
+        uint32_t const avail = size();
+        uint32_t const idx = head.load(std::memory_order_relaxed) & INDEX_MASK;
+        *data = &buffer[idx];
+        return (avail < FIFO_SIZE - idx) ? avail : FIFO_SIZE - idx;
+    }
+
+    /**
+     * @brief Release `len` bytes from the head of the FIFO, after reading them via `peekSpan`
+     */
+    ICACHE_RAM_ATTR void inline commitRead(uint16_t len)
+    {
+        head.store(head.load(std::memory_order_relaxed) + len, std::memory_order_release);
+    }
+
+    /**
+     * @brief Discard all committed bytes, must only be called by the consumer
+     */
+    ICACHE_RAM_ATTR void inline flush()
+    {
+        head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
@@ -62,6 +62,11 @@ public:
      */
     static ICACHE_RAM_ATTR void inline resetFreqOffset() { FreqOffset = 0; }
 
+    /**
+     * @brief Set the frequency offset to a previously measured value
+     */
+    static void inline setFreqOffset(int32_t offset) { FreqOffset = offset; }
+
     /**
      * @brief Increment the frequency offset by one microsecond
      */
@@ -13,6 +13,74 @@ static const auto MSP_SERIAL_OUT_FIFO_SIZE = 256U;
 static FIFO<MSP_SERIAL_OUT_FIFO_SIZE> MspWriteFIFO;
 
 
+/***
+ * @brief: Unpack the 16x 11-bit channels of a CRSF RC frame into channelData
+ * @desc: Each group of 8 channels is exactly 11 bytes. Every channel is extracted from a
+ *        2 or 3 byte little-endian window at a compile-time offset, so there is no
+ *        per-bit loop and no read past the 22 byte payload
+ ***/
+template <unsigned CH>
+static inline uint32_t CrsfChannelFromGroup(uint8_t const * const group)
+{
+    constexpr unsigned bit = CH * 11;
+    constexpr unsigned idx = bit / 8;
+    constexpr unsigned shift = bit % 8;
+    uint32_t window = group[idx] | (group[idx + 1] << 8);
+    if (shift + 11 > 16)
+        window |= group[idx + 2] << 16;
+    return (window >> shift) & 0x7FF;
+}
+
+static inline void CrsfUnpackGroup(uint8_t const * const group, uint32_t * const dest)
+{
+    dest[0] = CrsfChannelFromGroup<0>(group);
+    dest[1] = CrsfChannelFromGroup<1>(group);
+    dest[2] = CrsfChannelFromGroup<2>(group);
+    dest[3] = CrsfChannelFromGroup<3>(group);
+    dest[4] = CrsfChannelFromGroup<4>(group);
+    dest[5] = CrsfChannelFromGroup<5>(group);
+    dest[6] = CrsfChannelFromGroup<6>(group);
+    dest[7] = CrsfChannelFromGroup<7>(group);
+}
+
+void CRSF::UnpackChannels(crsf_channels_t const * const channels, uint32_t * const channelData)
+{
+    uint8_t const * const payload = (uint8_t const *)channels;
+    CrsfUnpackGroup(&payload[0], &channelData[0]);
+    CrsfUnpackGroup(&payload[11], &channelData[8]);
+}
+
+/***
+ * @brief: Pack 16 channels into the 11-bit fields of a CRSF RC frame, the same bits as
+ *         assigning each crsf_channels_t field
+ * @desc: Channels are added to a 32-bit accumulator and whole bytes stored from it, so each
+ *        channel is one shift and OR instead of a read-modify-write of the bitfields
+ ***/
+static inline void CrsfPackGroup(uint32_t const * const src, uint8_t * const group)
+{
+    uint32_t bits = 0;
+    unsigned count = 0;
+    uint8_t *dest = group;
+    for (unsigned ch = 0; ch < 8; ++ch)
+    {
+        bits |= (src[ch] & 0x7FF) << count;
+        count += 11;
+        while (count >= 8)
+        {
+            *dest++ = bits;
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+}
+
+void CRSF::PackChannels(uint32_t const * const channelData, crsf_channels_t * const channels)
+{
+    uint8_t * const payload = (uint8_t *)channels;
+    CrsfPackGroup(&channelData[0], &payload[0]);
+    CrsfPackGroup(&channelData[8], &payload[11]);
+}
+
 /***
  * @brief: Convert `version` (string) to a integer version representation
  * e.g. "2.2.15 ISM24G" => 0x0002020f
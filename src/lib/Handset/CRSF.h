@@ -22,6 +22,8 @@ public:
     static void SetHeaderAndCrc(uint8_t *frame, crsf_frame_type_e frameType, uint8_t frameSize, crsf_addr_e destAddr);
     static void SetExtendedHeaderAndCrc(uint8_t *frame, crsf_frame_type_e frameType, uint8_t frameSize, crsf_addr_e senderAddr, crsf_addr_e destAddr);
     static uint32_t VersionStrToU32(const char *verStr);
+    static void UnpackChannels(crsf_channels_t const * const channels, uint32_t * const channelData);
+    static void PackChannels(uint32_t const * const channelData, crsf_channels_t * const channels);
 
 #if defined(CRSF_RX_MODULE)
 public:
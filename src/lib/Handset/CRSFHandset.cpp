@@ -1,6 +1,6 @@
 #include "CRSF.h"
 #include "CRSFHandset.h"
-#include "FIFO.h"
+#include "SPSCFIFO.h"
 #include "logging.h"
 #include "helpers.h"
 
@@ -25,7 +25,7 @@ static constexpr int HANDSET_TELEMETRY_FIFO_SIZE = 128; // this is the smallest
 
 /// Out FIFO to buffer messages///
 static constexpr auto CRSF_SERIAL_OUT_FIFO_SIZE = 256U;
-static FIFO<CRSF_SERIAL_OUT_FIFO_SIZE> SerialOutFIFO;
+static SPSCFIFO<CRSF_SERIAL_OUT_FIFO_SIZE> SerialOutFIFO;
 
 Stream *CRSFHandset::PortSecondary;
 
@@ -50,6 +50,13 @@ uint32_t CRSFHandset::UARTrequestedBaud = 5250000;
 // for the UART wdt, every 1000ms we change bauds when connect is lost
 static const int UARTwdtInterval = 1000;
 
+#if defined(PLATFORM_ESP32)
+// The UART RX event fires when the line has been idle this many byte times, i.e. just after each frame
+static constexpr uint8_t UARTrxIdleSymbols = 2;
+// The instance receiving frames in the UART event task
+static CRSFHandset *rxEventHandset;
+#endif
+
 void CRSFHandset::Begin()
 {
     DBGLN("About to start CRSF task...");
@@ -72,6 +79,14 @@ void CRSFHandset::Begin()
     }
     portENABLE_INTERRUPTS();
     flush_port_input();
+    // Receive in the UART event task when the line goes idle after a frame, rather than waiting
+    // for the main loop to poll, so frames are timestamped on arrival and the channels are
+    // updated before the next RF packet regardless of what else the loop is doing
+    rxEventHandset = this;
+    rxQueue.setFrameCallback(onRxFrame);
+    rxQueue.setBaudRate(UARTrequestedBaud, UARTrxIdleSymbols);
+    CRSFHandset::Port.setRxTimeout(UARTrxIdleSymbols);
+    CRSFHandset::Port.onReceive([this]() { onRxEvent(); }, true);
     if (esp_reset_reason() != ESP_RST_POWERON)
     {
         modelId = rtcModelId;
@@ -98,16 +113,25 @@ void CRSFHandset::End()
         }
     }
     //CRSFHandset::Port.end(); // don't call serial.end(), it causes some sort of issue with the 900mhz hardware using gpio2 for serial
+#if defined(PLATFORM_ESP32)
+    CRSFHandset::Port.onReceive(nullptr);
+#endif
     DBGLN("CRSF UART END");
 }
 
 void CRSFHandset::flush_port_input()
 {
+#if defined(PLATFORM_ESP32)
+    // The UART event task is the only reader, so it drops what arrived before now
+    rxQueue.flush(micros());
+#else
     // Make sure there is no garbage on the UART at the start
     while (CRSFHandset::Port.available())
     {
         CRSFHandset::Port.read();
     }
+    parser.reset();
+#endif
 }
 
 void CRSFHandset::makeLinkStatisticsPacket(uint8_t *buffer)
@@ -141,14 +165,13 @@ void CRSFHandset::packetQueueExtended(uint8_t type, void *data, uint8_t len)
     uint8_t crc = crsf_crc.calc(&buf[3], sizeof(buf)-3);
     crc = crsf_crc.calc((byte *)data, len, crc);
 
-    SerialOutFIFO.lock();
-    if (SerialOutFIFO.ensure(buf[0] + 1))
+    if (SerialOutFIFO.free() >= buf[0] + 1)
     {
-        SerialOutFIFO.pushBytes(buf, sizeof(buf));
-        SerialOutFIFO.pushBytes((byte *)data, len);
-        SerialOutFIFO.push(crc);
+        SerialOutFIFO.writeBytes(buf, sizeof(buf));
+        SerialOutFIFO.writeBytes((byte *)data, len);
+        SerialOutFIFO.write(crc);
+        SerialOutFIFO.commitWrite();
     }
-    SerialOutFIFO.unlock();
 }
 
 void CRSFHandset::sendTelemetryToTX(uint8_t *data)
@@ -163,13 +186,12 @@ void CRSFHandset::sendTelemetryToTX(uint8_t *data)
         }
 
         data[0] = CRSF_ADDRESS_RADIO_TRANSMITTER;
-        SerialOutFIFO.lock();
-        if (SerialOutFIFO.ensure(size + 1))
+        if (SerialOutFIFO.free() >= size + 1)
         {
-            SerialOutFIFO.push(size); // length
-            SerialOutFIFO.pushBytes(data, size);
+            SerialOutFIFO.write(size); // length
+            SerialOutFIFO.writeBytes(data, size);
+            SerialOutFIFO.commitWrite();
         }
-        SerialOutFIFO.unlock();
     }
 }
 
@@ -239,40 +261,39 @@ void CRSFHandset::sendSyncPacketToTX() // in values in us.
     }
 }
 
-void CRSFHandset::RcPacketToChannelsData() // data is packed as 11 bits per channel
+void CRSFHandset::RcPacketToChannelsData(const crsf_channels_t *channels) // data is packed as 11 bits per channel
 {
-    // for monitoring arming state
-    uint32_t prev_AUX1 = ChannelData[4];
+    // Unpack outside the lock, then only the copy holds off the timer ISR
+    uint32_t unpacked[CRSF_NUM_CHANNELS];
+    CRSF::UnpackChannels(channels, unpacked);
 
-    auto payload = (uint8_t const * const)&inBuffer.asRCPacket_t.channels;
-    constexpr unsigned srcBits = 11;
-    constexpr unsigned dstBits = 11;
-    constexpr unsigned inputChannelMask = (1 << srcBits) - 1;
-    constexpr unsigned precisionShift = dstBits - srcBits;
+    lockChannelData();
+    // for monitoring arming state
+    const uint32_t prev_AUX1 = ChannelData[4];
+    memcpy(ChannelData, unpacked, sizeof(unpacked));
+    unlockChannelData();
 
-    // code from BetaFlight rx/crsf.cpp / bitpacker_unpack
-    uint8_t bitsMerged = 0;
-    uint32_t readValue = 0;
-    unsigned readByteIndex = 0;
-    for (uint32_t & n : ChannelData)
+    if (prev_AUX1 != unpacked[4])
     {
-        while (bitsMerged < srcBits)
-        {
-            uint8_t readByte = payload[readByteIndex++];
-            readValue |= ((uint32_t) readByte) << bitsMerged;
-            bitsMerged += 8;
-        }
-        //printf("rv=%x(%x) bm=%u\n", readValue, (readValue & inputChannelMask), bitsMerged);
-        n = (readValue & inputChannelMask) << precisionShift;
-        readValue >>= srcBits;
-        bitsMerged -= srcBits;
+        #if defined(PLATFORM_ESP32)
+        devicesTriggerEvent(EVENT_ARM_CHANGED);
+        #endif
     }
+}
 
-    if (prev_AUX1 != ChannelData[4])
+/**
+ * Update the mixer sync timing, and the channels if it is an RC frame, as soon as a good frame
+ * has arrived. On ESP32 this runs in the UART event task, the timestamps are single words read
+ * whole by the timer ISR, the channels are copied under lockChannelData()
+ */
+void CRSFHandset::frameArrived(const uint8_t *frame, uint32_t arrivalMicros)
+{
+    dataLastRecv = arrivalMicros;
+    if (((const rcPacket_t *)frame)->header.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED)
     {
-        #if defined(PLATFORM_ESP32)
-        devicesTriggerEvent();
-        #endif
+        RcPacketToChannelsData(&((const rcPacket_t *)frame)->channels);
+        // After the channels, so the ISR never sees a new time with the old channels
+        RCdataLastRecv = arrivalMicros;
     }
 }
 
@@ -318,12 +339,10 @@ bool CRSFHandset::processInternalCrsfPackage(uint8_t *package)
     return false;
 }
 
-bool CRSFHandset::ProcessPacket()
+bool CRSFHandset::ProcessPacket(uint8_t *SerialInBuffer, uint8_t size)
 {
     bool packetReceived = false;
 
-    CRSFHandset::dataLastRecv = micros();
-
     if (!controllerConnected)
     {
         controllerConnected = true;
@@ -331,13 +350,11 @@ bool CRSFHandset::ProcessPacket()
         if (connected) connected();
     }
 
-    const uint8_t packetType = inBuffer.asRCPacket_t.header.type;
-    uint8_t *SerialInBuffer = inBuffer.asUint8_t;
+    const uint8_t packetType = SerialInBuffer[2];
 
     if (packetType == CRSF_FRAMETYPE_RC_CHANNELS_PACKED)
     {
-        RCdataLastRecv = micros();
-        RcPacketToChannelsData();
+        // The channels were already updated by frameArrived()
         packetReceived = true;
     }
     // check for all extended frames that are a broadcast or a message to the FC
@@ -349,8 +366,7 @@ bool CRSFHandset::ProcessPacket()
         // unless connected
         if (ForwardDevicePings || packetType != CRSF_FRAMETYPE_DEVICE_PING)
         {
-            const uint8_t length = inBuffer.asRCPacket_t.header.frame_size + 2;
-            CRSF::AddMspMessage(length, SerialInBuffer);
+            CRSF::AddMspMessage(size, SerialInBuffer);
         }
         packetReceived = true;
     }
@@ -360,29 +376,8 @@ bool CRSFHandset::ProcessPacket()
     return packetReceived;
 }
 
-void CRSFHandset::alignBufferToSync(uint8_t startIdx)
-{
-    uint8_t *SerialInBuffer = inBuffer.asUint8_t;
-
-    for (unsigned int i=startIdx ; i<SerialInPacketPtr ; i++)
-    {
-        // If we find a header byte then move that and trailing bytes to the head of the buffer and let's go!
-        if (SerialInBuffer[i] == CRSF_ADDRESS_CRSF_TRANSMITTER || SerialInBuffer[i] == CRSF_SYNC_BYTE)
-        {
-            SerialInPacketPtr -= i;
-            memmove(SerialInBuffer, &SerialInBuffer[i], SerialInPacketPtr);
-            return;
-        }
-    }
-
-    // If no header found then discard this entire buffer
-    SerialInPacketPtr = 0;
-}
-
 void CRSFHandset::handleInput()
 {
-    uint8_t *SerialInBuffer = inBuffer.asUint8_t;
-
     if (UARTwdt())
     {
         return;
@@ -409,50 +404,92 @@ void CRSFHandset::handleInput()
         flush_port_input();
     }
 
-    // Add new data, and then discard bytes until we start with header byte
-    auto toRead = std::min(CRSFHandset::Port.available(), CRSF_MAX_PACKET_LEN - SerialInPacketPtr);
-    SerialInPacketPtr += CRSFHandset::Port.readBytes(&SerialInBuffer[SerialInPacketPtr], toRead);
-    alignBufferToSync(0);
-
-    // Make sure we have at least a packet header and a length byte
-    if (SerialInPacketPtr < 3)
-        return;
-
-    // Sanity check: A total packet must be at least [sync][len][type][crc] (if no payload) and at most CRSF_MAX_PACKET_LEN
-    const uint32_t totalLen = SerialInBuffer[1] + 2;
-    if (totalLen < 4 || totalLen > CRSF_MAX_PACKET_LEN)
+#if defined(PLATFORM_ESP32)
+    rxQueue.takeCounts(&GoodPktsCount, &BadPktsCount);
+    uint32_t arrivalMicros;
+    uint8_t * const frame = rxFrame.asUint8_t;
+    const uint8_t size = rxQueue.pop(frame, &arrivalMicros);
+#else
+    uint8_t * const frame = parser.frame().asUint8_t;
+    const uint8_t size = pollFrame();
+#endif
+    if (size != 0 && ProcessPacket(frame, size))
     {
-        // Start looking for another packet after this start byte
-        alignBufferToSync(1);
-        return;
+        handleOutput(size);
+        if (RCdataCallback)
+        {
+            RCdataCallback();
+        }
     }
+}
 
-    // Only proceed one there are enough bytes in the buffer for the entire packet
-    if (SerialInPacketPtr < totalLen)
-        return;
+#if defined(PLATFORM_ESP32)
+/**
+ * Called from the UART event task when the line goes idle, read everything received and
+ * hand it to the queue with the time of the event
+ */
+void CRSFHandset::onRxEvent()
+{
+    const uint32_t now = micros();
+    uint8_t buffer[CRSF_MAX_PACKET_LEN];
+    size_t available = CRSFHandset::Port.available();
+    while (available > 0)
+    {
+        const size_t received = CRSFHandset::Port.readBytes(buffer, std::min(available, sizeof(buffer)));
+        if (received == 0)
+        {
+            return;
+        }
+        available -= received;
+        rxQueue.receive(buffer, received, now, available);
+    }
+}
 
-    uint8_t CalculatedCRC = crsf_crc.calc(&SerialInBuffer[2], totalLen - 3);
-    if (CalculatedCRC == SerialInBuffer[totalLen - 1])
+void CRSFHandset::onRxFrame(const uint8_t *frame, uint32_t arrivalMicros)
+{
+    rxEventHandset->frameArrived(frame, arrivalMicros);
+}
+#else
+/**
+ * Read only what the parser needs for the current frame, so any following frame is left in
+ * the UART for the next call
+ * @return the size of the frame in the parser, 0 if there is no complete frame yet
+ */
+uint8_t CRSFHandset::pollFrame()
+{
+    int available = CRSFHandset::Port.available();
+    while (available > 0 || parser.pendingBytes() != 0)
     {
-        GoodPktsCount++;
-        if (ProcessPacket())
+        // Once the UART is empty, carry on with the bytes kept after a bad CRC
+        uint8_t received = 0;
+        if (available > 0)
         {
-            handleOutput(totalLen);
-            if (RCdataCallback)
+            const int toRead = std::min(available, (int)parser.bytesWanted());
+            received = CRSFHandset::Port.readBytes(parser.writePtr(), toRead);
+            if (received == 0)
             {
-                RCdataCallback();
+                return 0;
             }
+            available -= received;
         }
-    }
-    else
-    {
-        DBGLN("UART CRC failure");
-        BadPktsCount++;
-    }
 
-    SerialInPacketPtr -= totalLen;
-    memmove(SerialInBuffer, &SerialInBuffer[totalLen], SerialInPacketPtr);
+        switch (parser.commit(received))
+        {
+        case CRSFParser::FRAME_OK:
+            GoodPktsCount++;
+            frameArrived(parser.frame().asUint8_t, micros());
+            return parser.size();
+        case CRSFParser::FRAME_BAD_CRC:
+            DBGLN("UART CRC failure");
+            BadPktsCount++;
+            return 0;
+        default:
+            break;
+        }
+    }
+    return 0;
 }
+#endif
 
 void CRSFHandset::handleOutput(int receivedBytes)
 {
@@ -463,9 +500,7 @@ void CRSFHandset::handleOutput(int receivedBytes)
 
     if (!controllerConnected)
     {
-        SerialOutFIFO.lock();
         SerialOutFIFO.flush();
-        SerialOutFIFO.unlock();
         return;
     }
 
@@ -490,7 +525,6 @@ void CRSFHandset::handleOutput(int receivedBytes)
 
         do
         {
-            SerialOutFIFO.lock();
             // no package is in transit so get new data from the fifo
             if (packageLengthRemaining == 0)
             {
@@ -498,7 +532,6 @@ void CRSFHandset::handleOutput(int receivedBytes)
                 SerialOutFIFO.popBytes(CRSFoutBuffer, packageLengthRemaining);
                 sendingOffset = 0;
             }
-            SerialOutFIFO.unlock();
 
             // if the package is long we need to split it, so it fits in the sending interval
             uint8_t writeLength = std::min(packageLengthRemaining, periodBytesRemaining);
@@ -740,6 +773,9 @@ bool CRSFHandset::UARTwdt()
 #if defined(PLATFORM_ESP8266) || defined(PLATFORM_ESP32)
                 CRSFHandset::Port.flush();
                 CRSFHandset::Port.updateBaudRate(UARTrequestedBaud);
+#if defined(PLATFORM_ESP32)
+                rxQueue.setBaudRate(UARTrequestedBaud, UARTrxIdleSymbols);
+#endif
 #else
                 CRSFHandset::Port.begin(UARTrequestedBaud);
 #endif
@@ -3,6 +3,8 @@
 
 #include "handset.h"
 #include "crsf_protocol.h"
+#include "CRSFParser.h"
+#include "CRSFRxQueue.h"
 #ifndef TARGET_NATIVE
 #include "HardwareSerial.h"
 #endif
@@ -51,7 +53,13 @@ public:
     int getMinPacketInterval() const override;
 
 private:
-    inBuffer_U inBuffer = {};
+#if defined(PLATFORM_ESP32)
+    // Frames are received in the UART event task and picked up from the queue by handleInput
+    CRSFRxQueue rxQueue;
+    inBuffer_U rxFrame;
+#else
+    CRSFParser parser;
+#endif
 
     /// OpenTX mixer sync ///
     volatile uint32_t dataLastRecv = 0;
@@ -61,7 +69,6 @@ private:
     uint32_t OpenTXsyncLastSent = 0;
 
     /// UART Handling ///
-    uint8_t SerialInPacketPtr = 0; // index where we are reading/writing
     static bool halfDuplex;
     bool transmitting = false;
     uint32_t GoodPktsCount = 0;
@@ -81,10 +88,16 @@ private:
     void adjustMaxPacketSize();
     void duplex_set_RX() const;
     void duplex_set_TX() const;
-    void RcPacketToChannelsData();
+    void RcPacketToChannelsData(const crsf_channels_t *channels);
+    void frameArrived(const uint8_t *frame, uint32_t arrivalMicros);
     bool processInternalCrsfPackage(uint8_t *package);
-    void alignBufferToSync(uint8_t startIdx);
-    bool ProcessPacket();
+    bool ProcessPacket(uint8_t *frame, uint8_t size);
+#if defined(PLATFORM_ESP32)
+    void onRxEvent();
+    static void onRxFrame(const uint8_t *frame, uint32_t arrivalMicros);
+#else
+    uint8_t pollFrame();
+#endif
     bool UARTwdt();
     uint32_t autobaud();
     void flush_port_input();
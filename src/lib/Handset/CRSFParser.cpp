@@ -0,0 +1,109 @@
+#include "CRSFParser.h"
+#include "CRSF.h"
+#include <string.h>
+
+CRSFParser::result_e CRSFParser::parse(uint8_t n)
+{
+    uint8_t * const data = buffer.asUint8_t;
+
+    switch (state)
+    {
+    case STATE_SYNC:
+        // Discard bytes until a header byte
+        if (n != 0 && isSyncByte(data[0]))
+        {
+            writePos = 1;
+            state = STATE_LENGTH;
+        }
+        return FRAME_INCOMPLETE;
+
+    case STATE_LENGTH:
+        if (n == 0)
+        {
+            return FRAME_INCOMPLETE;
+        }
+        // Sanity check: A total packet must be at least [sync][len][type][crc] (if no payload) and at most CRSF_MAX_PACKET_LEN
+        frameLen = data[1] + CRSF_FRAME_NOT_COUNTED_BYTES;
+        if (frameLen < 4 || frameLen > CRSF_MAX_PACKET_LEN)
+        {
+            // Start looking for another packet after this start byte, which may be the length byte
+            data[0] = data[1];
+            if (!isSyncByte(data[0]))
+            {
+                restart();
+            }
+            return FRAME_INCOMPLETE;
+        }
+        writePos = 2;
+        crc = 0;
+        state = STATE_BODY;
+        return FRAME_INCOMPLETE;
+
+    case STATE_BODY:
+    {
+        // Everything after the length byte up to the CRC byte is covered by the CRC
+        uint8_t const crcEnd = frameLen - CRSF_FRAME_CRC_SIZE;
+        uint8_t const crcLen = (writePos + n > crcEnd ? crcEnd : writePos + n) - writePos;
+        crc = crsf_crc.calc(&data[writePos], crcLen, crc);
+        writePos += n;
+        if (writePos < frameLen)
+        {
+            return FRAME_INCOMPLETE;
+        }
+
+        restart();
+        return crc == data[crcEnd] ? FRAME_OK : FRAME_BAD_CRC;
+    }
+    }
+
+    return FRAME_INCOMPLETE;
+}
+
+/**
+ * Parse the replay bytes until they give a result or run out. A bad CRC puts the bytes after
+ * its sync byte back at the front, which came out of the replay so there is always room.
+ */
+CRSFParser::result_e CRSFParser::parseReplay()
+{
+    uint8_t pos = 0;
+    result_e result = FRAME_INCOMPLETE;
+    while (pos < replayLen && result == FRAME_INCOMPLETE)
+    {
+        const uint8_t wanted = state == STATE_BODY ? frameLen - writePos : 1;
+        const uint8_t n = replayLen - pos < wanted ? replayLen - pos : wanted;
+        memcpy(writePtr(), &replay[pos], n);
+        pos += n;
+        result = parse(n);
+        if (result == FRAME_BAD_CRC)
+        {
+            const uint8_t rescan = frameLen - 1;
+            memmove(&replay[rescan], &replay[pos], replayLen - pos);
+            memcpy(replay, &buffer.asUint8_t[1], rescan);
+            replayLen = rescan + replayLen - pos;
+            return result;
+        }
+    }
+    memmove(replay, &replay[pos], replayLen - pos);
+    replayLen -= pos;
+    return result;
+}
+
+CRSFParser::result_e CRSFParser::commit(uint8_t n)
+{
+    if (replayLen == 0)
+    {
+        const result_e result = parse(n);
+        if (result == FRAME_BAD_CRC)
+        {
+            // Parse the frame again from the byte after the false sync byte, starting next commit
+            replayLen = frameLen - 1;
+            memcpy(replay, &buffer.asUint8_t[1], replayLen);
+        }
+        return result;
+    }
+
+    // The new bytes go after the ones still to be parsed again
+    memcpy(&replay[replayLen], writePtr(), n);
+    replayLen += n;
+    return parseReplay();
+}
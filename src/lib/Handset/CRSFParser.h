@@ -0,0 +1,86 @@
+#pragma once
+
+#include "crsf_protocol.h"
+
+/**
+ * @brief Streaming parser for the CRSF frames from the handset.
+ *
+ * Bytes are read straight from the UART into the frame buffer, only as many as are needed for
+ * the current frame, so a frame always starts at the beginning of the buffer and nothing is
+ * ever moved. The CRC is calculated as the bytes arrive, so a complete frame is checked
+ * without going over it again.
+ *
+ * A frame which fails its CRC may have started on a byte which only looked like a sync byte,
+ * with a real frame inside it, so its bytes after that sync byte are kept and parsed again
+ * before any new bytes, one new byte per commit() until they are used up. commit(0) parses
+ * them without any new bytes, so callers should keep calling it while pendingBytes() is not 0
+ * once the UART is empty.
+ *
+ * Usage:
+ *   n = Port.readBytes(parser.writePtr(), min(Port.available(), parser.bytesWanted()));
+ *   if (parser.commit(n) == CRSFParser::FRAME_OK) { use parser.frame(), valid until the next commit() }
+ */
+class CRSFParser
+{
+public:
+    typedef enum : uint8_t {
+        FRAME_INCOMPLETE,
+        FRAME_OK,
+        FRAME_BAD_CRC,
+    } result_e;
+
+    CRSFParser() { reset(); }
+
+    void reset()
+    {
+        restart();
+        replayLen = 0;
+    }
+
+    uint8_t *writePtr() { return &buffer.asUint8_t[writePos]; }
+
+    /**
+     * @return the number of bytes which can be written to writePtr(), which is never more than
+     * what is needed to complete the current frame
+     */
+    uint8_t bytesWanted() const { return state == STATE_BODY && replayLen == 0 ? frameLen - writePos : 1; }
+
+    /**
+     * @brief Parse `n` bytes which were written to writePtr()
+     * @return FRAME_OK when a frame is complete and its CRC is good
+     */
+    result_e commit(uint8_t n);
+
+    /**
+     * @return the number of bytes kept to be parsed again, which were all received after the
+     * frame just parsed
+     */
+    uint8_t pendingBytes() const { return replayLen; }
+
+    inBuffer_U &frame() { return buffer; }
+    uint8_t size() const { return frameLen; }
+
+private:
+    enum : uint8_t {
+        STATE_SYNC,
+        STATE_LENGTH,
+        STATE_BODY,
+    } state;
+    uint8_t writePos;
+    uint8_t frameLen;
+    uint8_t crc;
+    inBuffer_U buffer;
+    // Bytes to parse again after a bad CRC, followed by any committed since
+    uint8_t replayLen;
+    uint8_t replay[CRSF_MAX_PACKET_LEN];
+
+    void restart()
+    {
+        state = STATE_SYNC;
+        writePos = 0;
+    }
+    result_e parse(uint8_t n);
+    result_e parseReplay();
+
+    static bool isSyncByte(uint8_t b) { return b == CRSF_ADDRESS_CRSF_TRANSMITTER || b == CRSF_SYNC_BYTE; }
+};
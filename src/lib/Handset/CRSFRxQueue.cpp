@@ -0,0 +1,99 @@
+#include "CRSFRxQueue.h"
+#include <string.h>
+
+void CRSFRxQueue::setBaudRate(uint32_t baud, uint8_t idle)
+{
+    // 10 bits per byte (8N1)
+    byteTime.store(10UL * 1000000UL * 256UL / baud, std::memory_order_relaxed);
+    idleSymbols.store(idle, std::memory_order_relaxed);
+}
+
+void CRSFRxQueue::receive(const uint8_t *data, uint16_t len, uint32_t eventMicros, uint16_t bytesAfter)
+{
+    const uint32_t time = byteTime.load(std::memory_order_relaxed);
+    const uint8_t idle = idleSymbols.load(std::memory_order_relaxed);
+    if (resetRequested.exchange(false, std::memory_order_acquire))
+    {
+        parser.reset();
+        discarding = true;
+    }
+    if (discarding)
+    {
+        // Drop the bytes which arrived before the flush, worked back from the event time the
+        // same way as the frame arrival times
+        const uint32_t flushAt = flushMicros.load(std::memory_order_relaxed);
+        while (len > 0 && (int32_t)(eventMicros - (((uint32_t)len - 1 + bytesAfter + idle) * time >> 8) - flushAt) < 0)
+        {
+            ++data;
+            --len;
+        }
+        // An event from before the flush, or the rest of this one, may still hold older bytes
+        discarding = len == 0 && (bytesAfter != 0 || (int32_t)(eventMicros - flushAt) < 0);
+    }
+
+    while (len > 0 || parser.pendingBytes() != 0)
+    {
+        const uint8_t n = len < parser.bytesWanted() ? len : parser.bytesWanted();
+        memcpy(parser.writePtr(), data, n);
+        data += n;
+        len -= n;
+
+        const CRSFParser::result_e result = parser.commit(n);
+        if (result == CRSFParser::FRAME_BAD_CRC)
+        {
+            badCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (result == CRSFParser::FRAME_OK)
+        {
+            goodCount.fetch_add(1, std::memory_order_relaxed);
+
+            // The event fired `idle` byte times after the last byte, which came after all the
+            // bytes still to be parsed
+            const uint32_t arrivalMicros = eventMicros - (((uint32_t)len + parser.pendingBytes() + bytesAfter + idle) * time >> 8);
+            const uint8_t *frame = parser.frame().asUint8_t;
+            if (onFrame)
+            {
+                onFrame(frame, arrivalMicros);
+            }
+
+            const uint8_t size = parser.size();
+            if (frames.free() >= size + 1 + sizeof(arrivalMicros))
+            {
+                frames.writeBytes(&size, 1);
+                frames.writeBytes((const uint8_t *)&arrivalMicros, sizeof(arrivalMicros));
+                frames.writeBytes(frame, size);
+                frames.commitWrite();
+            }
+        }
+    }
+}
+
+uint8_t CRSFRxQueue::pop(uint8_t *frame, uint32_t *arrivalMicros)
+{
+    if (frames.size() == 0)
+    {
+        return 0;
+    }
+    // The producer commits whole frames, so the rest is always there
+    const uint8_t size = frames.pop();
+    frames.popBytes((uint8_t *)arrivalMicros, sizeof(*arrivalMicros));
+    frames.popBytes(frame, size);
+    return size;
+}
+
+void CRSFRxQueue::flush(uint32_t nowMicros)
+{
+    flushMicros.store(nowMicros, std::memory_order_relaxed);
+    resetRequested.store(true, std::memory_order_release);
+    frames.flush();
+}
+
+void CRSFRxQueue::takeCounts(uint32_t *good, uint32_t *bad)
+{
+    const uint32_t g = goodCount.load(std::memory_order_relaxed);
+    const uint32_t b = badCount.load(std::memory_order_relaxed);
+    *good += g - goodTaken;
+    *bad += b - badTaken;
+    goodTaken = g;
+    badTaken = b;
+}
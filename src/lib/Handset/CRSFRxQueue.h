@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include "CRSFParser.h"
+#include "SPSCFIFO.h"
+
+/**
+ * @brief Event driven receive of CRSF frames from the handset UART.
+ *
+ * The producer side is called from the UART receive event (RX FIFO threshold or idle timeout)
+ * with the bytes which have arrived, and the time the event fired. The bytes are parsed there
+ * and each complete frame is timestamped with the time its last byte arrived, worked back from
+ * the event time using the byte time at the current baud rate. This is independent of how
+ * long the main loop takes to get round to the frame.
+ *
+ * Each good frame is handed to the frame callback immediately, still in the event context,
+ * then queued for the consumer (the main loop) to pop.
+ */
+class CRSFRxQueue
+{
+public:
+    /**
+     * @param baud the current UART baud rate
+     * @param idleSymbols the UART idle timeout which fires the event, in symbols (byte times)
+     */
+    void setBaudRate(uint32_t baud, uint8_t idleSymbols);
+
+    /**
+     * @brief register a function called from the event context for each good frame
+     */
+    void setFrameCallback(void (*callback)(const uint8_t *frame, uint32_t arrivalMicros)) { onFrame = callback; }
+
+    /********** Producer methods **********/
+
+    /**
+     * @brief Parse bytes received in a UART event
+     * @param eventMicros the time of the event, which fired idleSymbols after the last byte
+     * @param bytesAfter the number of bytes received in the same event which follow these,
+     * if the event is handed over in several pieces
+     */
+    void receive(const uint8_t *data, uint16_t len, uint32_t eventMicros, uint16_t bytesAfter = 0);
+
+    /********** Consumer methods **********/
+
+    /**
+     * @brief Pop the next frame
+     * @param frame set to the frame, which must have room for CRSF_MAX_PACKET_LEN bytes
+     * @param arrivalMicros set to the time the last byte of the frame arrived
+     * @return the size of the frame, 0 if there is none
+     */
+    uint8_t pop(uint8_t *frame, uint32_t *arrivalMicros);
+
+    /**
+     * @brief Discard queued frames, and any partial frame the next time the producer runs,
+     * along with the bytes it is given which arrived before the flush. The producer is the
+     * only reader of the UART, so this is how the consumer empties it.
+     * @param nowMicros the time of the flush
+     */
+    void flush(uint32_t nowMicros);
+
+    /**
+     * @brief Add the number of good and bad frames since the last call to the counters
+     */
+    void takeCounts(uint32_t *good, uint32_t *bad);
+
+private:
+    CRSFParser parser;
+    SPSCFIFO<512> frames;
+    void (*onFrame)(const uint8_t *frame, uint32_t arrivalMicros) = nullptr;
+
+    // The time for one byte in 1/256us, set by the consumer when the baud rate changes
+    std::atomic<uint32_t> byteTime{0};
+    std::atomic<uint8_t> idleSymbols{0};
+    std::atomic<bool> resetRequested{false};
+    std::atomic<uint32_t> flushMicros{0};
+    // Producer-only, still dropping the bytes from before the flush
+    bool discarding = false;
+
+    std::atomic<uint32_t> goodCount{0};
+    std::atomic<uint32_t> badCount{0};
+    // Consumer-only, the counts at the last takeCounts()
+    uint32_t goodTaken = 0;
+    uint32_t badTaken = 0;
+};
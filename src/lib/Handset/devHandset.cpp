@@ -12,6 +12,9 @@
 #endif
 
 Handset *handset;
+#if defined(PLATFORM_ESP32)
+portMUX_TYPE Handset::channelDataMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
 
 static void initialize()
 {
@@ -51,5 +54,6 @@ device_t Handset_device = {
     .initialize = initialize,
     .start = start,
     .event = event,
-    .timeout = timeout};
+    .timeout = timeout,
+    .events = EVENT_POWER_CHANGED};
 #endif
@@ -95,6 +95,26 @@ public:
      */
     uint32_t GetRCdataLastRecv() const { return RCdataLastRecv; }
 
+    /**
+     * @brief Hold off the handset updating ChannelData while it is read or changed.
+     * On ESP32 the CRSF handset unpacks the channels in the UART event task, which may run on the
+     * other core to the timer ISR sending them, so both sides only touch the channels inside this.
+     * Keep the section to a copy of the channels, it spins the other core.
+     */
+    static void ICACHE_RAM_ATTR lockChannelData()
+    {
+#if defined(PLATFORM_ESP32)
+        portENTER_CRITICAL(&channelDataMux);
+#endif
+    }
+
+    static void ICACHE_RAM_ATTR unlockChannelData()
+    {
+#if defined(PLATFORM_ESP32)
+        portEXIT_CRITICAL(&channelDataMux);
+#endif
+    }
+
 #if defined(DEBUG_TX_FREERUN)
     /**
      * @brief Can be used to force a connected callback for debugging
@@ -105,6 +125,10 @@ public:
 protected:
     virtual ~Handset() = default;
 
+#if defined(PLATFORM_ESP32)
+    static portMUX_TYPE channelDataMux;
+#endif
+
     bool controllerConnected = false;
     void (*RCdataCallback)() = nullptr;  // called when there is new RC data
     void (*disconnected)() = nullptr;    // called when RC packet stream is lost
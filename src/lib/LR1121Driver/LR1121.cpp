@@ -74,7 +74,7 @@ bool LR1121Driver::Begin(uint32_t minimumFrequency, uint32_t maximumFrequency)
     }
     DBGLN("LR1121 #1 Ready");
 
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN)
+    if (RadioPins.hasSecondRadio)
     {
         // Validate that the LR1121 #2 is working.
         memset(version, 0, sizeof(version));
@@ -372,7 +372,7 @@ void ICACHE_RAM_ATTR LR1121Driver::CommitOutputPower()
     if (pwrForceUpdate)
     {
         WriteOutputPower(radio1isSubGHz ? pwrCurrentLF : pwrCurrentHF, radio1isSubGHz, SX12XX_Radio_1);
-        if (GPIO_PIN_NSS_2 != UNDEF_PIN)
+        if (RadioPins.hasSecondRadio)
         {
             WriteOutputPower(radio2isSubGHz ? pwrCurrentLF : pwrCurrentHF, radio2isSubGHz, SX12XX_Radio_2);
         }
@@ -493,7 +493,7 @@ void LR1121Driver::ConfigModParamsLoRa(uint8_t bw, uint8_t sf, uint8_t cr, SX12X
     if (radioNumber & SX12XX_Radio_1 && radio1isSubGHz)
         CorrectRegisterForSF6(sf, SX12XX_Radio_1);
 
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN)
+    if (RadioPins.hasSecondRadio)
     {
         if (radioNumber & SX12XX_Radio_2 && radio2isSubGHz)
             CorrectRegisterForSF6(sf, SX12XX_Radio_2);
@@ -606,7 +606,7 @@ void ICACHE_RAM_ATTR LR1121Driver::TXnb(uint8_t * data, uint8_t size, SX12XX_Rad
 #endif
 
     // Normal diversity mode
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN && radioNumber != SX12XX_Radio_All)
+    if (RadioPins.hasSecondRadio && radioNumber != SX12XX_Radio_All)
     {
         // Make sure the unused radio is in FS mode and will not receive the tx packet.
         if (radioNumber == SX12XX_Radio_1)
@@ -700,7 +700,7 @@ void ICACHE_RAM_ATTR LR1121Driver::GetLastPacketStats()
     // processingRadio always passed the sanity check here
     gotRadio[processingRadioIdx] = true;
 
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN)
+    if (RadioPins.hasSecondRadio)
     {
         bool isSecondRadioGotData = false;
 
@@ -827,7 +827,7 @@ void ICACHE_RAM_ATTR LR1121Driver::GetLastPacketStats()
 
 void ICACHE_RAM_ATTR LR1121Driver::IsrCallback_1()
 {
-    if (digitalRead(GPIO_PIN_DIO1))
+    if (RadioPinRead(RadioPins.dio[0]))
     {
         instance->IsrCallback(SX12XX_Radio_1);
     }
@@ -835,7 +835,7 @@ void ICACHE_RAM_ATTR LR1121Driver::IsrCallback_1()
 
 void ICACHE_RAM_ATTR LR1121Driver::IsrCallback_2()
 {
-    if (digitalRead(GPIO_PIN_DIO1_2))
+    if (RadioPinRead(RadioPins.dio[1]))
     {
         instance->IsrCallback(SX12XX_Radio_2);
     }
@@ -27,6 +27,7 @@ void LR1121Hal::end()
 void LR1121Hal::init()
 {
     DBGLN("Hal Init");
+    RadioPinsInit();
 
     pinMode(GPIO_PIN_BUSY, INPUT);
     if (GPIO_PIN_BUSY_2 != UNDEF_PIN)
@@ -165,21 +166,21 @@ bool ICACHE_RAM_ATTR LR1121Hal::WaitOnBusy(SX12XX_Radio_Number_t radioNumber)
     {
         if (radioNumber == SX12XX_Radio_1)
         {
-            if (digitalRead(GPIO_PIN_BUSY) == LOW) return true;
+            if (!RadioPinRead(RadioPins.busy[0])) return true;
         }
         else if (radioNumber == SX12XX_Radio_2)
         {
-            if (GPIO_PIN_BUSY_2 == UNDEF_PIN || digitalRead(GPIO_PIN_BUSY_2) == LOW) return true;
+            if (RadioPins.busy[1] == UNDEF_PIN || !RadioPinRead(RadioPins.busy[1])) return true;
         }
         else if (radioNumber == SX12XX_Radio_All)
         {
-            if (GPIO_PIN_BUSY_2 != UNDEF_PIN)
+            if (RadioPins.busy[1] != UNDEF_PIN)
             {
-                if (digitalRead(GPIO_PIN_BUSY) == LOW && digitalRead(GPIO_PIN_BUSY_2) == LOW) return true;
+                if (!RadioPinRead(RadioPins.busy[0]) && !RadioPinRead(RadioPins.busy[1])) return true;
             }
             else
             {
-                if (digitalRead(GPIO_PIN_BUSY) == LOW) return true;
+                if (!RadioPinRead(RadioPins.busy[0])) return true;
             }
         }
         // Use this time to call micros().
@@ -2,6 +2,7 @@
 
 #include "LR1121_Regs.h"
 #include "LR1121.h"
+#include "RadioPins.h"
 
 class LR1121Hal
 {
@@ -39,6 +39,13 @@ static struct luaItem_selection luaSBUSFailsafeMode = {
     STR_EMPTYSPACE
 };
 
+static struct luaItem_selection luaSBUSRate = {
+    {"SBUS rate", CRSF_TEXT_SELECTION},
+    0, // value
+    "9ms;7ms;5ms;4ms",
+    STR_EMPTYSPACE
+};
+
 static struct luaItem_int8 luaTargetSysId = {
   {"Target SysID", CRSF_UINT8},
   {
@@ -374,7 +381,7 @@ static void luaparamMappingChannelOut(struct luaPropertiesCommon *item, uint8_t
     }
 
     // Trigger an event to update the related fields to represent the selected channel
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_CONFIG_CHANGED);
 }
 
 static void luaparamMappingChannelIn(struct luaPropertiesCommon *item, uint8_t arg)
@@ -533,6 +540,18 @@ static void registerLuaParameters()
     config.SetFailsafeMode((eFailsafeMode)arg);
   });
 
+  registerLUAParameter(&luaSBUSRate, [](struct luaPropertiesCommon* item, uint8_t arg){
+    config.SetSbusRate((eSbusRate)arg);
+    if (config.IsModified()) {
+      deferExecutionMillis(100, [](){
+        reconfigureSerial();
+#if defined(PLATFORM_ESP32)
+        reconfigureSerial1();
+#endif
+      });
+    }
+  });
+
 eSerialProtocol prot0 = config.GetSerialProtocol();
 bool hasMavlink = prot0 == PROTOCOL_MAVLINK;
 #if defined(PLATFORM_ESP32)
@@ -624,6 +643,7 @@ static int event()
 #endif
   
   setLuaTextSelectionValue(&luaSBUSFailsafeMode, config.GetFailsafeMode());
+  setLuaTextSelectionValue(&luaSBUSRate, config.GetSbusRate());
 
   if (GPIO_PIN_ANT_CTRL != UNDEF_PIN)
   {
@@ -25,6 +25,7 @@
     "50 Low Band;100 Low Band;100 Full Low Band;200 Low Band"
 #elif defined(RADIO_SX128X)
 #define STR_LUA_PACKETRATES \
+    "250Hz Full RS(-105dBm);" \
     "50Hz(-115dBm);100Hz Full(-112dBm);150Hz(-112dBm);250Hz(-108dBm);333Hz Full(-105dBm);500Hz(-105dBm);" \
     "D250(-104dBm);D500(-104dBm);F500(-104dBm);F1000(-104dBm)"
 #else
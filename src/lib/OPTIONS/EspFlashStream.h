@@ -8,6 +8,7 @@ public:
     EspFlashStream();
     // Set the starting address to use with seek()s
     void setBaseAddress(size_t base);
+    size_t getBaseAddress() const { return _flashBase; }
     size_t getPosition() const { return _flashOffset + _bufferPos; }
     void setPosition(size_t offset);
 
@@ -0,0 +1,77 @@
+#include "HardwareBlob.h"
+#include "crc.h"
+
+#define HARDWARE_BLOB_CRC16_POLY 0x3D65 // ELRS_CRC16_POLY
+
+static_assert(sizeof(hardware_blob_entry_t) == 8, "hardware_blob_entry_t must match python/hardware_blob.py");
+static_assert(sizeof(hardware_blob_trailer_t) == 12, "hardware_blob_trailer_t must match python/hardware_blob.py");
+
+bool HardwareBlobTrailerValid(const hardware_blob_trailer_t &trailer, uint16_t maxSize)
+{
+    return trailer.magic == HARDWARE_BLOB_MAGIC &&
+        trailer.version == HARDWARE_BLOB_VERSION &&
+        trailer.size <= maxSize &&
+        trailer.count * sizeof(hardware_blob_entry_t) <= trailer.size;
+}
+
+bool HardwareBlobValid(const uint8_t *blob, const hardware_blob_trailer_t &trailer)
+{
+    Crc2Byte crc;
+    crc.init(16, HARDWARE_BLOB_CRC16_POLY);
+    uint16_t c = 0;
+    for (uint16_t pos = 0; pos < trailer.size; pos += 128)
+    {
+        const uint16_t len = trailer.size - pos < 128 ? trailer.size - pos : 128;
+        c = crc.calc(const_cast<uint8_t *>(blob + pos), len, c);
+    }
+    if (c != trailer.crc)
+    {
+        return false;
+    }
+
+    const hardware_blob_entry_t *entries = (const hardware_blob_entry_t *)blob;
+    for (uint8_t i = 0; i < trailer.count; i++)
+    {
+        if (entries[i].type == HARDWARE_BLOB_ARRAY &&
+            (entries[i].value.offset & 1 || entries[i].value.offset + entries[i].count * sizeof(int16_t) > trailer.size))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const hardware_blob_entry_t *HardwareBlobFind(const uint8_t *blob, const hardware_blob_trailer_t &trailer, uint16_t key)
+{
+    const hardware_blob_entry_t *entries = (const hardware_blob_entry_t *)blob;
+    uint8_t low = 0;
+    uint8_t high = trailer.count;
+    while (low < high)
+    {
+        const uint8_t mid = (low + high) / 2;
+        if (entries[mid].key < key)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low < trailer.count && entries[low].key == key ? &entries[low] : nullptr;
+}
+
+int32_t HardwareBlobInt(const hardware_blob_entry_t *entry)
+{
+    return entry->type == HARDWARE_BLOB_FLOAT ? (int32_t)entry->value.f : entry->value.i;
+}
+
+float HardwareBlobFloat(const hardware_blob_entry_t *entry)
+{
+    return entry->type == HARDWARE_BLOB_FLOAT ? entry->value.f : (float)entry->value.i;
+}
+
+const int16_t *HardwareBlobArray(const uint8_t *blob, const hardware_blob_entry_t *entry)
+{
+    return (const int16_t *)(blob + entry->value.offset);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * The hardware layout in binary form, built from the JSON by python/hardware_blob.py and placed at the
+ * end of the hardware area appended to the firmware, after the JSON itself. Boot reads it instead of
+ * parsing the JSON, which is kept for the web UI and for firmware that does not know this layout.
+ *
+ * From the start of the blob, all little endian:
+ *   hardware_blob_entry_t entries[count], sorted by key
+ *   int16_t arrays[]
+ *   hardware_blob_trailer_t trailer, the last bytes of the hardware area
+ */
+#define HARDWARE_BLOB_MAGIC 0x57484C45 // "ELHW"
+#define HARDWARE_BLOB_VERSION 1
+
+typedef enum : uint8_t {
+    HARDWARE_BLOB_INT,
+    HARDWARE_BLOB_BOOL,
+    HARDWARE_BLOB_FLOAT,
+    HARDWARE_BLOB_ARRAY,
+} hardware_blob_type_t;
+
+typedef struct {
+    uint16_t key;       // HardwareBlobKey() of the JSON name
+    uint8_t type;       // hardware_blob_type_t
+    uint8_t count;      // number of elements for an array
+    union {
+        int32_t i;      // INT and BOOL
+        float f;        // FLOAT
+        uint32_t offset;// ARRAY, of its int16_t elements from the start of the blob
+    } value;
+} hardware_blob_entry_t;
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t count;      // entries
+    uint16_t size;      // of the blob before the trailer
+    uint16_t crc;       // CRC16 (ELRS_CRC16_POLY) of the blob before the trailer
+    uint16_t unused;
+} hardware_blob_trailer_t;
+
+/**
+ * @brief FNV-1a of the name folded to 16 bits, so the field table can hold the keys at compile time
+ */
+constexpr uint32_t HardwareBlobFnv(const char *name, uint32_t hash = 0x811C9DC5)
+{
+    return *name ? HardwareBlobFnv(name + 1, (hash ^ (uint8_t)*name) * 0x01000193) : hash;
+}
+
+constexpr uint16_t HardwareBlobKey(const char *name)
+{
+    return (HardwareBlobFnv(name) >> 16) ^ (HardwareBlobFnv(name) & 0xFFFF);
+}
+
+/**
+ * @return true if the trailer is for a blob this firmware can read, of at most maxSize bytes
+ */
+bool HardwareBlobTrailerValid(const hardware_blob_trailer_t &trailer, uint16_t maxSize);
+
+/**
+ * @return true if the blob the trailer describes passes its CRC and everything in it is in bounds
+ */
+bool HardwareBlobValid(const uint8_t *blob, const hardware_blob_trailer_t &trailer);
+
+/**
+ * @return the entry for the key, or nullptr if the layout does not have it
+ */
+const hardware_blob_entry_t *HardwareBlobFind(const uint8_t *blob, const hardware_blob_trailer_t &trailer, uint16_t key);
+
+// The value of an entry as each type of field, converted as ArduinoJson does for the JSON
+int32_t HardwareBlobInt(const hardware_blob_entry_t *entry);
+float HardwareBlobFloat(const hardware_blob_entry_t *entry);
+const int16_t *HardwareBlobArray(const uint8_t *blob, const hardware_blob_entry_t *entry);
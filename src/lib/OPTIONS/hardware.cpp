@@ -9,6 +9,7 @@
 #include <SPIFFS.h>
 #endif
 #include <ArduinoJson.h>
+#include "HardwareBlob.h"
 
 typedef enum {
     INT,
@@ -18,10 +19,13 @@ typedef enum {
     COUNT
 } datatype_t;
 
-static const struct {
+static const struct field_t {
+    constexpr field_t(nameType position, const char *name, datatype_t type)
+        : position(position), name(name), type(type), key(HardwareBlobKey(name)) {}
     const nameType position;
     const char *name;
     const datatype_t type;
+    const uint16_t key;
 } fields[] = {
     {HARDWARE_serial_rx, "serial_rx", INT},
     {HARDWARE_serial_tx, "serial_tx", INT},
@@ -147,6 +151,12 @@ typedef union {
 
 static data_holder_t hardware[HARDWARE_LAST];
 static String builtinHardwareConfig;
+// The binary layout when it was used, which the arrays point into, read from the end of the hardware area
+static WORD_ALIGNED_ATTR uint8_t hardwareBlob[ELRSOPTS_HARDWARE_SIZE - sizeof(hardware_blob_trailer_t)];
+static bool hardwareBlobLoaded;
+static size_t hardwareFlashBase;
+
+constexpr size_t hardwareConfigOffset = ELRSOPTS_PRODUCTNAME_SIZE + ELRSOPTS_DEVICENAME_SIZE + ELRSOPTS_OPTIONS_SIZE;
 
 String& getHardware()
 {
@@ -157,7 +167,18 @@ String& getHardware()
         {
             file.close();
         }
-        // Try JSON at the end of the firmware
+        // Try JSON at the end of the firmware, which is not read at boot when the binary layout is used
+        if (hardwareBlobLoaded && builtinHardwareConfig.length() == 0)
+        {
+            EspFlashStream strmFlash;
+            strmFlash.setBaseAddress(hardwareFlashBase);
+            strmFlash.setPosition(hardwareConfigOffset);
+            JsonDocument doc;
+            if (!deserializeJson(doc, strmFlash))
+            {
+                serializeJson(doc, builtinHardwareConfig);
+            }
+        }
         return builtinHardwareConfig;
     }
     builtinHardwareConfig = file.readString();
@@ -219,6 +240,66 @@ static void hardware_LoadFieldsFromDoc(JsonDocument &doc)
     }
 }
 
+static void hardware_LoadFieldsFromBlob(const uint8_t *blob, const hardware_blob_trailer_t &trailer)
+{
+    for (size_t i=0 ; i<ARRAY_SIZE(fields) ; i++) {
+        const hardware_blob_entry_t *entry = HardwareBlobFind(blob, trailer, fields[i].key);
+        if (entry) {
+            switch (fields[i].type) {
+                case INT:
+                    hardware[fields[i].position].int_value = HardwareBlobInt(entry);
+                    break;
+                case BOOL:
+                    hardware[fields[i].position].bool_value = HardwareBlobInt(entry) != 0;
+                    break;
+                case FLOAT:
+                    hardware[fields[i].position].float_value = HardwareBlobFloat(entry);
+                    break;
+                case ARRAY:
+                    if (entry->type == HARDWARE_BLOB_ARRAY)
+                    {
+                        hardware[fields[i].position].array_value = const_cast<int16_t *>(HardwareBlobArray(blob, entry));
+                    }
+                    break;
+                case COUNT:
+                    hardware[fields[i].position].int_value = entry->count;
+                    break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Load the binary layout from the end of the hardware area, which is much quicker than
+ * parsing the JSON and needs no JSON document on the heap
+ * @return false if there is none this firmware can use
+ */
+static bool hardware_LoadFromBlob(EspFlashStream &strmFlash)
+{
+    constexpr size_t trailerOffset = hardwareConfigOffset + ELRSOPTS_HARDWARE_SIZE - sizeof(hardware_blob_trailer_t);
+    hardware_blob_trailer_t trailer;
+    hardwareBlobLoaded = false;
+    strmFlash.setPosition(trailerOffset);
+    strmFlash.readBytes((uint8_t *)&trailer, sizeof(trailer));
+    // Also bounds the size to the buffer
+    if (!HardwareBlobTrailerValid(trailer, sizeof(hardwareBlob)))
+    {
+        return false;
+    }
+
+    strmFlash.setPosition(trailerOffset - trailer.size);
+    strmFlash.readBytes(hardwareBlob, trailer.size);
+    if (!HardwareBlobValid(hardwareBlob, trailer))
+    {
+        return false;
+    }
+
+    hardware_LoadFieldsFromBlob(hardwareBlob, trailer);
+    hardwareBlobLoaded = true;
+    hardwareFlashBase = strmFlash.getBaseAddress();
+    return true;
+}
+
 bool hardware_init(EspFlashStream &strmFlash)
 {
     hardware_ClearAllFields();
@@ -228,7 +309,10 @@ bool hardware_init(EspFlashStream &strmFlash)
     JsonDocument doc;
     File file = SPIFFS.open("/hardware.json", "r");
     if (!file || file.isDirectory()) {
-        constexpr size_t hardwareConfigOffset = ELRSOPTS_PRODUCTNAME_SIZE + ELRSOPTS_DEVICENAME_SIZE + ELRSOPTS_OPTIONS_SIZE;
+        if (hardware_LoadFromBlob(strmFlash))
+        {
+            return true;
+        }
         strmFlash.setPosition(hardwareConfigOffset);
         if (!options_HasStringInFlash(strmFlash))
         {
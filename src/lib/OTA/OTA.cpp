@@ -13,6 +13,9 @@
 
 static_assert(sizeof(OTA_Packet4_s) == OTA4_PACKET_SIZE, "OTA4 packet stuct is invalid!");
 static_assert(sizeof(OTA_Packet8_s) == OTA8_PACKET_SIZE, "OTA8 packet stuct is invalid!");
+#if defined(USE_OTA8_RS)
+static_assert(sizeof(OTA_Packet8RS_s) == OTA8_RS_PACKET_SIZE, "OTA8 RS packet stuct is invalid!");
+#endif
 
 bool OtaIsFullRes;
 volatile uint8_t OtaNonce;
@@ -21,8 +24,25 @@ OtaSwitchMode_e OtaSwitchModeCurrent;
 
 // CRC
 static Crc2Byte ota_crc;
-ValidatePacketCrc_t OtaValidatePacketCrc;
-GeneratePacketCrc_t OtaGeneratePacketCrc;
+
+/**
+ * The serializers in use, one per (packet size, switch mode) combination. Each stage is a switch on
+ * this which calls the specialization for the mode directly, so it is inlined into the switch rather
+ * than called through a function pointer per stage per packet.
+ */
+typedef enum : uint8_t {
+    osStdWide,
+    osStdHybrid,
+    osFull8ch,      // the full res modes are in OtaSwitchMode_e order
+    osFull16ch,
+    osFull12ch,
+#if defined(USE_OTA8_RS)
+    osFullRs8ch,
+    osFullRs16ch,
+    osFullRs12ch,
+#endif
+} OtaSerializer_e;
+static OtaSerializer_e OtaSerializer;
 
 void OtaUpdateCrcInitFromUid()
 {
@@ -44,8 +64,6 @@ static inline uint8_t ICACHE_RAM_ATTR HybridWideNonceToSwitchIndex(uint8_t const
 
 #if TARGET_TX || defined(UNIT_TEST)
 
-// Current ChannelData generator function being used by TX
-PackChannelData_t OtaPackChannelData;
 #if defined(DEBUG_RCVR_LINKSTATS)
 static uint32_t packetCnt;
 #endif
@@ -53,13 +71,13 @@ static uint32_t packetCnt;
 /******** Decimate 11bit to 10bit functions ********/
 typedef uint32_t (*Decimate11to10_fn)(uint32_t ch11bit);
 
-static uint32_t ICACHE_RAM_ATTR Decimate11to10_Limit(uint32_t ch11bit)
+static inline uint32_t ICACHE_RAM_ATTR Decimate11to10_Limit(uint32_t ch11bit)
 {
     // Limit 10-bit result to the range CRSF_CHANNEL_VALUE_MIN/MAX
     return CRSF_to_UINT10(constrain(ch11bit, CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX));
 }
 
-static uint32_t ICACHE_RAM_ATTR Decimate11to10_Div2(uint32_t ch11bit)
+static inline uint32_t ICACHE_RAM_ATTR Decimate11to10_Div2(uint32_t ch11bit)
 {
     // Simple divide-by-2 to discard the bit
     return ch11bit >> 1;
@@ -70,33 +88,26 @@ static uint32_t ICACHE_RAM_ATTR Decimate11to10_Div2(uint32_t ch11bit)
  * @desc: Values are packed little-endianish such that bits A987654321 -> 87654321, 000000A9
  *        which is compatible with the 10-bit CRSF subset RC frame structure (0x17) in
  *        Betaflight, but depends on which decimate function is used if it is legacy or CRSFv3 10-bit
- *        destChannels4x10 must be zeroed before this call, the channels are ORed into it
+ *        All 5 bytes of destChannels4x10 are overwritten. The 4 channels are assembled in a
+ *        32-bit word plus the 8 high bits of the last channel, rather than bit-by-bit
+ *        The decimate function is a template parameter so it is inlined into each packer
  ***/
-static void ICACHE_RAM_ATTR PackUInt11ToChannels4x10(uint32_t const * const src, OTA_Channels_4x10 * const destChannels4x10, Decimate11to10_fn decimate)
+template <Decimate11to10_fn decimate>
+static inline void ICACHE_RAM_ATTR PackUInt11ToChannels4x10(uint32_t const * const src, OTA_Channels_4x10 * const destChannels4x10)
 {
-    const unsigned DEST_PRECISION = 10; // number of bits for each dest, must be <SRC
-    uint8_t *dest = (uint8_t *)destChannels4x10;
-    *dest = 0;
-    unsigned destShift = 0;
-    for (unsigned ch=0; ch<4; ++ch)
-    {
-        // Convert to DEST_PRECISION value
-        unsigned chVal = decimate(src[ch]);
-
-        // Put the low bits in any remaining dest capacity
-        *dest++ |= chVal << destShift;
-
-        // Shift the high bits down and place them into the next dest byte
-        unsigned srcBitsLeft = DEST_PRECISION - 8 + destShift;
-        *dest = chVal >> (DEST_PRECISION - srcBitsLeft);
-        // Next dest should be shifted up by the bits consumed
-        // if destShift == 8 then everything should reset for another set
-        // but this code only expects to do the 4 channels -> 5 bytes evenly
-        destShift = srcBitsLeft;
-    }
+    uint8_t * const dest = destChannels4x10->raw;
+    uint32_t const ch3 = decimate(src[3]);
+    uint32_t const lowWord = decimate(src[0]) | (decimate(src[1]) << 10) | (decimate(src[2]) << 20) | (ch3 << 30);
+
+    // Byte stores, the destination is not word aligned
+    dest[0] = lowWord;
+    dest[1] = lowWord >> 8;
+    dest[2] = lowWord >> 16;
+    dest[3] = lowWord >> 24;
+    dest[4] = ch3 >> 2;
 }
 
-static void ICACHE_RAM_ATTR PackChannelDataHybridCommon(OTA_Packet4_s * const ota4, const uint32_t *channelData)
+static inline void ICACHE_RAM_ATTR PackChannelDataHybridCommon(OTA_Packet4_s * const ota4, const uint32_t *channelData)
 {
     ota4->type = PACKET_TYPE_RCDATA;
 #if defined(DEBUG_RCVR_LINKSTATS)
@@ -105,7 +116,7 @@ static void ICACHE_RAM_ATTR PackChannelDataHybridCommon(OTA_Packet4_s * const ot
 #else
     // CRSF input is 11bit and OTA will carry only 10bit. Discard the Extended Limits (E.Limits)
     // range and use the full 10bits to carry only 998us - 2012us
-    PackUInt11ToChannels4x10(&channelData[0], &ota4->rc.ch, &Decimate11to10_Limit);
+    PackUInt11ToChannels4x10<Decimate11to10_Limit>(&channelData[0], &ota4->rc.ch);
     ota4->rc.ch4 = CRSF_to_BIT(channelData[4]);
 #endif /* !DEBUG_RCVR_LINKSTATS */
 }
@@ -126,7 +137,7 @@ static uint8_t Hybrid8NextSwitchIndex;
 #if defined(UNIT_TEST)
 void OtaSetHybrid8NextSwitchIndex(uint8_t idx) { Hybrid8NextSwitchIndex = idx; }
 #endif
-void ICACHE_RAM_ATTR GenerateChannelDataHybrid8(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData,
+static inline void ICACHE_RAM_ATTR GenerateChannelDataHybrid8(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData,
                                                 bool const TelemetryStatus, uint8_t const tlmDenom)
 {
     (void)tlmDenom;
@@ -182,7 +193,7 @@ static uint8_t ICACHE_RAM_ATTR HybridWideSwitchToOta(const uint32_t *channelData
  * Inputs: cchannelData, TelemetryStatus
  * Outputs: OTA_Packet4_s
  **/
-void ICACHE_RAM_ATTR GenerateChannelDataHybridWide(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData,
+static inline void ICACHE_RAM_ATTR GenerateChannelDataHybridWide(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData,
                                                    bool const TelemetryStatus, uint8_t const tlmDenom)
 {
     OTA_Packet4_s * const ota4 = &otaPktPtr->std;
@@ -211,7 +222,8 @@ void ICACHE_RAM_ATTR GenerateChannelDataHybridWide(OTA_Packet_s * const otaPktPt
     ota4->rc.switches = value;
 }
 
-static void ICACHE_RAM_ATTR GenerateChannelData8ch12ch(OTA_Packet8_s * const ota8, const uint32_t *channelData, bool const TelemetryStatus, bool const isHighAux)
+template <OtaSwitchMode_e switchMode>
+static inline void ICACHE_RAM_ATTR GenerateChannelData8ch12ch(OTA_Packet8_s * const ota8, const uint32_t *channelData, bool const TelemetryStatus, bool const isHighAux)
 {
     // All channel data is 10 bit apart from AUX1 which is 1 bit
     ota8->rc.packetType = PACKET_TYPE_RCDATA;
@@ -232,7 +244,7 @@ static void ICACHE_RAM_ATTR GenerateChannelData8ch12ch(OTA_Packet8_s * const ota
     // 16ch isHighAux=true:  low=8 high=12
     uint8_t chSrcLow;
     uint8_t chSrcHigh;
-    if (OtaSwitchModeCurrent == smHybridOr16ch)
+    if (switchMode == smHybridOr16ch)
     {
         // 16ch mode
         if (isHighAux)
@@ -251,30 +263,31 @@ static void ICACHE_RAM_ATTR GenerateChannelData8ch12ch(OTA_Packet8_s * const ota
         chSrcLow = 0;
         chSrcHigh = isHighAux ? 9 : 5;
     }
-    PackUInt11ToChannels4x10(&channelData[chSrcLow], &ota8->rc.chLow, &Decimate11to10_Div2);
-    PackUInt11ToChannels4x10(&channelData[chSrcHigh], &ota8->rc.chHigh, &Decimate11to10_Div2);
+    PackUInt11ToChannels4x10<Decimate11to10_Div2>(&channelData[chSrcLow], &ota8->rc.chLow);
+    PackUInt11ToChannels4x10<Decimate11to10_Div2>(&channelData[chSrcHigh], &ota8->rc.chHigh);
 #endif
 }
 
-static void ICACHE_RAM_ATTR GenerateChannelData8ch(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData, bool const TelemetryStatus, uint8_t const tlmDenom)
+static inline void ICACHE_RAM_ATTR GenerateChannelData8ch(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData, bool const TelemetryStatus, uint8_t const tlmDenom)
 {
     (void)tlmDenom;
 
-    GenerateChannelData8ch12ch((OTA_Packet8_s * const)otaPktPtr, channelData, TelemetryStatus, false);
+    GenerateChannelData8ch12ch<smWideOr8ch>((OTA_Packet8_s *)otaPktPtr, channelData, TelemetryStatus, false);
 }
 
 static bool FullResIsHighAux;
 #if defined(UNIT_TEST)
 void OtaSetFullResNextChannelSet(bool next) { FullResIsHighAux = next; }
 #endif
-static void ICACHE_RAM_ATTR GenerateChannelData12ch(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData, bool const TelemetryStatus, uint8_t const tlmDenom)
+template <OtaSwitchMode_e switchMode>
+static inline void ICACHE_RAM_ATTR GenerateChannelData12ch(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData, bool const TelemetryStatus, uint8_t const tlmDenom)
 {
     (void)tlmDenom;
 
     // Every time this function is called, the opposite high Aux channels are sent
     // This tries to ensure a fair split of high and low aux channels packets even
     // at 1:2 ratio and around sync packets
-    GenerateChannelData8ch12ch((OTA_Packet8_s * const)otaPktPtr, channelData, TelemetryStatus, FullResIsHighAux);
+    GenerateChannelData8ch12ch<switchMode>((OTA_Packet8_s *)otaPktPtr, channelData, TelemetryStatus, FullResIsHighAux);
     FullResIsHighAux = !FullResIsHighAux;
 }
 #endif
@@ -282,44 +295,30 @@ static void ICACHE_RAM_ATTR GenerateChannelData12ch(OTA_Packet_s * const otaPktP
 
 #if TARGET_RX || defined(UNIT_TEST)
 
-// Current ChannelData unpacker function being used by RX
-UnpackChannelData_t OtaUnpackChannelData;
-
 #if defined(DEBUG_RCVR_LINKSTATS)
 // Sequential PacketID from the TX
 uint32_t debugRcvrLinkstatsPacketId;
 #else
 
-static void UnpackChannels4x10ToUInt11(OTA_Channels_4x10 const * const srcChannels4x10, uint32_t * const dest)
+/***
+ * @brief: Unpack 4x 10 bit channel struct into 4x 11-bit channel array (10-bit value << 1)
+ * @desc: The first 30 bits are read as one 32-bit word, the last channel takes its high
+ *        8 bits from the fifth byte
+ ***/
+static inline void ICACHE_RAM_ATTR UnpackChannels4x10ToUInt11(OTA_Channels_4x10 const * const srcChannels4x10, uint32_t * const dest)
 {
-    uint8_t const * const payload = (uint8_t const * const)srcChannels4x10;
-    constexpr unsigned numOfChannels = 4;
-    constexpr unsigned srcBits = 10;
-    constexpr unsigned dstBits = 11;
-    constexpr unsigned inputChannelMask = (1 << srcBits) - 1;
-    constexpr unsigned precisionShift = dstBits - srcBits;
-
-    // code from BetaFlight rx/crsf.cpp / bitpacker_unpack
-    uint8_t bitsMerged = 0;
-    uint32_t readValue = 0;
-    unsigned readByteIndex = 0;
-    for (uint8_t n = 0; n < numOfChannels; n++)
-    {
-        while (bitsMerged < srcBits)
-        {
-            uint8_t readByte = payload[readByteIndex++];
-            readValue |= ((uint32_t) readByte) << bitsMerged;
-            bitsMerged += 8;
-        }
-        //printf("rv=%x(%x) bm=%u\n", readValue, (readValue & channelMask), bitsMerged);
-        dest[n] = (readValue & inputChannelMask) << precisionShift;
-        readValue >>= srcBits;
-        bitsMerged -= srcBits;
-    }
+    uint8_t const * const payload = srcChannels4x10->raw;
+    constexpr unsigned inputChannelMask = (1 << 10) - 1;
+
+    uint32_t const lowWord = payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t)payload[3] << 24);
+    dest[0] = (lowWord & inputChannelMask) << 1;
+    dest[1] = ((lowWord >> 10) & inputChannelMask) << 1;
+    dest[2] = ((lowWord >> 20) & inputChannelMask) << 1;
+    dest[3] = ((lowWord >> 30) | (payload[4] << 2)) << 1;
 }
 #endif /* !DEBUG_RCVR_LINKSTATS */
 
-static void ICACHE_RAM_ATTR UnpackChannelDataHybridCommon(OTA_Packet4_s const * const ota4, uint32_t *channelData)
+static inline void ICACHE_RAM_ATTR UnpackChannelDataHybridCommon(OTA_Packet4_s const * const ota4, uint32_t *channelData)
 {
 #if defined(DEBUG_RCVR_LINKSTATS)
     debugRcvrLinkstatsPacketId = ota4->dbg_linkstats.packetNum;
@@ -348,12 +347,12 @@ static void ICACHE_RAM_ATTR UnpackChannelDataHybridCommon(OTA_Packet4_s const *
  * Output: channelData
  * Returns: TelemetryStatus bit
  */
-bool ICACHE_RAM_ATTR UnpackChannelDataHybridSwitch8(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData,
+static inline bool ICACHE_RAM_ATTR UnpackChannelDataHybridSwitch8(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData,
                                                     uint8_t const tlmDenom)
 {
     (void)tlmDenom;
 
-    OTA_Packet4_s const * const ota4 = (OTA_Packet4_s const * const)otaPktPtr;
+    OTA_Packet4_s const * const ota4 = (OTA_Packet4_s const *)otaPktPtr;
     UnpackChannelDataHybridCommon(ota4, channelData);
 
     // The round-robin switch, switchIndex is actually index-1
@@ -388,12 +387,12 @@ bool ICACHE_RAM_ATTR UnpackChannelDataHybridSwitch8(OTA_Packet_s const * const o
  * Output: channelData
  * Returns: TelemetryStatus bit
  */
-bool ICACHE_RAM_ATTR UnpackChannelDataHybridWide(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData,
+static inline bool ICACHE_RAM_ATTR UnpackChannelDataHybridWide(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData,
                                                  uint8_t const tlmDenom)
 {
     static bool TelemetryStatus = false;
 
-    OTA_Packet4_s const * const ota4 = (OTA_Packet4_s const * const)otaPktPtr;
+    OTA_Packet4_s const * const ota4 = (OTA_Packet4_s const *)otaPktPtr;
     UnpackChannelDataHybridCommon(ota4, channelData);
 
     // The round-robin switch, 6-7 bits with the switch index implied by the nonce
@@ -427,18 +426,19 @@ bool ICACHE_RAM_ATTR UnpackChannelDataHybridWide(OTA_Packet_s const * const otaP
     return TelemetryStatus;
 }
 
-bool ICACHE_RAM_ATTR UnpackChannelData8ch(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData, uint8_t const tlmDenom)
+template <OtaSwitchMode_e switchMode>
+static inline bool ICACHE_RAM_ATTR UnpackChannelData8ch(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData, uint8_t const tlmDenom)
 {
     (void)tlmDenom;
 
-    OTA_Packet8_s const * const ota8 = (OTA_Packet8_s const * const)otaPktPtr;
+    OTA_Packet8_s const * const ota8 = (OTA_Packet8_s const *)otaPktPtr;
 
 #if defined(DEBUG_RCVR_LINKSTATS)
     debugRcvrLinkstatsPacketId = ota8->dbg_linkstats.packetNum;
 #else
     uint8_t chDstLow;
     uint8_t chDstHigh;
-    if (OtaSwitchModeCurrent == smHybridOr16ch)
+    if (switchMode == smHybridOr16ch)
     {
         if (ota8->rc.isHighAux)
         {
@@ -469,14 +469,15 @@ bool ICACHE_RAM_ATTR UnpackChannelData8ch(OTA_Packet_s const * const otaPktPtr,
 }
 #endif
 
-bool ICACHE_RAM_ATTR ValidatePacketCrcFull(OTA_Packet_s * const otaPktPtr)
+static inline bool ICACHE_RAM_ATTR ValidatePacketCrcFull(OTA_Packet_s * const otaPktPtr)
 {
     uint16_t const calculatedCRC =
         ota_crc.calc((uint8_t*)otaPktPtr, OTA8_CRC_CALC_LEN, OtaCrcInitializer);
     return otaPktPtr->full.crc == calculatedCRC;
 }
 
-bool ICACHE_RAM_ATTR ValidatePacketCrcStd(OTA_Packet_s * const otaPktPtr)
+template <OtaSwitchMode_e switchMode>
+static inline bool ICACHE_RAM_ATTR ValidatePacketCrcStd(OTA_Packet_s * const otaPktPtr)
 {
     uint8_t backupCrcHigh = otaPktPtr->std.crcHigh;
 
@@ -484,7 +485,7 @@ bool ICACHE_RAM_ATTR ValidatePacketCrcStd(OTA_Packet_s * const otaPktPtr)
     // For smHybrid the CRC only has the packet type in byte 0
     // For smWide the FHSS slot is added to the CRC in byte 0 on PACKET_TYPE_RCDATAs
 #if defined(TARGET_RX)
-    if (otaPktPtr->std.type == PACKET_TYPE_RCDATA && OtaSwitchModeCurrent == smWideOr8ch)
+    if (switchMode == smWideOr8ch && otaPktPtr->std.type == PACKET_TYPE_RCDATA)
     {
         otaPktPtr->std.crcHigh = (OtaNonce % ExpressLRS_currAirRate_Modparams->FHSShopInterval) + 1;
     }
@@ -501,16 +502,39 @@ bool ICACHE_RAM_ATTR ValidatePacketCrcStd(OTA_Packet_s * const otaPktPtr)
     return inCRC == calculatedCRC;
 }
 
-void ICACHE_RAM_ATTR GeneratePacketCrcFull(OTA_Packet_s * const otaPktPtr)
+static inline void ICACHE_RAM_ATTR GeneratePacketCrcFull(OTA_Packet_s * const otaPktPtr)
 {
     otaPktPtr->full.crc = ota_crc.calc((uint8_t*)otaPktPtr, OTA8_CRC_CALC_LEN, OtaCrcInitializer);
 }
 
-void ICACHE_RAM_ATTR GeneratePacketCrcStd(OTA_Packet_s * const otaPktPtr)
+#if defined(USE_OTA8_RS)
+/**
+ * OTA8 with Reed-Solomon parity. A packet which fails the CRC has up to RS_PARITY_LEN / 2
+ * corrupted bytes corrected in place, then the CRC is checked again. The CRC is checked first
+ * so a clean packet costs no more than plain OTA8.
+ */
+static inline bool ICACHE_RAM_ATTR ValidatePacketCrcFullRs(OTA_Packet_s * const otaPktPtr)
+{
+    if (ValidatePacketCrcFull(otaPktPtr))
+    {
+        return true;
+    }
+    return RSDecode((uint8_t *)otaPktPtr, OTA8_PACKET_SIZE) > 0 && ValidatePacketCrcFull(otaPktPtr);
+}
+
+static inline void ICACHE_RAM_ATTR GeneratePacketCrcFullRs(OTA_Packet_s * const otaPktPtr)
+{
+    GeneratePacketCrcFull(otaPktPtr);
+    RSEncode((uint8_t *)otaPktPtr, OTA8_PACKET_SIZE);
+}
+#endif
+
+template <OtaSwitchMode_e switchMode>
+static inline void ICACHE_RAM_ATTR GeneratePacketCrcStd(OTA_Packet_s * const otaPktPtr)
 {
 #if defined(TARGET_TX)
     // artificially inject the low bits of the nonce on data packets, this will be overwritten with the CRC after it's calculated
-    if (otaPktPtr->std.type == PACKET_TYPE_RCDATA && OtaSwitchModeCurrent == smWideOr8ch)
+    if (switchMode == smWideOr8ch && otaPktPtr->std.type == PACKET_TYPE_RCDATA)
     {
         otaPktPtr->std.crcHigh = (OtaNonce % ExpressLRS_currAirRate_Modparams->FHSShopInterval) + 1;
     }
@@ -520,52 +544,123 @@ void ICACHE_RAM_ATTR GeneratePacketCrcStd(OTA_Packet_s * const otaPktPtr)
     otaPktPtr->std.crcLow  = crc;
 }
 
+bool ICACHE_RAM_ATTR OtaValidatePacketCrc(OTA_Packet_s * const otaPktPtr)
+{
+    switch (OtaSerializer)
+    {
+    case osStdWide:
+        return ValidatePacketCrcStd<smWideOr8ch>(otaPktPtr);
+    case osStdHybrid:
+        return ValidatePacketCrcStd<smHybridOr16ch>(otaPktPtr);
+#if defined(USE_OTA8_RS)
+    case osFullRs8ch:
+    case osFullRs16ch:
+    case osFullRs12ch:
+        return ValidatePacketCrcFullRs(otaPktPtr);
+#endif
+    default:
+        return ValidatePacketCrcFull(otaPktPtr);
+    }
+}
+
+void ICACHE_RAM_ATTR OtaGeneratePacketCrc(OTA_Packet_s * const otaPktPtr)
+{
+    switch (OtaSerializer)
+    {
+    case osStdWide:
+        GeneratePacketCrcStd<smWideOr8ch>(otaPktPtr);
+        break;
+    case osStdHybrid:
+        GeneratePacketCrcStd<smHybridOr16ch>(otaPktPtr);
+        break;
+#if defined(USE_OTA8_RS)
+    case osFullRs8ch:
+    case osFullRs16ch:
+    case osFullRs12ch:
+        GeneratePacketCrcFullRs(otaPktPtr);
+        break;
+#endif
+    default:
+        GeneratePacketCrcFull(otaPktPtr);
+        break;
+    }
+}
+
+#if defined(TARGET_TX) || defined(UNIT_TEST)
+void ICACHE_RAM_ATTR OtaPackChannelData(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData, bool const TelemetryStatus, uint8_t const tlmDenom)
+{
+    switch (OtaSerializer)
+    {
+    case osStdWide:
+        GenerateChannelDataHybridWide(otaPktPtr, channelData, TelemetryStatus, tlmDenom);
+        break;
+    case osStdHybrid:
+        GenerateChannelDataHybrid8(otaPktPtr, channelData, TelemetryStatus, tlmDenom);
+        break;
+    case osFull16ch:
+#if defined(USE_OTA8_RS)
+    case osFullRs16ch:
+#endif
+        GenerateChannelData12ch<smHybridOr16ch>(otaPktPtr, channelData, TelemetryStatus, tlmDenom);
+        break;
+    case osFull12ch:
+#if defined(USE_OTA8_RS)
+    case osFullRs12ch:
+#endif
+        GenerateChannelData12ch<sm12ch>(otaPktPtr, channelData, TelemetryStatus, tlmDenom);
+        break;
+    default:
+        GenerateChannelData8ch(otaPktPtr, channelData, TelemetryStatus, tlmDenom);
+        break;
+    }
+}
+#endif
+
+#if defined(TARGET_RX) || defined(UNIT_TEST)
+bool ICACHE_RAM_ATTR OtaUnpackChannelData(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData, uint8_t const tlmDenom)
+{
+    switch (OtaSerializer)
+    {
+    case osStdWide:
+        return UnpackChannelDataHybridWide(otaPktPtr, channelData, tlmDenom);
+    case osStdHybrid:
+        return UnpackChannelDataHybridSwitch8(otaPktPtr, channelData, tlmDenom);
+    case osFull16ch:
+#if defined(USE_OTA8_RS)
+    case osFullRs16ch:
+#endif
+        return UnpackChannelData8ch<smHybridOr16ch>(otaPktPtr, channelData, tlmDenom);
+    default:
+        // 12ch unpacks the same as 8ch, using isHighAux to select the high channels
+        return UnpackChannelData8ch<smWideOr8ch>(otaPktPtr, channelData, tlmDenom);
+    }
+}
+#endif
+
 void OtaUpdateSerializers(OtaSwitchMode_e const switchMode, uint8_t packetSize)
 {
+#if defined(USE_OTA8_RS)
+    // The RS packet is an OTA8 packet with parity appended, it is full res like OTA8
+    OtaIsFullRes = (packetSize == OTA8_PACKET_SIZE || packetSize == OTA8_RS_PACKET_SIZE);
+#else
     OtaIsFullRes = (packetSize == OTA8_PACKET_SIZE);
+#endif
 
     if (OtaIsFullRes)
     {
-        OtaValidatePacketCrc = &ValidatePacketCrcFull;
-        OtaGeneratePacketCrc = &GeneratePacketCrcFull;
+        uint8_t const modeIdx = (switchMode < sm12ch) ? switchMode : sm12ch;
+        OtaSerializer = (OtaSerializer_e)(osFull8ch + modeIdx);
+#if defined(USE_OTA8_RS)
+        if (packetSize == OTA8_RS_PACKET_SIZE)
+            OtaSerializer = (OtaSerializer_e)(osFullRs8ch + modeIdx);
+#endif
         ota_crc.init(16, ELRS_CRC16_POLY);
-
-        #if defined(TARGET_TX) || defined(UNIT_TEST)
-        if (switchMode == smWideOr8ch)
-            OtaPackChannelData = &GenerateChannelData8ch;
-        else
-            OtaPackChannelData = &GenerateChannelData12ch;
-        #endif
-        #if defined(TARGET_RX) || defined(UNIT_TEST)
-        OtaUnpackChannelData = &UnpackChannelData8ch;
-        #endif
-    } // is8ch
-
+    }
     else
     {
-        OtaValidatePacketCrc = &ValidatePacketCrcStd;
-        OtaGeneratePacketCrc = &GeneratePacketCrcStd;
+        // sm12ch is not a valid std packet mode, fall back to Hybrid
+        OtaSerializer = (switchMode == smWideOr8ch) ? osStdWide : osStdHybrid;
         ota_crc.init(14, ELRS_CRC14_POLY);
-
-        if (switchMode == smWideOr8ch)
-        {
-            #if defined(TARGET_TX) || defined(UNIT_TEST)
-            OtaPackChannelData = &GenerateChannelDataHybridWide;
-            #endif
-            #if defined(TARGET_RX) || defined(UNIT_TEST)
-            OtaUnpackChannelData = &UnpackChannelDataHybridWide;
-            #endif
-        } // !is8ch and smWideOr8ch
-
-        else
-        {
-            #if defined(TARGET_TX) || defined(UNIT_TEST)
-            OtaPackChannelData = &GenerateChannelDataHybrid8;
-            #endif
-            #if defined(TARGET_RX) || defined(UNIT_TEST)
-            OtaUnpackChannelData = &UnpackChannelDataHybridSwitch8;
-            #endif
-        } // !is8ch and smHybridOr16ch
     }
 
     OtaSwitchModeCurrent = switchMode;
@@ -8,11 +8,19 @@
 #include "crsf_protocol.h"
 #include "telemetry_protocol.h"
 #include "FIFO.h"
+#if defined(USE_OTA8_RS)
+#include "ReedSolomon.h"
+#endif
 
 #define OTA4_PACKET_SIZE     8U
 #define OTA4_CRC_CALC_LEN    offsetof(OTA_Packet4_s, crcLow)
 #define OTA8_PACKET_SIZE     13U
 #define OTA8_CRC_CALC_LEN    offsetof(OTA_Packet8_s, crc)
+#if defined(USE_OTA8_RS)
+// OTA8 followed by Reed-Solomon parity, selected by an air rate with this PayloadLength.
+// LoRa only, FLRC checks its hardware CRC and drops a corrupted packet before it can be corrected
+#define OTA8_RS_PACKET_SIZE  (OTA8_PACKET_SIZE + RS_PARITY_LEN)
+#endif
 
 // Packet header types (ota.std.type)
 #define PACKET_TYPE_RCDATA  0b00
@@ -79,7 +87,7 @@ typedef struct {
             union {
                 struct {
                     OTA_LinkStats_s stats;
-                    uint8_t free;
+                    uint8_t mspSack; // MspReceiver.GetCurrentSack(), 0 from older firmware
                 } PACKED ul_link_stats;
                 uint8_t payload[ELRS4_TELEMETRY_BYTES_PER_CALL];
             };
@@ -151,10 +159,21 @@ typedef struct {
     uint16_t crc;  // crc16 LittleEndian
 } PACKED OTA_Packet8_s;
 
+#if defined(USE_OTA8_RS)
+typedef struct {
+    OTA_Packet8_s full;
+    // RSEncode() of the whole OTA8 packet, including the CRC
+    uint8_t parity[RS_PARITY_LEN];
+} PACKED OTA_Packet8RS_s;
+#endif
+
 typedef struct {
     union {
         OTA_Packet4_s std;
         OTA_Packet8_s full;
+#if defined(USE_OTA8_RS)
+        OTA_Packet8RS_s fullRs;
+#endif
     };
 } PACKED OTA_Packet_s;
 
@@ -168,18 +187,15 @@ void OtaUpdateSerializers(OtaSwitchMode_e const mode, uint8_t packetSize);
 extern OtaSwitchMode_e OtaSwitchModeCurrent;
 
 // CRC
-typedef bool (*ValidatePacketCrc_t)(OTA_Packet_s * const otaPktPtr);
-typedef void (*GeneratePacketCrc_t)(OTA_Packet_s * const otaPktPtr);
-extern ValidatePacketCrc_t OtaValidatePacketCrc;
-extern GeneratePacketCrc_t OtaGeneratePacketCrc;
+bool OtaValidatePacketCrc(OTA_Packet_s * const otaPktPtr);
+void OtaGeneratePacketCrc(OTA_Packet_s * const otaPktPtr);
 // Value is implicit leading 1, comment is Koopman formatting (implicit trailing 1) https://users.ece.cmu.edu/~koopman/crc/
 #define ELRS_CRC_POLY 0x07 // 0x83
 #define ELRS_CRC14_POLY 0x2E57 // 0x372b
 #define ELRS_CRC16_POLY 0x3D65 // 0x9eb2
 
 #if defined(TARGET_TX) || defined(UNIT_TEST)
-typedef void (*PackChannelData_t)(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData, bool TelemetryStatus, uint8_t tlmDenom);
-extern PackChannelData_t OtaPackChannelData;
+void OtaPackChannelData(OTA_Packet_s * const otaPktPtr, const uint32_t *channelData, bool TelemetryStatus, uint8_t tlmDenom);
 #if defined(UNIT_TEST)
 void OtaSetHybrid8NextSwitchIndex(uint8_t idx);
 void OtaSetFullResNextChannelSet(bool next);
@@ -187,8 +203,7 @@ void OtaSetFullResNextChannelSet(bool next);
 #endif
 
 #if defined(TARGET_RX) || defined(UNIT_TEST)
-typedef bool (*UnpackChannelData_t)(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData, uint8_t tlmDenom);
-extern UnpackChannelData_t OtaUnpackChannelData;
+bool OtaUnpackChannelData(OTA_Packet_s const * const otaPktPtr, uint32_t *channelData, uint8_t tlmDenom);
 #endif
 
 void OtaPackAirportData(OTA_Packet_s * const otaPktPtr, FIFO<AP_MAX_BUF_LEN> *inputBuffer);
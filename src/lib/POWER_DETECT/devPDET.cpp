@@ -96,6 +96,7 @@ device_t PDET_device = {
     .initialize = NULL,
     .start = start,
     .event = event,
-    .timeout = timeout
+    .timeout = timeout,
+    .events = EVENT_CONNECTION_CHANGED | EVENT_POWER_CHANGED
 };
 #endif
\ No newline at end of file
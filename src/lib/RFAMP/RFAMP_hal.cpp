@@ -1,6 +1,7 @@
 #ifndef UNIT_TEST
 
 #include "RFAMP_hal.h"
+#include "RadioPins.h"
 #include "logging.h"
 
 RFAMP_hal *RFAMP_hal::instance = NULL;
@@ -138,45 +139,45 @@ void ICACHE_RAM_ATTR RFAMP_hal::TXenable(SX12XX_Radio_Number_t radioNumber)
 #else
     if (!tx1_enabled && !tx2_enabled && !rx_enabled)
     {
-        if (GPIO_PIN_PA_ENABLE != UNDEF_PIN)
+        if (RadioPins.paEnable != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_PA_ENABLE, HIGH);
+            digitalWrite(RadioPins.paEnable, HIGH);
         }
     }
     if (rx_enabled)
     {
-        if (GPIO_PIN_RX_ENABLE != UNDEF_PIN)
+        if (RadioPins.rxEnable[0] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_RX_ENABLE, LOW);
+            digitalWrite(RadioPins.rxEnable[0], LOW);
         }
-        if (GPIO_PIN_RX_ENABLE_2 != UNDEF_PIN)
+        if (RadioPins.rxEnable[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_RX_ENABLE_2, LOW);
+            digitalWrite(RadioPins.rxEnable[1], LOW);
         }
         rx_enabled = false;
     }
     if (radioNumber == SX12XX_Radio_1 && !tx1_enabled)
     {
-        if (GPIO_PIN_TX_ENABLE != UNDEF_PIN)
+        if (RadioPins.txEnable[0] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE, HIGH);
+            digitalWrite(RadioPins.txEnable[0], HIGH);
         }
-        if (GPIO_PIN_TX_ENABLE_2 != UNDEF_PIN)
+        if (RadioPins.txEnable[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE_2, LOW);
+            digitalWrite(RadioPins.txEnable[1], LOW);
         }
         tx1_enabled = true;
         tx2_enabled = false;
     }
     if (radioNumber == SX12XX_Radio_2 && !tx2_enabled)
     {
-        if (GPIO_PIN_TX_ENABLE != UNDEF_PIN)
+        if (RadioPins.txEnable[0] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE, LOW);
+            digitalWrite(RadioPins.txEnable[0], LOW);
         }
-        if (GPIO_PIN_TX_ENABLE_2 != UNDEF_PIN)
+        if (RadioPins.txEnable[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE_2, HIGH);
+            digitalWrite(RadioPins.txEnable[1], HIGH);
         }
         tx1_enabled = false;
         tx2_enabled = true;
@@ -198,28 +199,28 @@ void ICACHE_RAM_ATTR RFAMP_hal::RXenable()
 #else
     if (!rx_enabled)
     {
-        if (!tx1_enabled && !tx2_enabled && GPIO_PIN_PA_ENABLE != UNDEF_PIN)
-            digitalWrite(GPIO_PIN_PA_ENABLE, HIGH);
+        if (!tx1_enabled && !tx2_enabled && RadioPins.paEnable != UNDEF_PIN)
+            digitalWrite(RadioPins.paEnable, HIGH);
 
-        if (tx1_enabled && GPIO_PIN_TX_ENABLE != UNDEF_PIN)
+        if (tx1_enabled && RadioPins.txEnable[0] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE, LOW);
+            digitalWrite(RadioPins.txEnable[0], LOW);
             tx1_enabled = false;
         }
 
-        if (tx2_enabled && GPIO_PIN_TX_ENABLE_2 != UNDEF_PIN)
+        if (tx2_enabled && RadioPins.txEnable[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE_2, LOW);
+            digitalWrite(RadioPins.txEnable[1], LOW);
             tx2_enabled = false;
         }
 
-        if (GPIO_PIN_RX_ENABLE != UNDEF_PIN)
+        if (RadioPins.rxEnable[0] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_RX_ENABLE, HIGH);
+            digitalWrite(RadioPins.rxEnable[0], HIGH);
         }
-        if (GPIO_PIN_RX_ENABLE_2 != UNDEF_PIN)
+        if (RadioPins.rxEnable[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_RX_ENABLE_2, HIGH);
+            digitalWrite(RadioPins.rxEnable[1], HIGH);
         }
 
         rx_enabled = true;
@@ -237,37 +238,37 @@ void ICACHE_RAM_ATTR RFAMP_hal::TXRXdisable()
 #else
     if (rx_enabled)
     {
-        if (GPIO_PIN_RX_ENABLE != UNDEF_PIN)
+        if (RadioPins.rxEnable[0] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_RX_ENABLE, LOW);
+            digitalWrite(RadioPins.rxEnable[0], LOW);
         }
-        if (GPIO_PIN_RX_ENABLE_2 != UNDEF_PIN)
+        if (RadioPins.rxEnable[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_RX_ENABLE_2, LOW);
+            digitalWrite(RadioPins.rxEnable[1], LOW);
         }
         rx_enabled = false;
     }
     if (tx1_enabled)
     {
-        if (GPIO_PIN_PA_ENABLE != UNDEF_PIN)
+        if (RadioPins.paEnable != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_PA_ENABLE, LOW);
+            digitalWrite(RadioPins.paEnable, LOW);
         }
-        if (GPIO_PIN_TX_ENABLE != UNDEF_PIN)
+        if (RadioPins.txEnable[0] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE, LOW);
+            digitalWrite(RadioPins.txEnable[0], LOW);
         }
         tx1_enabled = false;
     }
     if (tx2_enabled)
     {
-        if (GPIO_PIN_PA_ENABLE != UNDEF_PIN)
+        if (RadioPins.paEnable != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_PA_ENABLE, LOW);
+            digitalWrite(RadioPins.paEnable, LOW);
         }
-        if (GPIO_PIN_TX_ENABLE_2 != UNDEF_PIN)
+        if (RadioPins.txEnable[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_TX_ENABLE_2, LOW);
+            digitalWrite(RadioPins.txEnable[1], LOW);
         }
         tx2_enabled = false;
     }
@@ -0,0 +1,69 @@
+#include "RxSerialEncoders.h"
+#include "CRSF.h"
+
+void SbusEncodeFrame(uint8_t *frame, const uint32_t *channelData, bool djiRsPro, uint8_t flags)
+{
+    frame[0] = 0x0F; // HEADER
+    crsf_channels_t * const channels = (crsf_channels_t *)&frame[1];
+    if (djiRsPro)
+    {
+        const uint32_t djiChannels[16] = {
+            CRSF_map(channelData[0], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[1], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[2], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[3], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[5], CRSF_MAP_DJI_RS_PRO),      // Record start/stop and photo
+            CRSF_map(channelData[6], CRSF_MAP_DJI_RS_PRO),      // Mode
+            CRSF_map(channelData[7], CRSF_MAP_DJI_RS_PRO_HALF), // Recenter and Selfie
+            CRSF_map(channelData[8], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[9], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[10], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[11], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[12], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[13], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[14], CRSF_MAP_DJI_RS_PRO),
+            CRSF_map(channelData[15], CRSF_MAP_DJI_RS_PRO),
+            channelData[4] < CRSF_CHANNEL_VALUE_MID ? 352U : 1696U,
+        };
+        CRSF::PackChannels(djiChannels, channels);
+    }
+    else
+    {
+        CRSF::PackChannels(channelData, channels);
+    }
+    frame[1 + sizeof(crsf_channels_t)] = flags; // ch 17, 18, lost packet, failsafe
+    frame[2 + sizeof(crsf_channels_t)] = 0x00;  // FOOTER
+}
+
+// Channel 8 is sent as 5 to move the arm channel away from the aileron function, and 5 as 8
+static const uint8_t sumdChannelOrder[16] = {0, 1, 2, 3, 7, 5, 6, 4, 8, 9, 10, 11, 12, 13, 14, 15};
+
+SumdEncoder::SumdEncoder()
+{
+    crc2Byte.init(16, 0x1021);
+    uint8_t header[SUMD_HEADER_SIZE] = {
+        0xA8,   // Graupner
+        0x01,   // SUMD
+        0x10    // 16CH
+    };
+    headerCrc = crc2Byte.calc(header, sizeof(header), 0);
+}
+
+void SumdEncoder::encodeFrame(uint8_t *frame, const uint32_t *channelData)
+{
+    frame[0] = 0xA8;
+    frame[1] = 0x01;
+    frame[2] = 0x10;
+
+    uint8_t *data = &frame[SUMD_HEADER_SIZE];
+    for (uint8_t ch = 0; ch < 16; ++ch)
+    {
+        const uint16_t us = CRSF_to_US(channelData[sumdChannelOrder[ch]]) << 3;
+        *data++ = us >> 8;
+        *data++ = us;
+    }
+
+    const uint16_t crc = crc2Byte.calc(&frame[SUMD_HEADER_SIZE], SUMD_DATA_SIZE_16CH, headerCrc);
+    frame[SUMD_HEADER_SIZE + SUMD_DATA_SIZE_16CH] = crc >> 8;
+    frame[SUMD_HEADER_SIZE + SUMD_DATA_SIZE_16CH + 1] = crc;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include "crc.h"
+
+#define SBUS_FRAME_LEN              25
+#define SBUS_FLAG_SIGNAL_LOSS       (1 << 2)
+#define SBUS_FLAG_FAILSAFE_ACTIVE   (1 << 3)
+
+#define SUMD_HEADER_SIZE            3       // 3 Bytes header
+#define SUMD_DATA_SIZE_16CH         (16*2)  // 2 Bytes per channel
+#define SUMD_CRC_SIZE               2       // 16 bit CRC
+#define SUMD_FRAME_16CH_LEN         (SUMD_HEADER_SIZE+SUMD_DATA_SIZE_16CH+SUMD_CRC_SIZE)
+
+/**
+ * @brief Build a whole SBUS frame, SBUS uses the CRSF channel values unchanged
+ *
+ * @param djiRsPro remap the channels to the order and ranges the DJI RS Pro gimbals expect
+ * @param flags the byte after the channels, SBUS_FLAG_*
+ */
+void SbusEncodeFrame(uint8_t *frame, const uint32_t *channelData, bool djiRsPro, uint8_t flags);
+
+/**
+ * @brief Builds SUMD frames, keeping the CRC of the constant header so only the channels are
+ * added to it for each frame
+ */
+class SumdEncoder
+{
+public:
+    SumdEncoder();
+    void encodeFrame(uint8_t *frame, const uint32_t *channelData);
+
+private:
+    Crc2Byte crc2Byte;
+    uint16_t headerCrc;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Decides when a receiver serial protocol sends its RC frames, so they follow the RF packets
+ *
+ * Sending from a free running timer beats against the air rate, and the channels in a frame can be
+ * up to a whole output period old. Instead a frame is sent as soon as new channels arrive, and
+ * arrivals too close to the previous frame are skipped. So a frame goes out on every Nth packet,
+ * where N packet intervals is nearest the target period, and never sooner than the protocol's
+ * minimum gap (the frame's time on the wire plus the idle time the FC needs between frames).
+ *
+ * If no packets arrive, e.g. in failsafe, the last channels are repeated by the keepalive.
+ * All times are in microseconds and may wrap.
+ */
+class RxSerialScheduler
+{
+public:
+    /**
+     * @brief The time `bytes` take to send at `baud`
+     * @param bitsPerByte including the start, parity and stop bits
+     */
+    static constexpr uint32_t wireTimeUs(uint32_t baud, uint8_t bitsPerByte, uint8_t bytes)
+    {
+        return ((uint32_t)bytes * bitsPerByte * 1000000U + baud - 1) / baud;
+    }
+
+    /**
+     * @param minGapUs the shortest time allowed from the start of one frame to the start of the next
+     * @param periodUs the time between frames to aim for, raised to minGapUs if shorter
+     */
+    void configure(uint32_t minGapUs, uint32_t periodUs)
+    {
+        this->minGapUs = minGapUs;
+        this->periodUs = periodUs < minGapUs ? minGapUs : periodUs;
+    }
+
+    uint32_t getPeriodUs() const { return periodUs; }
+
+    /**
+     * @brief New channels, or a missed packet, have just been delivered
+     * @param packetIntervalUs the time between deliveries at the current air rate
+     * @return true if a frame should be sent now
+     */
+    bool packetArrived(uint32_t nowUs, uint32_t packetIntervalUs) const
+    {
+        if (!started)
+        {
+            return true;
+        }
+        // Compared half a packet early, so the small jitter in the arrivals does not skip one more
+        const uint32_t elapsed = nowUs - lastSentUs;
+        return elapsed >= minGapUs && elapsed + packetIntervalUs / 2 >= targetUs(packetIntervalUs);
+    }
+
+    /**
+     * @return true if nothing has been sent for long enough that the last channels should be repeated.
+     * This is never before the next packet was expected, so it does not steal its slot.
+     */
+    bool keepaliveDue(uint32_t nowUs, uint32_t packetIntervalUs) const
+    {
+        const uint32_t keepaliveUs = periodUs > 2 * packetIntervalUs ? periodUs : 2 * packetIntervalUs;
+        return !started || nowUs - lastSentUs >= keepaliveUs;
+    }
+
+    void frameSent(uint32_t nowUs)
+    {
+        lastSentUs = nowUs;
+        started = true;
+    }
+
+    /**
+     * @return milliseconds after a frame during which no other can be sent, so the caller does not
+     * need to poll for them. Rounded down, so it never delays the next frame.
+     */
+    uint32_t holdoffMs() const
+    {
+        return minGapUs < 2000 ? 0 : minGapUs / 1000 - 1;
+    }
+
+private:
+    /**
+     * @brief The whole number of packet intervals nearest the period, rounding ties down,
+     * and at least the minimum gap
+     */
+    uint32_t targetUs(uint32_t packetIntervalUs) const
+    {
+        if (packetIntervalUs == 0)
+        {
+            return periodUs;
+        }
+        uint32_t packets = (periodUs + (packetIntervalUs - 1) / 2) / packetIntervalUs;
+        if (packets * packetIntervalUs < minGapUs)
+        {
+            packets = (minGapUs + packetIntervalUs - 1) / packetIntervalUs;
+        }
+        return packets * packetIntervalUs;
+    }
+
+    uint32_t minGapUs = 0;
+    uint32_t periodUs = 0;
+    uint32_t lastSentUs = 0;
+    bool started = false;
+};
@@ -49,7 +49,8 @@ const char *rate_string[] = {
     "250Hz",
     "150Hz",
     "100 Full",
-    "50Hz"
+    "50Hz",
+    "250 Full RS"
 };
 #elif defined(RADIO_LR1121)
 static const char *rate_string[] = {
@@ -1,6 +1,7 @@
 #include "SX127x.h"
 #include "logging.h"
 #include "RFAMP_hal.h"
+#include "RadioPins.h"
 
 SX127xHal hal;
 SX127xDriver *SX127xDriver::instance = NULL;
@@ -77,7 +78,7 @@ bool SX127xDriver::Begin(uint32_t minimumFrequency, uint32_t maximumFrequency)
     return false;
   }
 
-  if (GPIO_PIN_NSS_2 != UNDEF_PIN)
+  if (RadioPins.hasSecondRadio)
   {
     if (!DetectChip(SX12XX_Radio_2))
     {
@@ -519,7 +520,7 @@ void ICACHE_RAM_ATTR SX127xDriver::GetLastPacketStats()
 
   // if it's a dual radio, and if it's the first IRQ
   // (don't need this if it's the second IRQ, because we know the first IRQ is already failed)
-  if (instance->isFirstRxIrq && GPIO_PIN_NSS_2 != UNDEF_PIN)
+  if (instance->isFirstRxIrq && RadioPins.hasSecondRadio)
   {
     bool isSecondRadioGotData = false;
     uint16_t secondIrqStatus = instance->GetIrqFlags(radio[secondRadioIdx]);
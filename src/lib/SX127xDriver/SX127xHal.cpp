@@ -2,6 +2,7 @@
 
 #include "SX127xHal.h"
 #include "SX127xRegs.h"
+#include "RadioPins.h"
 #include "logging.h"
 #include <SPIEx.h>
 
@@ -27,6 +28,7 @@ void SX127xHal::end()
 void SX127xHal::init()
 {
     DBGLN("Hal Init");
+    RadioPinsInit();
 
     pinMode(GPIO_PIN_DIO0, INPUT);
     if (GPIO_PIN_DIO0_2 != UNDEF_PIN)
@@ -122,7 +124,7 @@ void ICACHE_RAM_ATTR SX127xHal::writeRegisterBits(uint8_t reg, uint8_t value, ui
         writeRegister(reg, newValue, SX12XX_Radio_1);
     }
 
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN && radioNumber & SX12XX_Radio_2)
+    if (RadioPins.hasSecondRadio && radioNumber & SX12XX_Radio_2)
     {
         uint8_t currentValue = readRegister(reg, SX12XX_Radio_2);
         uint8_t newValue = (currentValue & ~mask) | (value & mask);
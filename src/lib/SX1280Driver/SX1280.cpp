@@ -101,7 +101,7 @@ bool SX1280Driver::Begin(uint32_t minimumFrequency, uint32_t maximumFrequency)
 
     hal.WriteRegister(0x0891, (hal.ReadRegister(0x0891, SX12XX_Radio_1) | 0xC0), SX12XX_Radio_1);   //default is low power mode, switch to high sensitivity instead
 
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN)
+    if (RadioPins.hasSecondRadio)
     {
         firmwareRev = (((hal.ReadRegister(REG_LR_FIRMWARE_VERSION_MSB, SX12XX_Radio_2)) << 8) | (hal.ReadRegister(REG_LR_FIRMWARE_VERSION_MSB + 1, SX12XX_Radio_2)));
         DBGLN("Read Vers sx1280 #2: %d", firmwareRev);
@@ -124,7 +124,7 @@ When SX1280_RADIO_SET_AUTOFS is set and tlm received by only 1 of the 2 radios,
 into Standby mode.  After the following SPI command for tx mode, busy will go high for differing periods of time because 1 is
 transitioning from FS mode and the other from Standby mode. This causes the tx done dio of the 2 radios to occur at very different times.
 */
-    if (GPIO_PIN_NSS_2 == UNDEF_PIN)
+    if (!RadioPins.hasSecondRadio)
     {
         fallBackMode = SX1280_MODE_FS;
         hal.WriteCommand(SX1280_RADIO_SET_AUTOFS, 0x01, SX12XX_Radio_All); //Enable auto FS
@@ -238,30 +238,42 @@ void SX1280Driver::SetMode(SX1280_RadioOperatingModes_t OPmode, SX12XX_Radio_Num
     //    return;
     // }
 
+    SX1280CommandQueue queue;
+    QueueMode(queue, OPmode, radioNumber, incomingTimeout);
+    queue.execute(hal);
+}
+
+void ICACHE_RAM_ATTR SX1280Driver::QueueMode(SX1280CommandQueue &queue, SX1280_RadioOperatingModes_t OPmode, SX12XX_Radio_Number_t radioNumber, uint32_t incomingTimeout)
+{
     WORD_ALIGNED_ATTR uint8_t buf[3];
     uint16_t tempTimeout;
+    bool queued = true;
 
     switch (OPmode)
     {
 
     case SX1280_MODE_SLEEP:
-        hal.WriteCommand(SX1280_RADIO_SET_SLEEP, (uint8_t)0x01, radioNumber);
+        buf[0] = 0x01;
+        queued = queue.add(radioNumber, SX1280_RADIO_SET_SLEEP, buf, 1);
         break;
 
     case SX1280_MODE_CALIBRATION:
         break;
 
     case SX1280_MODE_STDBY_RC:
-        hal.WriteCommand(SX1280_RADIO_SET_STANDBY, SX1280_STDBY_RC, radioNumber, 1500);
+        buf[0] = SX1280_STDBY_RC;
+        queued = queue.add(radioNumber, SX1280_RADIO_SET_STANDBY, buf, 1, 1500);
         break;
 
     // The DC-DC supply regulation is automatically powered in STDBY_XOSC mode.
     case SX1280_MODE_STDBY_XOSC:
-        hal.WriteCommand(SX1280_RADIO_SET_STANDBY, SX1280_STDBY_XOSC, radioNumber, 50);
+        buf[0] = SX1280_STDBY_XOSC;
+        queued = queue.add(radioNumber, SX1280_RADIO_SET_STANDBY, buf, 1, 50);
         break;
 
     case SX1280_MODE_FS:
-        hal.WriteCommand(SX1280_RADIO_SET_FS, (uint8_t)0x00, radioNumber, 70);
+        buf[0] = 0x00;
+        queued = queue.add(radioNumber, SX1280_RADIO_SET_FS, buf, 1, 70);
         break;
 
     case SX1280_MODE_RX:
@@ -269,14 +281,14 @@ void SX1280Driver::SetMode(SX1280_RadioOperatingModes_t OPmode, SX12XX_Radio_Num
         buf[0] = RX_TIMEOUT_PERIOD_BASE;
         buf[1] = tempTimeout >> 8;
         buf[2] = tempTimeout & 0xFF;
-        hal.WriteCommand(SX1280_RADIO_SET_RX, buf, sizeof(buf), radioNumber, 100);
+        queued = queue.add(radioNumber, SX1280_RADIO_SET_RX, buf, sizeof(buf), 100);
         break;
 
     case SX1280_MODE_RX_CONT:
         buf[0] = RX_TIMEOUT_PERIOD_BASE;
         buf[1] = 0xFFFF >> 8;
         buf[2] = 0xFFFF & 0xFF;
-        hal.WriteCommand(SX1280_RADIO_SET_RX, buf, sizeof(buf), radioNumber, 100);
+        queued = queue.add(radioNumber, SX1280_RADIO_SET_RX, buf, sizeof(buf), 100);
         break;
 
     case SX1280_MODE_TX:
@@ -284,7 +296,7 @@ void SX1280Driver::SetMode(SX1280_RadioOperatingModes_t OPmode, SX12XX_Radio_Num
         buf[0] = RX_TIMEOUT_PERIOD_BASE;
         buf[1] = 0xFF; // no timeout set for now
         buf[2] = 0xFF; // TODO dynamic timeout based on expected onairtime
-        hal.WriteCommand(SX1280_RADIO_SET_TX, buf, sizeof(buf), radioNumber, 100);
+        queued = queue.add(radioNumber, SX1280_RADIO_SET_TX, buf, sizeof(buf), 100);
         break;
 
     case SX1280_MODE_CAD:
@@ -294,7 +306,11 @@ void SX1280Driver::SetMode(SX1280_RadioOperatingModes_t OPmode, SX12XX_Radio_Num
         break;
     }
 
-    currOpmode = OPmode;
+    // The plan is sized for the worst case (see SX1280CommandQueue), so this is only a guard
+    if (queued)
+    {
+        currOpmode = OPmode;
+    }
 }
 
 void SX1280Driver::ConfigModParamsLoRa(uint8_t bw, uint8_t sf, uint8_t cr)
@@ -509,23 +525,34 @@ void ICACHE_RAM_ATTR SX1280Driver::TXnb(uint8_t * data, uint8_t size, SX12XX_Rad
     }
 #endif
 
+    // The whole TX is sent as one plan so the radios are only waited on where needed
+    SX1280CommandQueue queue;
+
     // Normal diversity mode
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN && radioNumber != SX12XX_Radio_All)
+    if (RadioPins.hasSecondRadio && radioNumber != SX12XX_Radio_All)
     {
         // Make sure the unused radio is in FS mode and will not receive the tx packet.
         if (radioNumber == SX12XX_Radio_1)
         {
-            instance->SetMode(fallBackMode, SX12XX_Radio_2);
+            instance->QueueMode(queue, fallBackMode, SX12XX_Radio_2);
         }
         else
         {
-            instance->SetMode(fallBackMode, SX12XX_Radio_1);
+            instance->QueueMode(queue, fallBackMode, SX12XX_Radio_1);
         }
     }
 
     RFAMP.TXenable(radioNumber); // do first to allow PA stablise
-    hal.WriteBuffer(0x00, data, size, radioNumber); //todo fix offset to equal fifo addr
-    instance->SetMode(SX1280_MODE_TX, radioNumber);
+    uint8_t *buf = queue.add(radioNumber, size + 2);
+    if (buf == nullptr)
+    {
+        return;
+    }
+    buf[0] = SX1280_RADIO_WRITE_BUFFER;
+    buf[1] = 0x00; //todo fix offset to equal fifo addr
+    memcpy(buf + 2, data, size);
+    instance->QueueMode(queue, SX1280_MODE_TX, radioNumber);
+    queue.execute(hal);
 
 #ifdef DEBUG_SX1280_OTA_TIMING
     beginTX = micros();
@@ -543,21 +570,54 @@ bool ICACHE_RAM_ATTR SX1280Driver::RXnbISR(uint16_t irqStatus, SX12XX_Radio_Numb
         currOpmode = SX1280_MODE_FS;
     }
 
-    rx_status fail = SX12XX_RX_OK;
+    // Only the first IRQ in a packet period checks the other radio, on the second the first has already failed
+    return diversity.receive(*this, irqStatus, radioNumber, isFirstRxIrq && RadioPins.hasSecondRadio);
+}
+
+SX12xxDriverCommon::rx_status ICACHE_RAM_ATTR SX1280Driver::GetRxStatus(uint16_t irqStatus)
+{
+    if (!(irqStatus & SX1280_IRQ_RX_DONE))
+    {
+        return SX12XX_RX_TIMEOUT;
+    }
     // The SYNCWORD_VALID bit isn't set on LoRa, it has no synch (sic) word, and CRC is only on for FLRC
     if (packet_mode == SX1280_PACKET_TYPE_FLRC)
     {
-        fail = ((irqStatus & SX1280_IRQ_CRC_ERROR) ? SX12XX_RX_CRC_FAIL : SX12XX_RX_OK) |
+        return ((irqStatus & SX1280_IRQ_CRC_ERROR) ? SX12XX_RX_CRC_FAIL : SX12XX_RX_OK) |
                ((irqStatus & SX1280_IRQ_SYNCWORD_VALID) ? SX12XX_RX_OK : SX12XX_RX_SYNCWORD_ERROR) |
                ((irqStatus & SX1280_IRQ_SYNCWORD_ERROR) ? SX12XX_RX_SYNCWORD_ERROR : SX12XX_RX_OK);
     }
-    if (fail == SX12XX_RX_OK)
+    return SX12XX_RX_OK;
+}
+
+void ICACHE_RAM_ATTR SX1280Driver::GetPacketStats(SX12XX_Radio_Number_t radioNumber, int8_t *rssi, int8_t *snr)
+{
+    WORD_ALIGNED_ATTR uint8_t status[2];
+    hal.ReadCommand(SX1280_RADIO_GET_PACKETSTATUS, status, 2, radioNumber);
+
+    if (packet_mode == SX1280_PACKET_TYPE_FLRC)
     {
-        uint8_t const FIFOaddr = GetRxBufferAddr(radioNumber);
-        hal.ReadBuffer(FIFOaddr, RXdataBuffer, PayloadLength, radioNumber);
+        // No SNR in FLRC mode
+        *rssi = -(int8_t)(status[1] / 2);
+        *snr = 0;
     }
+    else
+    {
+        // LoRa mode has both RSSI and SNR
+        *rssi = -(int8_t)(status[0] / 2);
+        *snr = (int8_t)status[1];
+
+        // https://www.mouser.com/datasheet/2/761/DS_SX1280-1_V2.2-1511144.pdf p84
+        // need to subtract SNR from RSSI when SNR <= 0;
+        int8_t negOffset = (*snr < 0) ? (*snr / RADIO_SNR_SCALE) : 0;
+        *rssi += negOffset;
+    }
+}
 
-    return RXdoneCallback(fail);
+void ICACHE_RAM_ATTR SX1280Driver::ReadPayload(SX12XX_Radio_Number_t radioNumber)
+{
+    uint8_t const FIFOaddr = GetRxBufferAddr(radioNumber);
+    hal.ReadBuffer(FIFOaddr, RXdataBuffer, PayloadLength, radioNumber);
 }
 
 void ICACHE_RAM_ATTR SX1280Driver::RXnb(SX1280_RadioOperatingModes_t rxMode, uint32_t incomingTimeout)
@@ -601,82 +661,15 @@ int8_t ICACHE_RAM_ATTR SX1280Driver::GetRssiInst(SX12XX_Radio_Number_t radioNumb
 
 void ICACHE_RAM_ATTR SX1280Driver::GetLastPacketStats()
 {
-    SX12XX_Radio_Number_t radio[2] = {SX12XX_Radio_1, SX12XX_Radio_2};
-    bool gotRadio[2] = {false, false}; // one-radio default.
-    uint8_t processingRadioIdx = (instance->processingPacketRadio == SX12XX_Radio_1) ? 0 : 1;
-    uint8_t secondRadioIdx = !processingRadioIdx;
-
-    // processingRadio always passed the sanity check here
-    gotRadio[processingRadioIdx] = true;
-
-    // if it's a dual radio, and if it's the first IRQ
-    // (don't need this if it's the second IRQ, because we know the first IRQ is already failed)
-    if (instance->isFirstRxIrq && GPIO_PIN_NSS_2 != UNDEF_PIN)
-    {
-        bool isSecondRadioGotData = false;
+    // The packet status of each radio which got the packet was read in the RX ISR
+    const bool * const gotRadio = instance->diversity.gotRadio;
+    const int8_t * const rssi = instance->diversity.rssi;
+    const int8_t * const snr = instance->diversity.snr;
 
-        uint16_t secondIrqStatus = instance->GetIrqStatus(radio[secondRadioIdx]);
-        if(secondIrqStatus&SX1280_IRQ_RX_DONE)
-        {
-            rx_status second_rx_fail = SX12XX_RX_OK;
-            if (packet_mode == SX1280_PACKET_TYPE_FLRC)
-            {
-               second_rx_fail = ((secondIrqStatus & SX1280_IRQ_CRC_ERROR) ? SX12XX_RX_CRC_FAIL : SX12XX_RX_OK) |
-                                ((secondIrqStatus & SX1280_IRQ_SYNCWORD_VALID) ? SX12XX_RX_OK : SX12XX_RX_SYNCWORD_ERROR) |
-                                ((secondIrqStatus & SX1280_IRQ_SYNCWORD_ERROR) ? SX12XX_RX_SYNCWORD_ERROR : SX12XX_RX_OK);
-            }
-            if (second_rx_fail == SX12XX_RX_OK)
-            {
-                uint8_t const FIFOaddr = GetRxBufferAddr(radio[secondRadioIdx]);
-                WORD_ALIGNED_ATTR uint8_t RXdataBuffer_second[RXBuffSize];
-                hal.ReadBuffer (FIFOaddr, RXdataBuffer_second, PayloadLength, radio[secondRadioIdx]);
-
-                // if the second packet is same to the first, it's valid
-                if(memcmp(RXdataBuffer, RXdataBuffer_second, PayloadLength) == 0)
-                {
-                    isSecondRadioGotData = true;
-                }
-            }
-        }
-
-        // second radio received the same packet to the processing radio
-        gotRadio[secondRadioIdx] = isSecondRadioGotData;
-        #if defined(DEBUG_RCVR_SIGNAL_STATS)
-        if(!isSecondRadioGotData)
-        {
-            instance->rxSignalStats[secondRadioIdx].fail_count++;
-        }
-        #endif
-    }
-
-    uint8_t status[2];
-    int8_t rssi[2];
-    int8_t snr[2];
-
-    for(uint8_t i=0;i<2;i++)
+    for (uint8_t i = 0; i < 2; i++)
     {
         if (gotRadio[i])
         {
-            hal.ReadCommand(SX1280_RADIO_GET_PACKETSTATUS, status, 2, radio[i]);
-
-            if (packet_mode == SX1280_PACKET_TYPE_FLRC)
-            {
-                // No SNR in FLRC mode
-                rssi[i] = -(int8_t)(status[1] / 2);
-                snr[i] = 0;
-            }
-            else
-            {
-                // LoRa mode has both RSSI and SNR
-                rssi[i] = -(int8_t)(status[0] / 2);
-                snr[i] = (int8_t)status[1];
-
-                // https://www.mouser.com/datasheet/2/761/DS_SX1280-1_V2.2-1511144.pdf p84
-                // need to subtract SNR from RSSI when SNR <= 0;
-                int8_t negOffset = (snr[i] < 0) ? (snr[i] / RADIO_SNR_SCALE) : 0;
-                rssi[i] += negOffset;
-            }
-
             // If radio # is 0, update LastPacketRSSI, otherwise LastPacketRSSI2
             (i == 0) ? LastPacketRSSI = rssi[i] : LastPacketRSSI2 = rssi[i];
             // Update whatever SNRs we have
@@ -684,18 +677,21 @@ void ICACHE_RAM_ATTR SX1280Driver::GetLastPacketStats()
         }
     }
 
-    // by default, set the last successful packet radio to be the current processing radio (which got a successful packet)
-    instance->lastSuccessfulPacketRadio = instance->processingPacketRadio;
+    // The radio the packet was read from, which has the better signal strength when both got it
+    instance->lastSuccessfulPacketRadio = instance->diversity.usedRadio;
 
-    // when both radio got the packet, use the better RSSI one
-    if(gotRadio[0] && gotRadio[1])
+    if (gotRadio[0] && gotRadio[1])
     {
         LastPacketSNRRaw = instance->fuzzy_snr(snr[0], snr[1], instance->FuzzySNRThreshold);
-        // Update the last successful packet radio to be the one with better signal strength
-        instance->lastSuccessfulPacketRadio = (rssi[0]>rssi[1])? radio[0]: radio[1];
     }
 
 #if defined(DEBUG_RCVR_SIGNAL_STATS)
+    // second radio did not receive the same packet as the processing radio
+    if (instance->isFirstRxIrq && RadioPins.hasSecondRadio && !(gotRadio[0] && gotRadio[1]))
+    {
+        instance->rxSignalStats[(instance->processingPacketRadio == SX12XX_Radio_1) ? 1 : 0].fail_count++;
+    }
+
     // stat updates
     for (uint8_t i = 0; i < 2; i++)
     {
@@ -750,6 +746,10 @@ void ICACHE_RAM_ATTR SX1280Driver::IsrCallback(SX12XX_Radio_Number_t radioNumber
         {
             irqClearRadio = SX12XX_Radio_All; // Packet received so clear all radios and dont spend extra time retrieving data.
         }
+        else if (instance->diversity.triedBoth)
+        {
+            irqClearRadio = SX12XX_Radio_All; // Both copies were read and failed, the other radio's RX_DONE has nothing new
+        }
 #if defined(DEBUG_RCVR_SIGNAL_STATS)
         else
         {
@@ -4,6 +4,8 @@
 #include "SX1280_Regs.h"
 #include "SX1280_hal.h"
 #include "SX12xxDriverCommon.h"
+#include "SX12xxCommandQueue.h"
+#include "SX12xxDiversity.h"
 
 #ifdef PLATFORM_ESP8266
 #include <cstdint>
@@ -11,6 +13,9 @@
 
 #define RADIO_SNR_SCALE 4 // Units for LastPacketSNRRaw
 
+// Enough for the TX plan: set the idle radio's mode, write a full packet buffer and SetTx
+typedef SX12xxCommandQueue<3, WORD_PADDED(4) + WORD_PADDED(2 + RXBuffSize) + WORD_PADDED(4)> SX1280CommandQueue;
+
 class SX1280Driver: public SX12xxDriverCommon
 {
 public:
@@ -63,8 +68,11 @@ private:
     uint8_t pwrCurrent;
     uint8_t pwrPending;
     SX1280_RadioOperatingModes_t fallBackMode;
+    SX12xxDiversity diversity;
+    friend class SX12xxDiversity;
 
     void SetMode(SX1280_RadioOperatingModes_t OPmode, SX12XX_Radio_Number_t radioNumber, uint32_t incomingTimeout = 0);
+    void QueueMode(SX1280CommandQueue &queue, SX1280_RadioOperatingModes_t OPmode, SX12XX_Radio_Number_t radioNumber, uint32_t incomingTimeout = 0);
     void SetFIFOaddr(uint8_t txBaseAddr, uint8_t rxBaseAddr);
 
     // LoRa functions
@@ -89,6 +97,9 @@ private:
     static void IsrCallback_2();
     static void IsrCallback(SX12XX_Radio_Number_t radioNumber);
     bool RXnbISR(uint16_t irqStatus, SX12XX_Radio_Number_t radioNumber); // ISR for non-blocking RX routine
+    rx_status GetRxStatus(uint16_t irqStatus);
+    void GetPacketStats(SX12XX_Radio_Number_t radioNumber, int8_t *rssi, int8_t *snr);
+    void ReadPayload(SX12XX_Radio_Number_t radioNumber);
     void TXnbISR(); // ISR for non-blocking TX routine
     void CommitOutputPower();
 };
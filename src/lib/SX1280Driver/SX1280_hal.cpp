@@ -44,6 +44,7 @@ void SX1280Hal::end()
 void SX1280Hal::init()
 {
     DBGLN("Hal Init");
+    RadioPinsInit();
 
     if (GPIO_PIN_BUSY != UNDEF_PIN)
     {
@@ -237,9 +238,14 @@ void ICACHE_RAM_ATTR SX1280Hal::ReadBuffer(uint8_t offset, uint8_t *buffer, uint
     memcpy(buffer, OutBuffer + 3, size);
 }
 
+void ICACHE_RAM_ATTR SX1280Hal::WriteRaw(uint8_t *buffer, uint8_t size, SX12XX_Radio_Number_t radioNumber)
+{
+    SPIEx.write(radioNumber, buffer, size);
+}
+
 bool ICACHE_RAM_ATTR SX1280Hal::WaitOnBusy(SX12XX_Radio_Number_t radioNumber)
 {
-    if (GPIO_PIN_BUSY != UNDEF_PIN)
+    if (RadioPins.busy[0] != UNDEF_PIN)
     {
         constexpr uint32_t wtimeoutUS = 1000U;
         uint32_t startTime = 0;
@@ -248,21 +254,21 @@ bool ICACHE_RAM_ATTR SX1280Hal::WaitOnBusy(SX12XX_Radio_Number_t radioNumber)
         {
             if (radioNumber == SX12XX_Radio_1)
             {
-                if (digitalRead(GPIO_PIN_BUSY) == LOW) return true;
+                if (!RadioPinRead(RadioPins.busy[0])) return true;
             }
             else if (radioNumber == SX12XX_Radio_2)
             {
-                if (GPIO_PIN_BUSY_2 == UNDEF_PIN || digitalRead(GPIO_PIN_BUSY_2) == LOW) return true;
+                if (RadioPins.busy[1] == UNDEF_PIN || !RadioPinRead(RadioPins.busy[1])) return true;
             }
             else if (radioNumber == SX12XX_Radio_All)
             {
-                if (GPIO_PIN_BUSY_2 != UNDEF_PIN)
+                if (RadioPins.busy[1] != UNDEF_PIN)
                 {
-                    if (digitalRead(GPIO_PIN_BUSY) == LOW && digitalRead(GPIO_PIN_BUSY_2) == LOW) return true;
+                    if (!RadioPinRead(RadioPins.busy[0]) && !RadioPinRead(RadioPins.busy[1])) return true;
                 }
                 else
                 {
-                    if (digitalRead(GPIO_PIN_BUSY) == LOW) return true;
+                    if (!RadioPinRead(RadioPins.busy[0])) return true;
                 }
             }
             // Use this time to call micros().
@@ -20,6 +20,7 @@ Heavily modified/simplified by Alessandro Carcione 2020 for ELRS project
 
 #include "SX1280_Regs.h"
 #include "SX1280.h"
+#include "RadioPins.h"
 
 enum SX1280_BusyState_
 {
@@ -50,6 +51,9 @@ public:
     void ICACHE_RAM_ATTR WriteBuffer(uint8_t offset, uint8_t *buffer, uint8_t size, SX12XX_Radio_Number_t radioNumber); // Writes and Reads to FIFO
     void ICACHE_RAM_ATTR ReadBuffer(uint8_t offset, uint8_t *buffer, uint8_t size, SX12XX_Radio_Number_t radioNumber);
 
+    // Write an already built, word aligned command without waiting on BUSY, used by SX12xxCommandQueue
+    void ICACHE_RAM_ATTR WriteRaw(uint8_t *buffer, uint8_t size, SX12XX_Radio_Number_t radioNumber);
+
     bool ICACHE_RAM_ATTR WaitOnBusy(SX12XX_Radio_Number_t radioNumber);
 
     static ICACHE_RAM_ATTR void dioISR_1();
@@ -61,7 +65,7 @@ public:
     uint32_t BusyDelayDuration;
     void BusyDelay(uint32_t duration)
     {
-        if (GPIO_PIN_BUSY == UNDEF_PIN)
+        if (RadioPins.busy[0] == UNDEF_PIN)
         {
             BusyDelayStart = micros();
             BusyDelayDuration = duration;
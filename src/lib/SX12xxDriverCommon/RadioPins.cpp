@@ -0,0 +1,28 @@
+#ifndef UNIT_TEST
+
+#include "RadioPins.h"
+
+radio_pins_t RadioPins;
+
+void RadioPinsInit()
+{
+    RadioPins.busy[0] = GPIO_PIN_BUSY;
+    RadioPins.busy[1] = GPIO_PIN_BUSY_2;
+#if defined(RADIO_SX127X)
+    RadioPins.dio[0] = GPIO_PIN_DIO0;
+    RadioPins.dio[1] = GPIO_PIN_DIO0_2;
+#else
+    RadioPins.dio[0] = GPIO_PIN_DIO1;
+    RadioPins.dio[1] = GPIO_PIN_DIO1_2;
+#endif
+    RadioPins.paEnable = GPIO_PIN_PA_ENABLE;
+    RadioPins.txEnable[0] = GPIO_PIN_TX_ENABLE;
+    RadioPins.txEnable[1] = GPIO_PIN_TX_ENABLE_2;
+    RadioPins.rxEnable[0] = GPIO_PIN_RX_ENABLE;
+    RadioPins.rxEnable[1] = GPIO_PIN_RX_ENABLE_2;
+    RadioPins.antCtrl[0] = GPIO_PIN_ANT_CTRL;
+    RadioPins.antCtrl[1] = GPIO_PIN_ANT_CTRL_COMPL;
+    RadioPins.hasSecondRadio = GPIO_PIN_NSS_2 != UNDEF_PIN;
+}
+
+#endif // UNIT_TEST
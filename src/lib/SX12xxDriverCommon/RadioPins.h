@@ -0,0 +1,40 @@
+#pragma once
+
+#include <targets.h>
+
+#if defined(PLATFORM_ESP32)
+#include <hal/gpio_ll.h>
+#endif
+
+/**
+ * Radio and RF switch pins, copied from the GPIO_PIN_* definitions by RadioPinsInit().
+ * On unified targets every GPIO_PIN_* is a hardware_pin() lookup into the hardware table,
+ * so code which runs on each SPI transaction or radio IRQ reads these instead.
+ * Index 0 is radio 1 and index 1 is radio 2.
+ */
+typedef struct {
+    int8_t busy[2];
+    int8_t dio[2];          // DIO0 on SX127x, DIO1 on SX1280/LR1121
+    int8_t paEnable;
+    int8_t txEnable[2];
+    int8_t rxEnable[2];
+    int8_t antCtrl[2];      // GPIO_PIN_ANT_CTRL and GPIO_PIN_ANT_CTRL_COMPL
+    bool hasSecondRadio;    // GPIO_PIN_NSS_2 is defined
+} radio_pins_t;
+
+extern radio_pins_t RadioPins;
+
+// Must be called after hardware_init() and before the radio HAL is used
+void RadioPinsInit();
+
+#if !defined(TARGET_NATIVE)
+static inline bool ICACHE_RAM_ATTR RadioPinRead(int8_t pin)
+{
+#if defined(PLATFORM_ESP32)
+    // Read the GPIO input register directly, skipping the checks in digitalRead()
+    return gpio_ll_get_level(&GPIO, (gpio_num_t)pin);
+#else
+    return digitalRead(pin) == HIGH;
+#endif
+}
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "SX12xxDriverCommon.h"
+#include <string.h>
+
+/**
+ * @brief A plan of radio write commands which are sent back to back as one transaction.
+ *
+ * Each command is built in place, word aligned, in a single buffer so executing the plan
+ * does no copying. When the plan is executed every radio it addresses is waited on once
+ * up front, then a radio is only waited on again before a command if an earlier command
+ * in the plan was sent to it. With dual radios this means e.g. putting the idle radio
+ * in FS and loading the TX radio's buffer need only one BUSY wait between them.
+ *
+ * The bus type passed to `execute` must provide:
+ *   bool WaitOnBusy(SX12XX_Radio_Number_t radioNumber);
+ *   void WriteRaw(uint8_t *buffer, uint8_t size, SX12XX_Radio_Number_t radioNumber);
+ *   void BusyDelay(uint32_t duration);
+ * so the same plan can be run against the radio HAL or a model of it in the unit tests.
+ *
+ * Only the SX1280 driver builds its mode changes and TX as plans so far. The LR1121 still waits
+ * before every command: its opcodes are 16 bit and the driver isn't built natively to test a
+ * plan against. BUSY is still polled rather than waited on with an interrupt, it is a few us
+ * after each command, less than the cost of taking the interrupt, and the plan removes most waits.
+ *
+ * @tparam MAX_COMMANDS the maximum number of commands in the plan
+ * @tparam MAX_BYTES the size of the command buffer, including word padding of each command
+ */
+template <uint8_t MAX_COMMANDS, uint8_t MAX_BYTES>
+class SX12xxCommandQueue
+{
+    static_assert((MAX_BYTES & 3) == 0, "SX12xxCommandQueue buffer must be a whole number of words");
+
+private:
+    typedef struct {
+        uint8_t offset;
+        uint8_t size;
+        SX12XX_Radio_Number_t radioNumber;
+        uint16_t busyDelay;
+    } command_t;
+
+    WORD_ALIGNED_ATTR uint8_t buffer[MAX_BYTES];
+    command_t commands[MAX_COMMANDS];
+    uint8_t commandCount = 0;
+    uint8_t bytesUsed = 0;
+
+public:
+    void clear()
+    {
+        commandCount = 0;
+        bytesUsed = 0;
+    }
+
+    uint8_t count() const { return commandCount; }
+
+    /**
+     * @brief Reserve a command in the plan
+     *
+     * @param size number of bytes to send, including the opcode
+     * @param busyDelay time in us the radio stays busy after the command, used when there is no BUSY pin
+     * @return pointer to `size` bytes to fill with the command, or nullptr if the plan is full
+     */
+    uint8_t * ICACHE_RAM_ATTR add(SX12XX_Radio_Number_t radioNumber, uint8_t size, uint16_t busyDelay = 15)
+    {
+        if (commandCount == MAX_COMMANDS || WORD_PADDED(size) > MAX_BYTES - bytesUsed)
+        {
+            return nullptr;
+        }
+        command_t &cmd = commands[commandCount++];
+        cmd.offset = bytesUsed;
+        cmd.size = size;
+        cmd.radioNumber = radioNumber;
+        cmd.busyDelay = busyDelay;
+        bytesUsed += WORD_PADDED(size);
+        return &buffer[cmd.offset];
+    }
+
+    /**
+     * @brief Add a command made of an opcode followed by `size` parameter bytes
+     *
+     * @return false if the plan is full
+     */
+    bool ICACHE_RAM_ATTR add(SX12XX_Radio_Number_t radioNumber, uint8_t opcode, const uint8_t *params, uint8_t size, uint16_t busyDelay = 15)
+    {
+        uint8_t *cmd = add(radioNumber, size + 1, busyDelay);
+        if (cmd == nullptr)
+        {
+            return false;
+        }
+        cmd[0] = opcode;
+        memcpy(cmd + 1, params, size);
+        return true;
+    }
+
+    /**
+     * @brief Send every command in the plan, in order
+     */
+    template <typename BUS>
+    void ICACHE_RAM_ATTR execute(BUS &bus)
+    {
+        SX12XX_Radio_Number_t pending = SX12XX_Radio_NONE;
+        for (uint8_t i = 0; i < commandCount; i++)
+        {
+            pending |= commands[i].radioNumber;
+        }
+        if (pending != SX12XX_Radio_NONE)
+        {
+            bus.WaitOnBusy(pending);
+        }
+
+        // Radios which have been sent a command since they were last waited on
+        pending = SX12XX_Radio_NONE;
+        for (uint8_t i = 0; i < commandCount; i++)
+        {
+            command_t const &cmd = commands[i];
+            if (pending & cmd.radioNumber)
+            {
+                bus.WaitOnBusy(pending & cmd.radioNumber);
+                pending &= ~cmd.radioNumber;
+            }
+            bus.WriteRaw(&buffer[cmd.offset], cmd.size, cmd.radioNumber);
+            bus.BusyDelay(cmd.busyDelay);
+            pending |= cmd.radioNumber;
+        }
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "SX12xxDriverCommon.h"
+
+/**
+ * @brief Receive a packet on a dual radio (diversity) receiver, reading the payload over SPI once.
+ *
+ * When one radio raises RX_DONE the other has usually received the same packet. Rather than
+ * reading and comparing the payloads from both, only the other radio's IRQ status and the
+ * packet status (RSSI/SNR) of each radio which received are read, then the payload is read from
+ * the radio with the better signal. The other radio's payload is only read if the packet from
+ * the first fails the OTA CRC, i.e. the RXdoneCallback returns false.
+ *
+ * The radio type passed to `receive` must provide:
+ *   uint16_t GetIrqStatus(SX12XX_Radio_Number_t radioNumber);
+ *   rx_status GetRxStatus(uint16_t irqStatus); // SX12XX_RX_OK only for RX_DONE without errors
+ *   void GetPacketStats(SX12XX_Radio_Number_t radioNumber, int8_t *rssi, int8_t *snr);
+ *   void ReadPayload(SX12XX_Radio_Number_t radioNumber); // into RXdataBuffer
+ *   bool RXdoneCallback(rx_status status);
+ * so the same logic can be run against the radio driver or a model of it in the unit tests.
+ */
+class SX12xxDiversity
+{
+public:
+    typedef SX12xxDriverCommon::rx_status rx_status;
+
+    // Which radios received the packet being processed, and their packet stats.
+    // Only valid while the RXdoneCallback is being called.
+    bool gotRadio[2];
+    int8_t rssi[2];
+    int8_t snr[2];
+    // The radio the payload in RXdataBuffer was read from
+    SX12XX_Radio_Number_t usedRadio;
+    // Both radios' payloads were read for the last packet, so neither radio's RX_DONE needs handling again
+    bool triedBoth;
+
+    /**
+     * @brief Handle RX_DONE on a radio
+     *
+     * @param irqStatus the IRQ status of the radio which raised the interrupt
+     * @param checkOtherRadio true if there is a second radio which may also have the packet.
+     * Its RX_DONE is taken to be the same packet, anything else is caught by the OTA CRC.
+     * @return the result of the RXdoneCallback for the payload which was used
+     */
+    template <class Radio>
+    bool ICACHE_RAM_ATTR receive(Radio &radio, uint16_t irqStatus, SX12XX_Radio_Number_t radioNumber, bool checkOtherRadio)
+    {
+        const uint8_t idx = radioNumber == SX12XX_Radio_1 ? 0 : 1;
+        const SX12XX_Radio_Number_t otherRadio = idx == 0 ? SX12XX_Radio_2 : SX12XX_Radio_1;
+        gotRadio[0] = gotRadio[1] = false;
+        usedRadio = radioNumber;
+        triedBoth = false;
+
+        const rx_status fail = radio.GetRxStatus(irqStatus);
+        if (fail != SX12xxDriverCommon::SX12XX_RX_OK)
+        {
+            return radio.RXdoneCallback(fail);
+        }
+
+        gotRadio[idx] = true;
+        radio.GetPacketStats(radioNumber, &rssi[idx], &snr[idx]);
+        if (checkOtherRadio && radio.GetRxStatus(radio.GetIrqStatus(otherRadio)) == SX12xxDriverCommon::SX12XX_RX_OK)
+        {
+            gotRadio[!idx] = true;
+            radio.GetPacketStats(otherRadio, &rssi[!idx], &snr[!idx]);
+            if (isBetter(!idx, idx))
+            {
+                usedRadio = otherRadio;
+            }
+        }
+
+        radio.ReadPayload(usedRadio);
+        if (radio.RXdoneCallback(SX12xxDriverCommon::SX12XX_RX_OK))
+        {
+            return true;
+        }
+        if (!gotRadio[0] || !gotRadio[1])
+        {
+            return false;
+        }
+
+        // The payload from the better radio was corrupt, the other may still be good
+        gotRadio[usedRadio == SX12XX_Radio_1 ? 0 : 1] = false;
+        usedRadio = usedRadio == SX12XX_Radio_1 ? SX12XX_Radio_2 : SX12XX_Radio_1;
+        triedBoth = true;
+        radio.ReadPayload(usedRadio);
+        return radio.RXdoneCallback(SX12xxDriverCommon::SX12XX_RX_OK);
+    }
+
+private:
+    // Stronger RSSI wins, SNR breaks a tie, otherwise stay with the radio which raised the IRQ
+    bool isBetter(uint8_t a, uint8_t b) const
+    {
+        return rssi[a] > rssi[b] || (rssi[a] == rssi[b] && snr[a] > snr[b]);
+    }
+};
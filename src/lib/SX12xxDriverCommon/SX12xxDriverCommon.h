@@ -35,7 +35,11 @@ public:
     bool (*RXdoneCallback)(rx_status crcFail); //function pointer for callback
     void (*TXdoneCallback)(); //function pointer for callback
 
+#if defined(USE_OTA8_RS)
+    #define RXBuffSize 20 // Largest OTA packet (OTA8_RS_PACKET_SIZE) word padded
+#else
     #define RXBuffSize 16
+#endif
     WORD_ALIGNED_ATTR uint8_t RXdataBuffer[RXBuffSize];
 
     ///////////Radio Variables////////
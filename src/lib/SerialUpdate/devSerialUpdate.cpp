@@ -65,6 +65,7 @@ device_t SerialUpdate_device = {
     .initialize = initialize,
     .start = nullptr,
     .event = event,
-    .timeout = timeout
+    .timeout = timeout,
+    .events = EVENT_CONNECTION_CHANGED
 };
 #endif
\ No newline at end of file
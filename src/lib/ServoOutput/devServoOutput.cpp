@@ -267,6 +267,7 @@ device_t ServoOut_device = {
     .start = start,
     .event = event,
     .timeout = timeout,
+    .events = EVENT_CONNECTION_CHANGED | EVENT_CONFIG_CHANGED,
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cstring>
 #include "stubborn_receiver.h"
+#include "telemetry_protocol.h"
 
 StubbornReceiver::StubbornReceiver()
 {
@@ -24,6 +25,7 @@ void StubbornReceiver::ResetState()
     currentPackage = 1;
     currentOffset = 0;
     telemetryConfirm = false;
+    receivedMask = 0;
 }
 
 bool StubbornReceiver::GetCurrentConfirm()
@@ -31,6 +33,25 @@ bool StubbornReceiver::GetCurrentConfirm()
     return telemetryConfirm;
 }
 
+/***
+ * Selective acknowledgement for windowed senders, see STUBBORN_SACK_PRESENT
+ ***/
+uint8_t StubbornReceiver::GetCurrentSack()
+{
+    // Nothing of the next message can be received until Unlock()
+    if (finishedData)
+    {
+        return STUBBORN_SACK_PRESENT | (1 << STUBBORN_SACK_BASE_SHIFT);
+    }
+
+    uint8_t bitmap = 0;
+    if (currentPackage < 31)
+    {
+        bitmap = (receivedMask >> (currentPackage + 1)) & STUBBORN_SACK_BITMAP_MASK;
+    }
+    return STUBBORN_SACK_PRESENT | ((currentPackage & STUBBORN_SACK_BASE_MASK) << STUBBORN_SACK_BASE_SHIFT) | bitmap;
+}
+
 void StubbornReceiver::SetDataToReceive(uint8_t* dataToReceive, uint8_t maxLength)
 {
     length = maxLength;
@@ -38,6 +59,7 @@ void StubbornReceiver::SetDataToReceive(uint8_t* dataToReceive, uint8_t maxLengt
     currentPackage = 1;
     currentOffset = 0;
     finishedData = false;
+    receivedMask = 0;
 }
 
 void StubbornReceiver::ReceiveData(uint8_t const packageIndex, uint8_t const * const receiveData, uint8_t dataLen)
@@ -49,6 +71,7 @@ void StubbornReceiver::ReceiveData(uint8_t const packageIndex, uint8_t const * c
         currentPackage = 1;
         currentOffset = 0;
         finishedData = false;
+        receivedMask = 0;
         return;
     }
 
@@ -77,8 +100,21 @@ void StubbornReceiver::ReceiveData(uint8_t const packageIndex, uint8_t const * c
     {
         currentPackage = 1;
         currentOffset = 0;
+        receivedMask = 0;
         acceptData = true;
     }
+    // A windowed sender sends packages ahead of the expected one once the first is confirmed,
+    // store them in place. They are confirmed when currentPackage gets to them.
+    else if (currentPackage > 1 && packageIndex > currentPackage
+        && packageIndex < currentPackage + STUBBORN_SACK_WINDOW && packageIndex < 32)
+    {
+        uint16_t const offset = (packageIndex - 1) * dataLen;
+        if (offset < length)
+        {
+            memcpy(&data[offset], receiveData, std::min((uint16_t)(length - offset), (uint16_t)dataLen));
+            receivedMask |= 1UL << packageIndex;
+        }
+    }
 
     if (acceptData)
     {
@@ -87,6 +123,15 @@ void StubbornReceiver::ReceiveData(uint8_t const packageIndex, uint8_t const * c
         currentPackage++;
         currentOffset += len;
         telemetryConfirm = !telemetryConfirm;
+
+        // Skip over any packages which were already received ahead
+        while (currentPackage < 32 && (receivedMask & (1UL << currentPackage)))
+        {
+            receivedMask &= ~(1UL << currentPackage);
+            currentPackage++;
+            currentOffset += std::min((uint8_t)(length - currentOffset), dataLen);
+            telemetryConfirm = !telemetryConfirm;
+        }
     }
 }
 
@@ -102,5 +147,6 @@ void StubbornReceiver::Unlock()
         currentPackage = 1;
         currentOffset = 0;
         finishedData = false;
+        receivedMask = 0;
     }
 }
@@ -13,6 +13,7 @@ public:
     bool HasFinishedData();
     void Unlock();
     bool GetCurrentConfirm();
+    uint8_t GetCurrentSack();
 private:
     uint8_t *data;
     bool finishedData;
@@ -21,4 +22,6 @@ private:
     uint8_t currentPackage;
     bool telemetryConfirm;
     uint8_t maxPackageIndex;
+    // Packages received ahead of currentPackage from a windowed sender, bit n is packageIndex n
+    uint32_t receivedMask;
 };
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cstring>
 #include "stubborn_sender.h"
+#include "telemetry_protocol.h"
 
 StubbornSender::StubbornSender()
     : data(nullptr), length(0)
@@ -28,6 +29,11 @@ void StubbornSender::ResetState()
     // 80 corresponds to UpdateTelemetryRate(ANY, 2, 1), which is what the TX uses in boost mode
     maxWaitCount = 80;
     senderState = SENDER_IDLE;
+    peerSupportsSack = false;
+    windowed = false;
+    bytesPerCall = 0;
+    nextToSend = 1;
+    sackedMask = 0;
 }
 
 /***
@@ -45,9 +51,47 @@ void StubbornSender::SetDataToTransmit(uint8_t* dataToTransmit, uint8_t lengthTo
     currentOffset = 0;
     currentPackage = 1;
     waitCount = 0;
+    windowed = peerSupportsSack;
+    nextToSend = 1;
+    sackedMask = 0;
     senderState = (senderState == SENDER_IDLE) ? SEND_PENDING : RESYNC_THEN_SEND;
 }
 
+/***
+ * In windowed mode every package but the first and last can be in flight at once.
+ * The first and last are sent and confirmed the same as non-windowed, so the receiver's
+ * restart on packageIndex 1 and the final packageIndex 0 work the same in both modes
+ ***/
+bool StubbornSender::IsWindowPackage(uint8_t packageIndex, uint8_t packageSize) const
+{
+    // sackedMask must be able to hold a full window past the package
+    return packageIndex > 1 && packageIndex < 32 - 2 * STUBBORN_SACK_WINDOW && packageIndex < maxPackageIndex
+        && packageSize != 0 && (uint16_t)packageIndex * packageSize < length;
+}
+
+uint8_t StubbornSender::GetWindowPayload(uint8_t *outData, uint8_t maxLen)
+{
+    // Take turns sending each package in the window which the receiver has not SACKed
+    for (uint8_t i = 0; i < STUBBORN_SACK_WINDOW; i++)
+    {
+        if (nextToSend < currentPackage || nextToSend >= currentPackage + STUBBORN_SACK_WINDOW
+            || !IsWindowPackage(nextToSend, maxLen))
+        {
+            nextToSend = currentPackage;
+        }
+        uint8_t const packageIndex = nextToSend++;
+        if ((sackedMask & (1UL << packageIndex)) == 0)
+        {
+            memcpy(outData, &data[(packageIndex - 1) * maxLen], maxLen);
+            return packageIndex;
+        }
+    }
+
+    // Unreachable, the package at the start of the window is never SACKed
+    memcpy(outData, &data[currentOffset], maxLen);
+    return currentPackage;
+}
+
 /**
  * @brief: Copy up to maxLen bytes from the current package to outData
  * @returns: packageIndex
@@ -68,6 +112,12 @@ uint8_t StubbornSender::GetCurrentPayload(uint8_t *outData, uint8_t maxLen)
         senderState = SENDING;
         // fallthrough
     case SENDING:
+        bytesPerCall = maxLen;
+        if (windowed && IsWindowPackage(currentPackage, maxLen))
+        {
+            packageIndex = GetWindowPayload(outData, maxLen);
+            break;
+        }
         {
             bytesLastPayload = std::min((uint8_t)(length - currentOffset), maxLen);
             // If this is the last data chunk, and there has been at least one other packet
@@ -87,24 +137,85 @@ uint8_t StubbornSender::GetCurrentPayload(uint8_t *outData, uint8_t maxLen)
     return packageIndex;
 }
 
-void StubbornSender::ConfirmCurrentPayload(bool telemetryConfirmValue)
+/***
+ * Count a confirm which did not advance the send, and RESYNC if there have been too many
+ ***/
+void StubbornSender::WaitForConfirm(bool telemetryConfirmValue, stubborn_sender_state_e &nextSenderState)
+{
+    waitCount++;
+    if (waitCount > maxWaitCount)
+    {
+        telemetryConfirmExpectedValue = !telemetryConfirmValue;
+        nextSenderState = RESYNC;
+    }
+}
+
+/***
+ * Advance the window to the receiver's next expected package. Every package acked
+ * toggles the expected confirm value just like non-windowed mode, so the final
+ * packageIndex 0 can be confirmed the non-windowed way.
+ ***/
+void StubbornSender::ConfirmWindow(uint8_t sack)
+{
+    uint8_t const ackBase = (sack >> STUBBORN_SACK_BASE_SHIFT) & STUBBORN_SACK_BASE_MASK;
+    uint8_t const advance = (ackBase - currentPackage) & STUBBORN_SACK_BASE_MASK;
+    // The receiver can not be more than a window ahead, so this is an old SACK
+    if (advance > STUBBORN_SACK_WINDOW)
+    {
+        return;
+    }
+
+    currentPackage += advance;
+    currentOffset += advance * bytesPerCall;
+    if (advance & 1)
+    {
+        telemetryConfirmExpectedValue = !telemetryConfirmExpectedValue;
+    }
+    sackedMask = (uint32_t)(sack & STUBBORN_SACK_BITMAP_MASK) << (currentPackage + 1);
+    if (advance)
+    {
+        waitCount = 0;
+    }
+}
+
+void StubbornSender::ConfirmCurrentPayload(bool telemetryConfirmValue, uint8_t sack)
 {
     stubborn_sender_state_e nextSenderState = senderState;
+    bool const sackPresent = sack & STUBBORN_SACK_PRESENT;
+
+    // Windowed sends need SACKs, if the receiver stops sending them restart non-windowed
+    if (windowed && !sackPresent && senderState == SENDING)
+    {
+        windowed = false;
+        currentOffset = 0;
+        currentPackage = 1;
+        waitCount = 0;
+        telemetryConfirmExpectedValue = !telemetryConfirmValue;
+        senderState = RESYNC_THEN_SEND;
+        return;
+    }
+    peerSupportsSack = sackPresent;
 
     switch (senderState)
     {
     case SENDING:
-        if (telemetryConfirmValue != telemetryConfirmExpectedValue)
+        if (windowed && IsWindowPackage(currentPackage, bytesPerCall))
         {
-            waitCount++;
-            if (waitCount > maxWaitCount)
+            uint8_t const lastPackage = currentPackage;
+            ConfirmWindow(sack);
+            if (currentPackage == lastPackage)
             {
-                telemetryConfirmExpectedValue = !telemetryConfirmValue;
-                nextSenderState = RESYNC;
+                WaitForConfirm(telemetryConfirmValue, nextSenderState);
             }
             break;
         }
 
+        if (telemetryConfirmValue != telemetryConfirmExpectedValue)
+        {
+            WaitForConfirm(telemetryConfirmValue, nextSenderState);
+            break;
+        }
+
         currentOffset += bytesLastPayload;
         if (currentOffset >= length)
         {
@@ -133,12 +244,7 @@ void StubbornSender::ConfirmCurrentPayload(bool telemetryConfirmValue)
         // switch to resync if tx does not confirm value fast enough
         else if (senderState == WAIT_UNTIL_NEXT_CONFIRM)
         {
-            waitCount++;
-            if (waitCount > maxWaitCount)
-            {
-                telemetryConfirmExpectedValue = !telemetryConfirmValue;
-                nextSenderState = RESYNC;
-            }
+            WaitForConfirm(telemetryConfirmValue, nextSenderState);
         }
         break;
 
@@ -23,10 +23,15 @@ public:
     void UpdateTelemetryRate(uint16_t airRate, uint8_t tlmRatio, uint8_t tlmBurst);
     void SetDataToTransmit(uint8_t* dataToTransmit, uint8_t lengthToTransmit);
     uint8_t GetCurrentPayload(uint8_t *outData, uint8_t maxLen);
-    void ConfirmCurrentPayload(bool telemetryConfirmValue);
+    void ConfirmCurrentPayload(bool telemetryConfirmValue, uint8_t sack = 0);
     bool IsActive() const { return senderState != SENDER_IDLE; }
     uint16_t GetMaxPacketsBeforeResync() const { return maxWaitCount; }
 private:
+    bool IsWindowPackage(uint8_t packageIndex, uint8_t packageSize) const;
+    uint8_t GetWindowPayload(uint8_t *outData, uint8_t maxLen);
+    void ConfirmWindow(uint8_t sack);
+    void WaitForConfirm(bool telemetryConfirmValue, stubborn_sender_state_e &nextSenderState);
+
     uint8_t *data;
     uint8_t length;
     uint8_t currentOffset;
@@ -37,4 +42,10 @@ private:
     uint16_t maxWaitCount;
     uint8_t maxPackageIndex;
     stubborn_sender_state_e senderState;
+    // Windowed mode, used when the receiver sends SACKs
+    bool peerSupportsSack;
+    bool windowed;
+    uint8_t bytesPerCall;
+    uint8_t nextToSend;
+    uint32_t sackedMask;
 };
@@ -279,7 +279,8 @@ device_t Thermal_device = {
     .initialize = initialize,
     .start = start,
     .event = event,
-    .timeout = timeout
+    .timeout = timeout,
+    .events = EVENT_CONFIG_CHANGED
 };
 
 #endif // HAS_THERMAL || HAS_FAN
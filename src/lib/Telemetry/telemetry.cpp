@@ -85,41 +85,98 @@ PAYLOAD_DATA(GPS, BATTERY_SENSOR, ATTITUDE, DEVICE_INFO, FLIGHT_MODE, VARIO, BAR
 
 bool Telemetry::GetNextPayload(uint8_t* nextPayloadSize, uint8_t **payloadData)
 {
-    uint8_t checks = 0;
-    uint8_t oldPayloadIndex = currentPayloadIndex;
+    return GetNextPayload(nextPayloadSize, payloadData, millis());
+}
+
+/***
+ * @brief: Pick the next payload to send. Payloads which have not been sent for their type's
+ * intervalMs go first, then the highest weight * number of other payloads sent since this one
+ * was updated, with ties going round-robin. Types which have only received the same data as was
+ * last sent are skipped until TELEMETRY_UNCHANGED_RESEND_MS has passed.
+ ***/
+bool Telemetry::GetNextPayload(uint8_t* nextPayloadSize, uint8_t **payloadData, uint32_t now)
+{
     uint8_t realLength = 0;
 
     if (payloadTypes[currentPayloadIndex].locked)
     {
         payloadTypes[currentPayloadIndex].locked = false;
         payloadTypes[currentPayloadIndex].updated = false;
+        payloadTypes[currentPayloadIndex].repeated = false;
+        payloadTypes[currentPayloadIndex].sentCount++;
     }
 
-    do
+    int8_t bestIndex = -1;
+    bool bestDue = false;
+    uint16_t bestScore = 0;
+    for (uint8_t checks = 1; checks <= payloadTypesCount; checks++)
     {
-        currentPayloadIndex = (currentPayloadIndex + 1) % payloadTypesCount;
-        checks++;
-    } while(!payloadTypes[currentPayloadIndex].updated && checks < payloadTypesCount);
+        uint8_t const i = (currentPayloadIndex + checks) % payloadTypesCount;
+        volatile crsf_telemetry_package_t &payload = payloadTypes[i];
+        uint32_t const sinceSent = now - payload.lastSentMs;
+        if (!payload.updated && !(payload.repeated && sinceSent >= TELEMETRY_UNCHANGED_RESEND_MS))
+        {
+            continue;
+        }
 
-    if (payloadTypes[currentPayloadIndex].updated)
-    {
-        payloadTypes[currentPayloadIndex].locked = true;
+        bool const due = sinceSent >= payload.intervalMs;
+        uint16_t const score = (uint8_t)(sendCount - payload.pendingSince) * payload.weight;
+        if (bestIndex == -1 || (due && !bestDue) || (due == bestDue && score > bestScore))
+        {
+            bestIndex = i;
+            bestDue = due;
+            bestScore = score;
+        }
+    }
 
-        realLength = CRSF_FRAME_SIZE(payloadTypes[currentPayloadIndex].data[CRSF_TELEMETRY_LENGTH_INDEX]);
+    if (bestIndex != -1)
+    {
+        volatile crsf_telemetry_package_t &payload = payloadTypes[bestIndex];
+        realLength = CRSF_FRAME_SIZE(payload.data[CRSF_TELEMETRY_LENGTH_INDEX]);
         if (realLength > 0)
         {
+            currentPayloadIndex = bestIndex;
+            payload.locked = true;
+            payload.lastSentMs = now;
+            sendCount++;
             *nextPayloadSize = realLength;
-            *payloadData = payloadTypes[currentPayloadIndex].data;
+            *payloadData = payload.data;
             return true;
         }
     }
 
-    currentPayloadIndex = oldPayloadIndex;
     *nextPayloadSize = 0;
     *payloadData = 0;
     return false;
 }
 
+bool Telemetry::SetPayloadWeight(uint8_t type, uint8_t weight)
+{
+    bool found = false;
+    for (int8_t i = 0; i < payloadTypesCount; i++)
+    {
+        if (payloadTypes[i].type == type)
+        {
+            payloadTypes[i].weight = weight;
+            found = true;
+        }
+    }
+    return found;
+}
+
+uint16_t Telemetry::PayloadSentCount(uint8_t type)
+{
+    uint16_t count = 0;
+    for (int8_t i = 0; i < payloadTypesCount; i++)
+    {
+        if (payloadTypes[i].type == type)
+        {
+            count += payloadTypes[i].sentCount;
+        }
+    }
+    return count;
+}
+
 uint8_t Telemetry::UpdatedPayloadCount()
 {
     uint8_t count = 0;
@@ -145,7 +202,9 @@ void Telemetry::ResetState()
     currentTelemetryByte = 0;
     currentPayloadIndex = 0;
     twoslotLastQueueIndex = 0;
+    sendCount = 0;
     receivedPackages = 0;
+    memset(PayloadData, 0, sizeof(PayloadData));
 
     uint8_t offset = 0;
 
@@ -153,6 +212,9 @@ void Telemetry::ResetState()
     {
         payloadTypes[i].locked = false;
         payloadTypes[i].updated = false;
+        payloadTypes[i].repeated = false;
+        payloadTypes[i].sentCount = 0;
+        payloadTypes[i].lastSentMs = 0;
         payloadTypes[i].data = PayloadData + offset;
         offset += payloadTypes[i].size;
 
@@ -374,10 +436,32 @@ bool Telemetry::AppendTelemetryPackage(uint8_t *package)
 
     if (targetFound && !payloadTypes[targetIndex].locked)
     {
-        memcpy(payloadTypes[targetIndex].data, package, CRSF_FRAME_SIZE(package[CRSF_TELEMETRY_LENGTH_INDEX]));
-        payloadTypes[targetIndex].updated = true;
+        SetPending(&payloadTypes[targetIndex], package);
     }
 
     return targetFound;
 }
+
+void Telemetry::SetPending(volatile crsf_telemetry_package_t *current, uint8_t *package)
+{
+    uint8_t const size = CRSF_FRAME_SIZE(package[CRSF_TELEMETRY_LENGTH_INDEX]);
+    // Sensor types are sent periodically, so skip sending them again if nothing has changed.
+    // The general slots are responses which are always sent
+    if (current->type != 0 && !current->updated && memcmp(current->data, package, size) == 0)
+    {
+        if (!current->repeated)
+        {
+            current->repeated = true;
+            current->pendingSince = sendCount;
+        }
+        return;
+    }
+
+    memcpy(current->data, package, size);
+    if (!current->updated && !current->repeated)
+    {
+        current->pendingSince = sendCount;
+    }
+    current->updated = true;
+}
 #endif
@@ -19,11 +19,31 @@ typedef enum {
 typedef struct crsf_telemetry_package_t {
     const uint8_t type;
     const uint8_t size;
+    const uint16_t intervalMs;  // target time between sends, another type is sent first if this one was sent more recently
+    uint8_t weight;             // how fast the priority goes up with the time waiting to be sent
     volatile bool locked;
-    volatile bool updated;
+    volatile bool updated;      // new data waiting to be sent
+    volatile bool repeated;     // the same data as last sent was received again, only sent as a keepalive
+    uint8_t pendingSince;       // sendCount when updated or repeated was set
+    uint16_t sentCount;         // payloads sent of this type, for measuring the delivered rate
+    uint32_t lastSentMs;
     uint8_t *data;
 } crsf_telemetry_package_t;
 
+// Default schedule for each type: intervalMs, weight
+// General slots carry MSP responses and extended frames which are not sent periodically
+#define TELEMETRY_SCHEDULE_GPS            200, 2
+#define TELEMETRY_SCHEDULE_BATTERY_SENSOR 1000, 1
+#define TELEMETRY_SCHEDULE_ATTITUDE       100, 3
+#define TELEMETRY_SCHEDULE_DEVICE_INFO    0, 4
+#define TELEMETRY_SCHEDULE_FLIGHT_MODE    500, 2
+#define TELEMETRY_SCHEDULE_VARIO          100, 2
+#define TELEMETRY_SCHEDULE_BARO_ALTITUDE  200, 2
+#define TELEMETRY_SCHEDULE_GENERAL        0, 4
+
+// A type which keeps receiving unchanged data is still sent this often, so the handset does not time out the sensor
+#define TELEMETRY_UNCHANGED_RESEND_MS 1000
+
 #define PAYLOAD_DATA(type0, type1, type2, type3, type4, type5, type6)\
     uint8_t PayloadData[\
         CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type0##_PAYLOAD_SIZE) + \
@@ -36,15 +56,15 @@ typedef struct crsf_telemetry_package_t {
         CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_GENERAL_RESP_PAYLOAD_SIZE) + \
         CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_GENERAL_RESP_PAYLOAD_SIZE)]; \
     crsf_telemetry_package_t payloadTypes[] = {\
-    {CRSF_FRAMETYPE_##type0, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type0##_PAYLOAD_SIZE), false, false, 0},\
-    {CRSF_FRAMETYPE_##type1, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type1##_PAYLOAD_SIZE), false, false, 0},\
-    {CRSF_FRAMETYPE_##type2, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type2##_PAYLOAD_SIZE), false, false, 0},\
-    {CRSF_FRAMETYPE_##type3, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type3##_PAYLOAD_SIZE), false, false, 0},\
-    {CRSF_FRAMETYPE_##type4, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type4##_PAYLOAD_SIZE), false, false, 0},\
-    {CRSF_FRAMETYPE_##type5, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type5##_PAYLOAD_SIZE), false, false, 0},\
-    {CRSF_FRAMETYPE_##type6, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type6##_PAYLOAD_SIZE), false, false, 0},\
-    {0, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_GENERAL_RESP_PAYLOAD_SIZE), false, false, 0},\
-    {0, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_GENERAL_RESP_PAYLOAD_SIZE), false, false, 0}};\
+    {CRSF_FRAMETYPE_##type0, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type0##_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_##type0, false, false, false, 0, 0, 0, 0},\
+    {CRSF_FRAMETYPE_##type1, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type1##_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_##type1, false, false, false, 0, 0, 0, 0},\
+    {CRSF_FRAMETYPE_##type2, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type2##_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_##type2, false, false, false, 0, 0, 0, 0},\
+    {CRSF_FRAMETYPE_##type3, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type3##_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_##type3, false, false, false, 0, 0, 0, 0},\
+    {CRSF_FRAMETYPE_##type4, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type4##_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_##type4, false, false, false, 0, 0, 0, 0},\
+    {CRSF_FRAMETYPE_##type5, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type5##_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_##type5, false, false, false, 0, 0, 0, 0},\
+    {CRSF_FRAMETYPE_##type6, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_##type6##_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_##type6, false, false, false, 0, 0, 0, 0},\
+    {0, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_GENERAL_RESP_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_GENERAL, false, false, false, 0, 0, 0, 0},\
+    {0, CRSF_TELEMETRY_TOTAL_SIZE(CRSF_FRAME_GENERAL_RESP_PAYLOAD_SIZE), TELEMETRY_SCHEDULE_GENERAL, false, false, false, 0, 0, 0, 0}};\
     const uint8_t payloadTypesCount = (sizeof(payloadTypes)/sizeof(crsf_telemetry_package_t))
 
 class Telemetry
@@ -65,17 +85,22 @@ public:
     bool GetCrsfBaroSensorDetected() { return crsfBaroSensorDetected; };
     uint8_t GetUpdatedModelMatch() { return modelMatchId; }
     bool GetNextPayload(uint8_t* nextPayloadSize, uint8_t **payloadData);
+    bool GetNextPayload(uint8_t* nextPayloadSize, uint8_t **payloadData, uint32_t now);
+    bool SetPayloadWeight(uint8_t type, uint8_t weight);
+    uint16_t PayloadSentCount(uint8_t type);
     uint8_t UpdatedPayloadCount();
     uint8_t ReceivedPackagesCount();
     bool AppendTelemetryPackage(uint8_t *package);
 private:
     bool processInternalTelemetryPackage(uint8_t *package);
     void AppendToPackage(volatile crsf_telemetry_package_t *current);
+    void SetPending(volatile crsf_telemetry_package_t *current, uint8_t *package);
     uint8_t CRSFinBuffer[CRSF_MAX_PACKET_LEN];
     telemetry_state_s telemetry_state;
     uint8_t currentTelemetryByte;
     uint8_t currentPayloadIndex;
     uint8_t twoslotLastQueueIndex;
+    uint8_t sendCount;
     volatile crsf_telemetry_package_t *telemetryPackageHead;
     uint8_t receivedPackages;
     bool callBootloader;
@@ -0,0 +1,131 @@
+#include <cstring>
+#include "telemetry_compact.h"
+#include "CRSF.h"
+
+static const uint8_t refTypes[] = {
+    CRSF_FRAMETYPE_GPS,
+    CRSF_FRAMETYPE_BATTERY_SENSOR,
+    CRSF_FRAMETYPE_ATTITUDE,
+    CRSF_FRAMETYPE_VARIO,
+    CRSF_FRAMETYPE_BARO_ALTITUDE,
+};
+
+void TelemetryCompact::Reset()
+{
+    memset(refs, 0, sizeof(refs));
+}
+
+tlm_compact_ref_t *TelemetryCompact::GetRef(uint8_t type)
+{
+    static_assert(sizeof(refTypes) == sizeof(refs) / sizeof(refs[0]), "One ref per type");
+    for (uint8_t i = 0; i < sizeof(refTypes); i++)
+    {
+        if (refTypes[i] == type)
+        {
+            return &refs[i];
+        }
+    }
+    return nullptr;
+}
+
+uint8_t TelemetryCompactEncoder::Encode(uint8_t const *frame, uint8_t *out)
+{
+    uint8_t const type = frame[CRSF_TELEMETRY_TYPE_INDEX];
+    uint8_t const payloadLen = frame[CRSF_TELEMETRY_LENGTH_INDEX] - CRSF_FRAME_SIZE(0);
+    uint8_t const *payload = &frame[CRSF_TELEMETRY_TYPE_INDEX + 1];
+    tlm_compact_ref_t *ref = GetRef(type);
+    if (ref == nullptr || payloadLen > TLM_COMPACT_MAX_PAYLOAD)
+    {
+        return 0;
+    }
+
+    ref->seq = (ref->seq + 1) & TLM_COMPACT_SEQ_MASK;
+    // A keyframe is the frame without its CRC, which is the same size as the original frame
+    uint8_t const keyframeSize = CRSF_FRAME_NOT_COUNTED_BYTES + CRSF_FRAME_SIZE(payloadLen);
+
+    if (ref->framesUntilKey != 0 && ref->addr == frame[0] && ref->payloadLen == payloadLen)
+    {
+        uint8_t const bitmapLen = (payloadLen + 7) / 8;
+        uint8_t *bitmap = &out[2];
+        uint8_t size = 2 + bitmapLen;
+        memset(bitmap, 0, bitmapLen);
+        for (uint8_t i = 0; i < payloadLen; i++)
+        {
+            if (payload[i] != ref->payload[i])
+            {
+                bitmap[i / 8] |= 1 << (i % 8);
+                out[size++] = payload[i];
+            }
+        }
+
+        if (size < keyframeSize)
+        {
+            out[0] = TLM_COMPACT_MARKER | TLM_COMPACT_DELTA | ref->seq;
+            out[1] = type;
+            memcpy(ref->payload, payload, payloadLen);
+            ref->framesUntilKey--;
+            return size;
+        }
+    }
+
+    out[0] = TLM_COMPACT_MARKER | ref->seq;
+    memcpy(&out[1], frame, keyframeSize - 1);
+    ref->addr = frame[0];
+    ref->payloadLen = payloadLen;
+    memcpy(ref->payload, payload, payloadLen);
+    ref->framesUntilKey = TLM_COMPACT_KEYFRAME_INTERVAL;
+    return keyframeSize;
+}
+
+bool TelemetryCompactDecoder::Decode(uint8_t const *data, uint8_t *frameOut)
+{
+    uint8_t const seq = data[0] & TLM_COMPACT_SEQ_MASK;
+    bool const isDelta = data[0] & TLM_COMPACT_DELTA;
+    uint8_t const type = isDelta ? data[1] : data[1 + CRSF_TELEMETRY_TYPE_INDEX];
+    tlm_compact_ref_t *ref = GetRef(type);
+    if (ref == nullptr)
+    {
+        return false;
+    }
+
+    if (isDelta)
+    {
+        // The previous frame of this type was lost, so the reference is out of date
+        if (ref->framesUntilKey == 0 || seq != ((ref->seq + 1) & TLM_COMPACT_SEQ_MASK))
+        {
+            ref->framesUntilKey = 0;
+            return false;
+        }
+
+        uint8_t const *bitmap = &data[2];
+        uint8_t const *changed = &data[2 + (ref->payloadLen + 7) / 8];
+        for (uint8_t i = 0; i < ref->payloadLen; i++)
+        {
+            if (bitmap[i / 8] & (1 << (i % 8)))
+            {
+                ref->payload[i] = *changed++;
+            }
+        }
+    }
+    else
+    {
+        uint8_t const payloadLen = data[1 + CRSF_TELEMETRY_LENGTH_INDEX] - CRSF_FRAME_SIZE(0);
+        if (payloadLen > TLM_COMPACT_MAX_PAYLOAD)
+        {
+            return false;
+        }
+        ref->addr = data[1];
+        ref->payloadLen = payloadLen;
+        memcpy(ref->payload, &data[1 + CRSF_TELEMETRY_TYPE_INDEX + 1], payloadLen);
+    }
+    ref->seq = seq;
+    ref->framesUntilKey = 1;
+
+    frameOut[0] = ref->addr;
+    frameOut[CRSF_TELEMETRY_LENGTH_INDEX] = CRSF_FRAME_SIZE(ref->payloadLen);
+    frameOut[CRSF_TELEMETRY_TYPE_INDEX] = type;
+    memcpy(&frameOut[CRSF_TELEMETRY_TYPE_INDEX + 1], ref->payload, ref->payloadLen);
+    frameOut[CRSF_TELEMETRY_TYPE_INDEX + 1 + ref->payloadLen] =
+        crsf_crc.calc(&frameOut[CRSF_TELEMETRY_TYPE_INDEX], ref->payloadLen + 1);
+    return true;
+}
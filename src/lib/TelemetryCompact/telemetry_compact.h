@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include "crsf_protocol.h"
+
+/**
+ * Compact encoding of the downlink CRSF telemetry frames sent through the StubbornSender.
+ * Sensor frames which are sent periodically only change a few bytes between updates, so the
+ * RX sends just the changed bytes and the TX rebuilds the full CRSF frame, including its CRC,
+ * before passing it to the handset. Frame types without a reference slot are sent unchanged.
+ *
+ * The TX requests compact encoding with MSP_ELRS_TLM_COMPACT once connected, so an RX never
+ * sends compact frames to a TX which can't decode them.
+ *
+ * Keyframe: [TLM_COMPACT_MARKER | seq, addr, frame_size, type, payload...]
+ *     the CRSF frame without its CRC
+ * Delta:    [TLM_COMPACT_MARKER | TLM_COMPACT_DELTA | seq, type, bitmap..., changed bytes...]
+ *     one bitmap bit per payload byte, LSB first, set if the byte is included
+ *
+ * seq counts the frames of each type, a delta is only applied if the previous frame of its
+ * type was decoded, else it is dropped until the next keyframe.
+ **/
+
+// Not a valid CRSF address, so compact frames can't be confused with full frames
+#define TLM_COMPACT_MARKER          0x20
+#define TLM_COMPACT_MARKER_MASK     0xF0
+#define TLM_COMPACT_DELTA           0x08
+#define TLM_COMPACT_SEQ_MASK        0x07
+#define TLM_COMPACT_VERSION         1
+// A keyframe is sent after this many deltas of the same type
+#define TLM_COMPACT_KEYFRAME_INTERVAL 8
+#define TLM_COMPACT_MAX_PAYLOAD     CRSF_FRAME_GPS_PAYLOAD_SIZE
+
+typedef struct {
+    uint8_t addr;
+    uint8_t payloadLen;
+    uint8_t seq;
+    uint8_t framesUntilKey; // 0 if there is no valid reference
+    uint8_t payload[TLM_COMPACT_MAX_PAYLOAD];
+} tlm_compact_ref_t;
+
+class TelemetryCompact
+{
+public:
+    TelemetryCompact() { Reset(); }
+    // Forget all references, every type starts again with a keyframe
+    void Reset();
+
+    static bool IsCompact(uint8_t const *data) { return (data[0] & TLM_COMPACT_MARKER_MASK) == TLM_COMPACT_MARKER; }
+
+protected:
+    tlm_compact_ref_t *GetRef(uint8_t type);
+
+private:
+    // GPS, BATTERY_SENSOR, ATTITUDE, VARIO, BARO_ALTITUDE
+    tlm_compact_ref_t refs[5];
+};
+
+class TelemetryCompactEncoder : public TelemetryCompact
+{
+public:
+    /**
+     * @brief Handle the TX's MSP_ELRS_TLM_COMPACT request, which is sent once per connection
+     * @param version the version the TX decodes, compact frames are only sent if it matches
+     */
+    void HandleRequest(uint8_t version)
+    {
+        enabled = version == TLM_COMPACT_VERSION;
+        Reset();
+    }
+
+    // The connection is lost, the next TX has to ask again
+    void Disable() { enabled = false; }
+    bool IsEnabled() const { return enabled; }
+
+    /**
+     * @brief Encode a CRSF frame if the TX asked for compact frames
+     * @return the size of the encoded frame, or 0 if the frame should be sent unchanged
+     */
+    uint8_t EncodeIfEnabled(uint8_t const *frame, uint8_t *out) { return enabled ? Encode(frame, out) : 0; }
+
+    /**
+     * @brief Encode a CRSF frame
+     * @param out at least CRSF_FRAME_SIZE_MAX bytes
+     * @return the size of the encoded frame, or 0 if the frame should be sent unchanged
+     */
+    uint8_t Encode(uint8_t const *frame, uint8_t *out);
+
+private:
+    bool enabled = false;
+};
+
+class TelemetryCompactDecoder : public TelemetryCompact
+{
+public:
+    /**
+     * @brief Rebuild the CRSF frame from a compact frame
+     * @param frameOut at least CRSF_FRAME_SIZE_MAX bytes
+     * @return false if the frame can not be decoded and should be dropped
+     */
+    bool Decode(uint8_t const *data, uint8_t *frameOut);
+};
@@ -14,4 +14,15 @@
 #define ELRS_MSP_BUFFER 65
 #define ELRS_MSP_MAX_PACKAGES ((ELRS_MSP_BUFFER/ELRS4_MSP_BYTES_PER_CALL)+1)
 
+// Selective acknowledgement (SACK) byte sent by a StubbornReceiver to a windowed StubbornSender
+// bit 7:    set by receivers which support SACK, older firmware sends 0
+// bits 6-3: the next package index the receiver is expecting, modulo 16
+// bits 2-0: which of the 3 packages after that have already been received
+#define STUBBORN_SACK_PRESENT 0x80
+#define STUBBORN_SACK_BASE_SHIFT 3
+#define STUBBORN_SACK_BASE_MASK 0x0F
+#define STUBBORN_SACK_BITMAP_MASK 0x07
+// The number of packages a windowed sender can have in flight, the base plus the bitmap
+#define STUBBORN_SACK_WINDOW 4
+
 #define AP_MAX_BUF_LEN  64
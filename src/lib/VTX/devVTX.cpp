@@ -35,7 +35,7 @@ void VtxTriggerSend()
 {
     VtxSendState = VTXSS_MODIFIED;
     sendEepromWrite = true;
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_VTX_CHANGED);
 }
 
 void VtxPitmodeSwitchUpdate()
@@ -174,5 +174,6 @@ device_t VTX_device = {
     .initialize = initialize,
     .start = NULL,
     .event = event,
-    .timeout = timeout
+    .timeout = timeout,
+    .events = EVENT_CONNECTION_CHANGED | EVENT_VTX_CHANGED
 };
@@ -0,0 +1,88 @@
+#include "WarmStart.h"
+#include "crc.h"
+
+#define WARM_START_MAGIC 0x52575345 // "ESWR"
+#define WARM_START_CRC16_POLY 0x3D65 // ELRS_CRC16_POLY
+
+typedef struct {
+    uint32_t magic;
+    warm_start_state_t state;
+    uint16_t crc;           // CRC16 of the state
+    uint16_t unused;
+} warm_start_record_t;
+
+static_assert(sizeof(warm_start_record_t) % 4 == 0, "RTC user memory is accessed in 4 byte blocks");
+
+#if defined(PLATFORM_ESP32)
+#include <esp_attr.h>
+// Not cleared on boot, only the magic and CRC tell a record from whatever the RAM held at power on
+RTC_NOINIT_ATTR static warm_start_record_t rtcRecord;
+
+static void readRecord(warm_start_record_t *record) { *record = rtcRecord; }
+static void writeRecord(const warm_start_record_t &record) { rtcRecord = record; }
+
+#elif defined(PLATFORM_ESP8266)
+#include <Arduino.h>
+// In 4 byte blocks, clear of the first 128 bytes which are used by OTA updates
+#define WARM_START_RTC_OFFSET 64
+
+static void readRecord(warm_start_record_t *record)
+{
+    if (!ESP.rtcUserMemoryRead(WARM_START_RTC_OFFSET, (uint32_t *)record, sizeof(*record)))
+    {
+        record->magic = 0;
+    }
+}
+
+static void writeRecord(const warm_start_record_t &record)
+{
+    ESP.rtcUserMemoryWrite(WARM_START_RTC_OFFSET, (uint32_t *)&record, sizeof(record));
+}
+
+#else
+// Native tests, where a "reset" keeps the process running
+static warm_start_record_t rtcRecord;
+
+static void readRecord(warm_start_record_t *record) { *record = rtcRecord; }
+static void writeRecord(const warm_start_record_t &record) { rtcRecord = record; }
+#endif
+
+static uint16_t stateCrc(const warm_start_state_t &state)
+{
+    static Crc2Byte crc;
+    crc.init(16, WARM_START_CRC16_POLY);
+    return crc.calc((uint8_t *)&state, sizeof(state), 0);
+}
+
+void WarmStartSave(const warm_start_state_t &state)
+{
+    warm_start_record_t record;
+    record.magic = WARM_START_MAGIC;
+    record.state = state;
+    record.crc = stateCrc(state);
+    record.unused = 0;
+    writeRecord(record);
+}
+
+bool WarmStartLoad(warm_start_state_t *state)
+{
+    warm_start_record_t record;
+    readRecord(&record);
+    if (record.magic != WARM_START_MAGIC || record.crc != stateCrc(record.state))
+    {
+        return false;
+    }
+    *state = record.state;
+    return true;
+}
+
+void WarmStartClear()
+{
+    warm_start_record_t record;
+    readRecord(&record);
+    if (record.magic != 0)
+    {
+        record.magic = 0;
+        writeRecord(record);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * The state of a live link, kept by the RX in memory which survives a reset (RTC memory on ESP) so
+ * that after a brownout or watchdog reset it listens on the rate it was connected on and resumes
+ * output on the first sync packet, instead of scanning the rates and waiting to lock again.
+ *
+ * The nonce and FHSS position are not kept, with no clock running across the reset there is no way
+ * to know how far the TX has moved on, and the first sync packet carries both.
+ */
+typedef struct {
+    uint32_t uidSeed;       // uidMacSeedGet() of the binding, a record for another is not used
+    uint8_t rateIndex;      // air rate index the link was connected on
+    uint8_t switchMode;     // OtaSwitchMode_e
+    uint8_t tlmDenom;       // ExpressLRS_currTlmDenom
+    uint8_t unused;
+    int32_t freqOffset;     // hwTimer frequency offset, the error of the RX crystal against the TX
+} warm_start_state_t;
+
+/**
+ * @brief Keep the state for the next boot, called periodically while connected
+ */
+void WarmStartSave(const warm_start_state_t &state);
+
+/**
+ * @brief Get the state kept before the last reset
+ * @return false if there is none, or it is corrupt (e.g. RTC memory after a power on)
+ */
+bool WarmStartLoad(warm_start_state_t *state);
+
+/**
+ * @brief Forget the state, once the link it describes has gone
+ */
+void WarmStartClear();
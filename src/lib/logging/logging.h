@@ -14,9 +14,9 @@
  * Set LOGGING_UART define to Serial instance to use if not Serial
  **/
 
-// DEBUG_LOG_VERBOSE and DEBUG_RX_SCOREBOARD implies DEBUG_LOG
+// DEBUG_LOG_VERBOSE, DEBUG_RX_SCOREBOARD and DEBUG_ISR_TRACE implies DEBUG_LOG
 #if !defined(DEBUG_LOG)
-  #if defined(DEBUG_LOG_VERBOSE) || (defined(DEBUG_RX_SCOREBOARD) && TARGET_RX) || defined(DEBUG_INIT)
+  #if defined(DEBUG_LOG_VERBOSE) || (defined(DEBUG_RX_SCOREBOARD) && TARGET_RX) || defined(DEBUG_INIT) || defined(DEBUG_ISR_TRACE)
     #define DEBUG_LOG
   #endif
 #endif
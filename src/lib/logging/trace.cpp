@@ -0,0 +1,44 @@
+#include "trace.h"
+
+#if defined(DEBUG_ISR_TRACE)
+#include "logging.h"
+
+// Dump a few events at a time so the main loop is not held up writing the log, this is
+// about 13KB/s of log output which needs the logging UART at 420000 baud or more.
+// The buffer is overwritten faster than this at high packet rates, so the log is
+// a series of runs of consecutive events.
+#define TRACE_DUMP_INTERVAL_MS 10
+#define TRACE_DUMP_BATCH 8
+
+TraceBuffer<TRACE_BUFFER_SIZE> isrTrace;
+
+void traceDump(uint32_t now)
+{
+    static uint32_t lastDump;
+    static uint32_t cursor;
+    static bool started;
+
+    if (now - lastDump < TRACE_DUMP_INTERVAL_MS)
+    {
+        return;
+    }
+    lastDump = now;
+
+    uint32_t lost = 0;
+    trace_entry_t entry;
+    for (uint8_t i = 0; i < TRACE_DUMP_BATCH && isrTrace.read(cursor, entry, lost); i++)
+    {
+        if (lost || !started)
+        {
+#if defined(PLATFORM_ESP8266) || defined(PLATFORM_ESP32)
+            DBGLN("T,L,%u,%u", lost, ESP.getCpuFreqMHz());
+#else
+            DBGLN("T,L,%u,1", lost);
+#endif
+            lost = 0;
+            started = true;
+        }
+        DBGLN("T,%u,%u", entry.event, entry.timestamp);
+    }
+}
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "targets.h"
+#include <atomic>
+
+/**
+ * ISR latency tracing. Define DEBUG_ISR_TRACE to record a timestamp at each TRACE() probe
+ * into a RAM ring buffer, which is drained to the logging UART by traceDump() from the main
+ * loop. Timestamps are CPU cycle counts on ESP8266/ESP32 and micros() elsewhere.
+ * Decode the log with python/test_tools/trace_decode.py to get per-event latency histograms.
+ * With DEBUG_ISR_TRACE undefined the probes compile to nothing.
+ *
+ * Log lines are:
+ *   T,<event>,<timestamp>       - an event, see traceEvent_e
+ *   T,L,<lost>,<ticksPerUs>     - start of a new run of events, <lost> events were overwritten before being dumped
+ **/
+
+// Event IDs are part of the log format, only add to the end
+typedef enum : uint8_t {
+    TRACE_TIMER_CALLBACK,   // TX timerCallback()
+    TRACE_SEND_RC_DATA,     // TX SendRCdataToRF()
+    TRACE_TIMER_TICK,       // RX HWtimerCallbackTick()
+    TRACE_TIMER_TOCK,       // RX HWtimerCallbackTock()
+    TRACE_RX_DONE,          // RXdoneISR()
+    TRACE_TX_DONE,          // TXdoneISR()
+    TRACE_PROCESS_RF_BEGIN, // RX ProcessRFPacket() entry
+    TRACE_PROCESS_RF_END,   // RX ProcessRFPacket() exit
+} traceEvent_e;
+
+typedef struct {
+    uint32_t timestamp;
+    uint8_t event;
+} trace_entry_t;
+
+/**
+ * @brief Ring buffer of trace events, the newest N events are kept.
+ *
+ * Any number of writers claim a slot with one atomic increment, so writers in different ISRs
+ * do not need to mask interrupts. The reader keeps its own cursor and is told how many events
+ * were overwritten before it got to them. Writers are expected to be ISRs on the same core as
+ * the reader, so a claimed slot is always written by the time the reader can see it.
+ *
+ * @tparam N number of events, must be a power of two
+ */
+template <uint32_t N>
+class TraceBuffer
+{
+    static_assert(N != 0 && (N & (N - 1)) == 0, "TraceBuffer size must be a power of two");
+
+private:
+    trace_entry_t entries[N];
+    std::atomic<uint32_t> head{0};
+
+public:
+    void ICACHE_RAM_ATTR inline record(uint8_t event, uint32_t timestamp)
+    {
+        trace_entry_t &entry = entries[head.fetch_add(1, std::memory_order_relaxed) & (N - 1)];
+        entry.timestamp = timestamp;
+        entry.event = event;
+    }
+
+    /**
+     * @brief Read the event at `cursor` and advance it
+     *
+     * @param lost incremented by the number of events which were overwritten before they could be read
+     * @return false if there are no more events
+     */
+    bool read(uint32_t &cursor, trace_entry_t &entry, uint32_t &lost) const
+    {
+        while (true)
+        {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (h - cursor > N)
+            {
+                lost += h - cursor - N;
+                cursor = h - N;
+            }
+            if (cursor == h)
+            {
+                return false;
+            }
+            entry = entries[cursor & (N - 1)];
+            // Only keep the copy if the slot was not reused while it was being read
+            if (head.load(std::memory_order_acquire) - cursor <= N)
+            {
+                cursor++;
+                return true;
+            }
+        }
+    }
+};
+
+#if defined(DEBUG_ISR_TRACE)
+#if !defined(TRACE_BUFFER_SIZE)
+#define TRACE_BUFFER_SIZE 128
+#endif
+
+extern TraceBuffer<TRACE_BUFFER_SIZE> isrTrace;
+
+static inline uint32_t ICACHE_RAM_ATTR traceTimestamp()
+{
+#if defined(PLATFORM_ESP8266) || defined(PLATFORM_ESP32)
+    return ESP.getCycleCount();
+#else
+    return micros();
+#endif
+}
+
+#define TRACE(event) isrTrace.record(event, traceTimestamp())
+
+// Write some of the recorded events to the logging UART, call from the main loop
+void traceDump(uint32_t now);
+#else
+#define TRACE(event)
+#define traceDump(now)
+#endif
@@ -7,6 +7,7 @@ import sys
 
 from external import jmespath
 from firmware import TXType
+import hardware_blob
 
 
 def findFirmwareEnd(f):
@@ -58,7 +59,7 @@ def appendToFirmware(firmware_file, product_name, lua_name, defines, config, lay
                     if 'led_red' not in hardware and 'led' in hardware:
                         hardware['led_red'] = hardware['led']
                         del hardware['led']
-                layout = (json.JSONEncoder().encode(hardware).encode() + (b'\0' * 2048))[0:2048]
+                layout = hardware_blob.layout(hardware, 2048)
                 firmware_file.write(layout)
         except EnvironmentError:
             sys.stderr.write(f'Error opening file "{layout_file}"\n')
@@ -0,0 +1,94 @@
+#!/usr/bin/python
+
+# Builds the binary form of a hardware layout which the firmware reads at boot instead of parsing
+# the JSON, see lib/OPTIONS/HardwareBlob.h for the layout
+
+import argparse
+import json
+import struct
+
+HARDWARE_BLOB_MAGIC = 0x57484C45 # "ELHW"
+HARDWARE_BLOB_VERSION = 1
+ELRS_CRC16_POLY = 0x3D65
+
+TYPE_INT = 0
+TYPE_BOOL = 1
+TYPE_FLOAT = 2
+TYPE_ARRAY = 3
+
+entry_struct = struct.Struct('<HBB4s')
+trailer_struct = struct.Struct('<IBBHHH')
+
+def key(name):
+    hash = 0x811C9DC5
+    for c in name.encode():
+        hash = ((hash ^ c) * 0x01000193) & 0xFFFFFFFF
+    return (hash >> 16) ^ (hash & 0xFFFF)
+
+def crc16(data):
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ ELRS_CRC16_POLY) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+def encode(hardware):
+    """
+    Returns the blob and its trailer for the hardware layout, or None if it has something
+    the binary form cannot hold, in which case the firmware uses the JSON
+    """
+    items = []
+    for (name, value) in hardware.items():
+        if isinstance(value, list):
+            if len(value) > 255 or not all(isinstance(v, int) and not isinstance(v, bool) for v in value):
+                return None
+        elif not isinstance(value, (bool, int, float)):
+            continue # no field of the firmware is a string or object
+        items.append((key(name), value))
+    items.sort(key=lambda item: item[0])
+    keys = [k for (k, _) in items]
+    if len(set(keys)) != len(keys) or len(items) > 255:
+        return None
+
+    entries = b''
+    arrays = b''
+    arrays_start = len(items) * entry_struct.size
+    try:
+        for (k, value) in items:
+            if isinstance(value, bool):
+                entries += entry_struct.pack(k, TYPE_BOOL, 0, struct.pack('<i', int(value)))
+            elif isinstance(value, int):
+                entries += entry_struct.pack(k, TYPE_INT, 0, struct.pack('<i', value))
+            elif isinstance(value, float):
+                entries += entry_struct.pack(k, TYPE_FLOAT, 0, struct.pack('<f', value))
+            else:
+                entries += entry_struct.pack(k, TYPE_ARRAY, len(value), struct.pack('<I', arrays_start + len(arrays)))
+                arrays += struct.pack(f'<{len(value)}h', *value)
+    except struct.error:
+        return None
+
+    blob = entries + arrays
+    blob += b'\0' * (-len(blob) % 4)
+    return blob + trailer_struct.pack(HARDWARE_BLOB_MAGIC, HARDWARE_BLOB_VERSION, len(items), len(blob), crc16(blob), 0)
+
+def layout(hardware, size):
+    """The JSON, and the blob at the end of the area if there is room for both"""
+    text = json.JSONEncoder().encode(hardware).encode()
+    blob = encode(hardware)
+    if blob is None or len(text) + 1 > size - len(blob):
+        return (text + (b'\0' * size))[0:size]
+    return text + (b'\0' * (size - len(text) - len(blob))) + blob
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Convert a hardware layout file to its binary form")
+    parser.add_argument("layout", type=argparse.FileType("r"), help="The hardware layout JSON file")
+    parser.add_argument("output", type=argparse.FileType("wb"), help="The file to write the blob to")
+    args = parser.parse_args()
+
+    blob = encode(json.load(args.layout))
+    if blob is None:
+        print('The layout cannot be converted, the firmware will use the JSON')
+        exit(1)
+    args.output.write(blob)
@@ -0,0 +1,127 @@
+# Decodes the ISR trace written to the log by firmware compiled with -DDEBUG_ISR_TRACE
+# and prints a latency histogram for each event period and each pair of related events.
+# Read from a saved log file or directly from a serial port, e.g.
+#   python trace_decode.py rx.log
+#   python trace_decode.py --port /dev/ttyUSB0 --baud 420000 --seconds 10
+# Lines in the log which are not trace lines are ignored.
+import argparse
+import sys
+
+# Must match traceEvent_e in lib/logging/trace.h
+EVENTS = [
+    'timerCallback',
+    'SendRCdataToRF',
+    'HWtimerCallbackTick',
+    'HWtimerCallbackTock',
+    'RXdoneISR',
+    'TXdoneISR',
+    'ProcessRFPacket',
+    'ProcessRFPacket end',
+]
+
+# Latency from the first event to the next occurrence of the second
+PAIRS = [
+    (0, 1),  # TX timer -> RC data ready to send
+    (1, 5),  # TX RC data -> TX done
+    (2, 4),  # RX tick -> packet received
+    (3, 4),  # RX tock -> packet received
+    (4, 6),  # RX done -> ProcessRFPacket
+    (6, 7),  # ProcessRFPacket duration
+]
+
+class Histogram:
+    def __init__(self, name):
+        self.name = name
+        self.vals = []
+
+    def add(self, val):
+        self.vals.append(val)
+
+    def show(self, bucket_us):
+        if not self.vals:
+            return
+        vals = sorted(self.vals)
+        n = len(vals)
+        print(f'{self.name}: n={n} min={vals[0]:.1f} p50={vals[n // 2]:.1f} '
+              f'p99={vals[min(n - 1, n * 99 // 100)]:.1f} max={vals[-1]:.1f} '
+              f'mean={sum(vals) / n:.1f} us')
+        buckets = {}
+        for v in vals:
+            b = int(v // bucket_us)
+            buckets[b] = buckets.get(b, 0) + 1
+        peak = max(buckets.values())
+        for b in range(min(buckets), max(buckets) + 1):
+            count = buckets.get(b, 0)
+            if count:
+                print(f'  {b * bucket_us:8.1f} {count:7d} {"#" * max(1, count * 50 // peak)}')
+        print()
+
+class Decoder:
+    def __init__(self):
+        self.ticks_per_us = 1
+        self.last = {}
+        self.lost_events = 0
+        self.periods = {e: Histogram(f'{EVENTS[e]} period') for e in range(len(EVENTS))}
+        self.pairs = {p: Histogram(f'{EVENTS[p[0]]} -> {EVENTS[p[1]]}') for p in PAIRS}
+
+    def elapsed_us(self, start, end):
+        return ((end - start) & 0xffffffff) / self.ticks_per_us
+
+    def line(self, line):
+        parts = line.strip().split(',')
+        if len(parts) < 3 or parts[0] != 'T':
+            return
+        try:
+            if parts[1] == 'L':
+                # Events were lost, so the previous timestamps can't be paired with new ones
+                self.lost_events += int(parts[2])
+                self.ticks_per_us = int(parts[3])
+                self.last = {}
+                return
+            event = int(parts[1])
+            stamp = int(parts[2])
+        except (ValueError, IndexError):
+            return
+        if event >= len(EVENTS):
+            return
+        if event in self.last:
+            self.periods[event].add(self.elapsed_us(self.last[event], stamp))
+        for (first, second), hist in self.pairs.items():
+            if second == event and first in self.last:
+                hist.add(self.elapsed_us(self.last[first], stamp))
+                # Only pair the first occurrence after each start event
+                del self.last[first]
+        self.last[event] = stamp
+
+    def show(self, bucket_us):
+        for hist in self.periods.values():
+            hist.show(bucket_us)
+        for hist in self.pairs.values():
+            hist.show(bucket_us)
+        print(f'Events lost before they were logged: {self.lost_events}')
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode DEBUG_ISR_TRACE log output into latency histograms')
+    parser.add_argument('file', nargs='?', help='log file to read, stdin if omitted and no --port')
+    parser.add_argument('--port', help='serial port to read the log from')
+    parser.add_argument('--baud', type=int, default=420000, help='serial baud rate')
+    parser.add_argument('--seconds', type=float, default=10, help='how long to read the serial port for')
+    parser.add_argument('--bucket', type=float, default=5, help='histogram bucket size in us')
+    args = parser.parse_args()
+
+    decoder = Decoder()
+    if args.port:
+        import serial
+        import time
+        with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+            end = time.time() + args.seconds
+            while time.time() < end:
+                decoder.line(port.readline().decode('ascii', errors='ignore'))
+    else:
+        with (open(args.file) if args.file else sys.stdin) as f:
+            for line in f:
+                decoder.line(line)
+    decoder.show(args.bucket)
+
+if __name__ == '__main__':
+    main()
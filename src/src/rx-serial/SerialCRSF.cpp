@@ -49,14 +49,15 @@ void SerialCRSF::queueLinkStatisticsPacket()
     uint8_t crc = crsf_crc.calc(outBuffer[3]);
     crc = crsf_crc.calc((byte *)&CRSF::LinkStatistics, payloadLen, crc);
 
-    _fifo.lock();
-    if (_fifo.ensure(outBuffer[0] + 1))
+    lockFifoProducer();
+    if (_fifo.free() >= outBuffer[0] + 1)
     {
-        _fifo.pushBytes(outBuffer, sizeof(outBuffer));
-        _fifo.pushBytes((byte *)&CRSF::LinkStatistics, payloadLen);
-        _fifo.push(crc);
+        _fifo.writeBytes(outBuffer, sizeof(outBuffer));
+        _fifo.writeBytes((byte *)&CRSF::LinkStatistics, payloadLen);
+        _fifo.write(crc);
+        _fifo.commitWrite();
     }
-    _fifo.unlock();
+    unlockFifoProducer();
 }
 
 uint32_t SerialCRSF::sendRCFrame(bool frameAvailable, bool frameMissed, uint32_t *channelData)
@@ -65,35 +66,23 @@ uint32_t SerialCRSF::sendRCFrame(bool frameAvailable, bool frameMissed, uint32_t
         return DURATION_IMMEDIATELY;
 
     crsf_channels_s PackedRCdataOut;
-    PackedRCdataOut.ch0 = channelData[0];
-    PackedRCdataOut.ch1 = channelData[1];
-    PackedRCdataOut.ch2 = channelData[2];
-    PackedRCdataOut.ch3 = channelData[3];
-    PackedRCdataOut.ch4 = channelData[4];
-    PackedRCdataOut.ch5 = channelData[5];
-    PackedRCdataOut.ch6 = channelData[6];
-    PackedRCdataOut.ch7 = channelData[7];
-    PackedRCdataOut.ch8 = channelData[8];
-    PackedRCdataOut.ch9 = channelData[9];
-    PackedRCdataOut.ch10 = channelData[10];
-    PackedRCdataOut.ch11 = channelData[11];
-    PackedRCdataOut.ch12 = channelData[12];
-    PackedRCdataOut.ch13 = channelData[13];
 
     // In 16ch mode, do not output RSSI/LQ on channels
     if (OtaIsFullRes && OtaSwitchModeCurrent == smHybridOr16ch)
     {
-        PackedRCdataOut.ch14 = channelData[14];
-        PackedRCdataOut.ch15 = channelData[15];
+        CRSF::PackChannels(channelData, &PackedRCdataOut);
     }
     else
     {
         // Not in 16-channel mode, send LQ and RSSI dBm
         int32_t rssiDBM = CRSF::LinkStatistics.active_antenna == 0 ? -CRSF::LinkStatistics.uplink_RSSI_1 : -CRSF::LinkStatistics.uplink_RSSI_2;
 
-        PackedRCdataOut.ch14 = UINT10_to_CRSF(fmap(CRSF::LinkStatistics.uplink_Link_quality, 0, 100, 0, 1023));
-        PackedRCdataOut.ch15 = UINT10_to_CRSF(map(constrain(rssiDBM, ExpressLRS_currAirRate_RFperfParams->RXsensitivity, -50),
-                                                   ExpressLRS_currAirRate_RFperfParams->RXsensitivity, -50, 0, 1023));
+        uint32_t channels[CRSF_NUM_CHANNELS];
+        memcpy(channels, channelData, 14 * sizeof(uint32_t));
+        channels[14] = UINT10_to_CRSF(fmap(CRSF::LinkStatistics.uplink_Link_quality, 0, 100, 0, 1023));
+        channels[15] = UINT10_to_CRSF(map(constrain(rssiDBM, ExpressLRS_currAirRate_RFperfParams->RXsensitivity, -50),
+                                          ExpressLRS_currAirRate_RFperfParams->RXsensitivity, -50, 0, 1023));
+        CRSF::PackChannels(channels, &PackedRCdataOut);
     }
 
     constexpr uint8_t outBuffer[] = {
@@ -118,10 +107,14 @@ void SerialCRSF::queueMSPFrameTransmission(uint8_t* data)
     if (totalBufferLen <= CRSF_FRAME_SIZE_MAX)
     {
         data[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
-        _fifo.lock();
-        _fifo.push(totalBufferLen);
-        _fifo.pushBytes(data, totalBufferLen);
-        _fifo.unlock();
+        lockFifoProducer();
+        if (_fifo.free() >= totalBufferLen + 1)
+        {
+            _fifo.write(totalBufferLen);
+            _fifo.writeBytes(data, totalBufferLen);
+            _fifo.commitWrite();
+        }
+        unlockFifoProducer();
     }
 }
 
@@ -20,13 +20,20 @@ void SerialIO::sendQueuedData(uint32_t maxBytesToSend)
 
     while (_fifo.size() > _fifo.peek() && (bytesWritten + _fifo.peek()) < maxBytesToSend)
     {
-        _fifo.lock();
         uint8_t OutPktLen = _fifo.pop();
-        uint8_t OutData[OutPktLen];
-        _fifo.popBytes(OutData, OutPktLen);
-        _fifo.unlock();
+        uint8_t remaining = OutPktLen;
         noInterrupts();
-        this->_outputPort->write(OutData, OutPktLen); // write the packet out
+        // write the packet out directly from the FIFO, in two parts if it wraps
+        while (remaining)
+        {
+            const uint8_t *OutData;
+            uint16_t spanLen = _fifo.peekSpan(&OutData);
+            if (spanLen > remaining)
+                spanLen = remaining;
+            this->_outputPort->write(OutData, spanLen);
+            _fifo.commitRead(spanLen);
+            remaining -= spanLen;
+        }
         interrupts();
         bytesWritten += OutPktLen;
     }
@@ -2,6 +2,7 @@
 
 #include "targets.h"
 #include "FIFO.h"
+#include "SPSCFIFO.h"
 #include "device.h"
 
 /**
@@ -117,7 +118,26 @@ protected:
      * @brief the FIFO that should be used to queue serial data to in the
      * `queueLinkStatisticsPacket` and `queueMSPFrameTransmission` method implementations.
      */
-    FIFO<SERIAL_OUTPUT_FIFO_SIZE> _fifo;
+    SPSCFIFO<SERIAL_OUTPUT_FIFO_SIZE> _fifo;
+
+    /**
+     * @brief Serialise the producers of `_fifo`, held from the free() check to commitWrite().
+     * The FIFO has one consumer (sendQueuedData in the loop) but not one producer: on ESP32
+     * MSPVTX queues frames from its device task on core 0 while the loop queues on core 1.
+     */
+    void lockFifoProducer()
+    {
+#if defined(PLATFORM_ESP32)
+        portENTER_CRITICAL(&_fifoProducerMux);
+#endif
+    }
+
+    void unlockFifoProducer()
+    {
+#if defined(PLATFORM_ESP32)
+        portEXIT_CRITICAL(&_fifoProducerMux);
+#endif
+    }
 
     /**
      * @brief Get the maximum number of bytes to read from the serial port per call
@@ -136,6 +156,9 @@ protected:
     virtual void processBytes(uint8_t *bytes, uint16_t size) = 0;
 
 private:
+#if defined(PLATFORM_ESP32)
+    portMUX_TYPE _fifoProducerMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
     const int defaultMaxSerialReadSize = 64;
     const int defaultMaxSerialWriteSize = 128;
 
@@ -2,14 +2,22 @@
 #include "CRSF.h"
 #include "device.h"
 #include "config.h"
+#include "RxSerialEncoders.h"
 
 #if defined(TARGET_RX)
 
-#define SBUS_FLAG_SIGNAL_LOSS       (1 << 2)
-#define SBUS_FLAG_FAILSAFE_ACTIVE   (1 << 3)
-
 const auto UNCONNECTED_CALLBACK_INTERVAL_MS = 10;
-const auto SBUS_CALLBACK_INTERVAL_MS = 9;
+
+// 100000 baud 8E2, FCs take a frame starting more than 3.5ms after the last one as the next
+constexpr uint32_t SBUS_MIN_GAP_US = RxSerialScheduler::wireTimeUs(100000, 12, SBUS_FRAME_LEN) + 500;
+// Indexed by eSbusRate
+static const uint32_t sbusPeriodUs[] = {9000, 7000, 5000, 4000};
+
+SerialSBUS::SerialSBUS(Stream &out, Stream &in) : SerialIO(&out, &in)
+{
+    streamOut = &out;
+    scheduler.configure(SBUS_MIN_GAP_US, sbusPeriodUs[config.GetSbusRate()]);
+}
 
 uint32_t SerialSBUS::sendRCFrame(bool frameAvailable, bool frameMissed, uint32_t *channelData)
 {
@@ -21,70 +29,37 @@ uint32_t SerialSBUS::sendRCFrame(bool frameAvailable, bool frameMissed, uint32_t
     }
     sendPackets = true;
 
-    if ((!frameAvailable && !frameMissed && !effectivelyFailsafed) || _outputPort->availableForWrite() < 25)
+    // Send as the channels arrive, or repeat the last ones if none are coming
+    const uint32_t now = micros();
+    const uint32_t packetIntervalUs = ExpressLRS_currAirRate_Modparams->interval * ExpressLRS_currAirRate_Modparams->numOfSends;
+    const bool sendNow = (frameAvailable || frameMissed)
+        ? scheduler.packetArrived(now, packetIntervalUs)
+        : scheduler.keepaliveDue(now, packetIntervalUs);
+    if (!sendNow || _outputPort->availableForWrite() < SBUS_FRAME_LEN)
     {
         return DURATION_IMMEDIATELY;
     }
 
     // TODO: if failsafeMode == FAILSAFE_SET_POSITION then we use the set positions rather than the last values
-    crsf_channels_s PackedRCdataOut;
-
 #if defined(PLATFORM_ESP32)
     extern Stream* serial_protocol_tx;
     extern Stream* serial1_protocol_tx;
 
-    if (((config.GetSerialProtocol() == PROTOCOL_DJI_RS_PRO) && streamOut == serial_protocol_tx)||
-        ((config.GetSerial1Protocol() == PROTOCOL_SERIAL1_DJI_RS_PRO) && streamOut == serial1_protocol_tx))
+    const bool djiRsPro = ((config.GetSerialProtocol() == PROTOCOL_DJI_RS_PRO) && streamOut == serial_protocol_tx) ||
+        ((config.GetSerial1Protocol() == PROTOCOL_SERIAL1_DJI_RS_PRO) && streamOut == serial1_protocol_tx);
 #else
-    if (config.GetSerialProtocol() == PROTOCOL_DJI_RS_PRO)
+    const bool djiRsPro = config.GetSerialProtocol() == PROTOCOL_DJI_RS_PRO;
 #endif
-    {
-        PackedRCdataOut.ch0 = fmap(channelData[0], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch1 = fmap(channelData[1], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch2 = fmap(channelData[2], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch3 = fmap(channelData[3], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch4 = fmap(channelData[5], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696); // Record start/stop and photo
-        PackedRCdataOut.ch5 = fmap(channelData[6], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696); // Mode
-        PackedRCdataOut.ch6 = fmap(channelData[7], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 176,  848); // Recenter and Selfie
-        PackedRCdataOut.ch7 = fmap(channelData[8], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch8 = fmap(channelData[9], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch9 = fmap(channelData[10], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch10 = fmap(channelData[11], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch11 = fmap(channelData[12], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch12 = fmap(channelData[13], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch13 = fmap(channelData[14], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch14 = fmap(channelData[15], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
-        PackedRCdataOut.ch15 = channelData[4] < CRSF_CHANNEL_VALUE_MID ? 352 : 1696;
-    }
-    else
-    {
-        PackedRCdataOut.ch0 = channelData[0];
-        PackedRCdataOut.ch1 = channelData[1];
-        PackedRCdataOut.ch2 = channelData[2];
-        PackedRCdataOut.ch3 = channelData[3];
-        PackedRCdataOut.ch4 = channelData[4];
-        PackedRCdataOut.ch5 = channelData[5];
-        PackedRCdataOut.ch6 = channelData[6];
-        PackedRCdataOut.ch7 = channelData[7];
-        PackedRCdataOut.ch8 = channelData[8];
-        PackedRCdataOut.ch9 = channelData[9];
-        PackedRCdataOut.ch10 = channelData[10];
-        PackedRCdataOut.ch11 = channelData[11];
-        PackedRCdataOut.ch12 = channelData[12];
-        PackedRCdataOut.ch13 = channelData[13];
-        PackedRCdataOut.ch14 = channelData[14];
-        PackedRCdataOut.ch15 = channelData[15];
-    }
 
     uint8_t extraData = 0;
     extraData |= effectivelyFailsafed ? SBUS_FLAG_FAILSAFE_ACTIVE : 0;
     extraData |= frameMissed ? SBUS_FLAG_SIGNAL_LOSS : 0;
 
-    _outputPort->write(0x0F);    // HEADER
-    _outputPort->write((byte *)&PackedRCdataOut, sizeof(PackedRCdataOut));
-    _outputPort->write((uint8_t)extraData);    // ch 17, 18, lost packet, failsafe
-    _outputPort->write((uint8_t)0x00);    // FOOTER
-    return SBUS_CALLBACK_INTERVAL_MS;
+    uint8_t frame[SBUS_FRAME_LEN];
+    SbusEncodeFrame(frame, channelData, djiRsPro, extraData);
+    _outputPort->write(frame, sizeof(frame));
+    scheduler.frameSent(now);
+    return scheduler.holdoffMs();
 }
 
 #endif
@@ -1,11 +1,9 @@
 #include "SerialIO.h"
+#include "RxSerialScheduler.h"
 
 class SerialSBUS : public SerialIO {
 public:
-    explicit SerialSBUS(Stream &out, Stream &in) : SerialIO(&out, &in)
-    {
-        streamOut = &out;
-    }
+    explicit SerialSBUS(Stream &out, Stream &in);
 
     ~SerialSBUS() override = default;
 
@@ -17,4 +15,5 @@ private:
     void processBytes(uint8_t *bytes, uint16_t size) override {};
 
     Stream *streamOut;
+    RxSerialScheduler scheduler;
 };
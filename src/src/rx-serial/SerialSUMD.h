@@ -1,9 +1,10 @@
 #include "SerialIO.h"
-#include "crc.h"
+#include "RxSerialEncoders.h"
+#include "RxSerialScheduler.h"
 
 class SerialSUMD : public SerialIO {
 public:
-    explicit SerialSUMD(Stream &out, Stream &in) : SerialIO(&out, &in) { crc2Byte.init(16, 0x1021); }
+    explicit SerialSUMD(Stream &out, Stream &in);
     virtual ~SerialSUMD() {}
 
     void queueLinkStatisticsPacket() override {}
@@ -11,6 +12,7 @@ public:
     uint32_t sendRCFrame(bool frameAvailable, bool frameMissed, uint32_t *channelData) override;
 
 private:
-    Crc2Byte crc2Byte;
+    SumdEncoder encoder;
+    RxSerialScheduler scheduler;
     void processBytes(uint8_t *bytes, uint16_t size) override {};
 };
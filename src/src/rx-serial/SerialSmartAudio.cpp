@@ -31,11 +31,9 @@ void SerialSmartAudio::sendQueuedData(uint32_t maxBytesToSend)
     static unsigned long lastSendTime = 0; // we need to delay between sending frames to allow for responses
     while (millis() - lastSendTime > SMARTAUDIO_RESPONSE_DELAY_MS && _fifo.size() > 0 && bytesWritten < maxBytesToSend) // OVTX only changes protocols on startup every 500ms; if we send our 3 packets in different 500ms windows, we have a better chance of success
     {
-        _fifo.lock();
         uint8_t frameSize = _fifo.pop() - 1;
         uint8_t frame[frameSize];
         _fifo.popBytes(frame, frameSize);
-        _fifo.unlock();
         setTXMode();
         _outputPort->write(frame, frameSize);
         bytesWritten += frameSize;
@@ -100,10 +98,14 @@ void SerialSmartAudio::queueMSPFrameTransmission(uint8_t *data)
     tempFrame[frameIndex++] = freq & 0xFF;
     crcValue = crc.calc(tempFrame, frameIndex);
     tempFrame[frameIndex++] = crcValue;
-    _fifo.lock();
-    _fifo.push(frameIndex + 1);
-    _fifo.pushBytes(tempFrame, frameIndex);
-    _fifo.unlock();
+    lockFifoProducer();
+    if (_fifo.free() >= frameIndex + 1)
+    {
+        _fifo.write(frameIndex + 1);
+        _fifo.writeBytes(tempFrame, frameIndex);
+        _fifo.commitWrite();
+    }
+    unlockFifoProducer();
 
     // If packet has more than 4 bytes it also contains power idx and pitmode.
     bool havePowerAndPitmode = innerLength >= 4;
@@ -121,10 +123,14 @@ void SerialSmartAudio::queueMSPFrameTransmission(uint8_t *data)
         tempFrame[frameIndex++] = powerIndex - 1;     // In SA2.1, we send a 0-n "power index"
         crcValue = crc.calc(tempFrame, frameIndex);
         tempFrame[frameIndex++] = crcValue;
-        _fifo.lock();
-        _fifo.push(frameIndex + 1);
-        _fifo.pushBytes(tempFrame, frameIndex);
-        _fifo.unlock();
+        lockFifoProducer();
+        if (_fifo.free() >= frameIndex + 1)
+        {
+            _fifo.write(frameIndex + 1);
+            _fifo.writeBytes(tempFrame, frameIndex);
+            _fifo.commitWrite();
+        }
+        unlockFifoProducer();
 
         uint8_t pitmode = data[11];
         // Set pitmode
@@ -138,9 +144,13 @@ void SerialSmartAudio::queueMSPFrameTransmission(uint8_t *data)
         tempFrame[frameIndex++] = (pitmode ? 0x01 : 0x04); // bit 3 seems to be "clear pitmode" contrary to the docs; see BF, OpenVTX, etc.
         crcValue = crc.calc(tempFrame, frameIndex);
         tempFrame[frameIndex++] = crcValue;
-        _fifo.lock();
-        _fifo.push(frameIndex + 1);
-        _fifo.pushBytes(tempFrame, frameIndex);
-        _fifo.unlock();
+        lockFifoProducer();
+        if (_fifo.free() >= frameIndex + 1)
+        {
+            _fifo.write(frameIndex + 1);
+            _fifo.writeBytes(tempFrame, frameIndex);
+            _fifo.commitWrite();
+        }
+        unlockFifoProducer();
     }
 }
\ No newline at end of file
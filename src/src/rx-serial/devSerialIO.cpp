@@ -212,7 +212,7 @@ static int timeout(devserial_ctx_t *ctx)
      *      - No data received to be sent (interpacket delay)
      *      - Connection does not have model match
      *      - TeamRace enabled but different position selected
-     * However, the SBUS IO writer doesn't go off new data coming in, it just sends data at a 9ms cadence
+     * However, the SBUS IO writer repeats the last data when no new data is coming in, to keep the FC fed,
      * and therefore does not respect any of these conditions, relying on the one-off "failsafe" member
      * modelmatch was addressed in #2211, but resolving the merge conflict here (capnbry) re-breaks it
      *
@@ -277,7 +277,8 @@ device_t Serial0_device = {
     .initialize = nullptr,
     .start = start,
     .event = event0,
-    .timeout = timeout0
+    .timeout = timeout0,
+    .events = EVENT_CONNECTION_CHANGED
 };
 
 #if defined(PLATFORM_ESP32)
@@ -285,7 +286,8 @@ device_t Serial1_device = {
     .initialize = nullptr,
     .start = start,
     .event = event1,
-    .timeout = timeout1
+    .timeout = timeout1,
+    .events = EVENT_CONNECTION_CHANGED
 };
 #endif
 
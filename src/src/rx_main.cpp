@@ -6,6 +6,7 @@
 #include "telemetry.h"
 #include "stubborn_sender.h"
 #include "stubborn_receiver.h"
+#include "telemetry_compact.h"
 
 #include "lua.h"
 #include "msp.h"
@@ -14,7 +15,9 @@
 #include "options.h"
 #include "dynpower.h"
 #include "MeanAccumulator.h"
+#include "RadioPins.h"
 #include "freqTable.h"
+#include "WarmStart.h"
 
 #include "rx-serial/SerialIO.h"
 #include "rx-serial/SerialNOOP.h"
@@ -170,6 +173,9 @@ uint8_t MspData[ELRS_MSP_BUFFER];
 
 uint8_t mavlinkSSBuffer[CRSF_MAX_PACKET_LEN]; // Buffer for current stubbon sender packet (mavlink only)
 
+static TelemetryCompactEncoder TelemetryEncoder;
+static uint8_t telemetryCompactBuffer[CRSF_MAX_PACKET_LEN]; // Buffer for current stubborn sender packet (compact only)
+
 static bool tlmSent = false;
 static uint8_t NextTelemetryType = ELRS_TELEMETRY_TYPE_LINK;
 static bool telemBurstValid;
@@ -224,6 +230,15 @@ uint8_t RFmodeCycleMultiplier;
 bool LockRFmode = false;
 ///////////////////////////////////////
 
+#if defined(RX_WARM_START)
+/// Variables for Warm Start ////
+#define WARM_START_SAVE_INTERVAL 1000 // ms
+static bool warmStart; // booted with the state of a link which was live before a reset
+static warm_start_state_t warmStartState;
+static uint32_t warmStartLastSaved;
+///////////////////////////////////////
+#endif
+
 #if defined(DEBUG_BF_LINK_STATS)
 // Debug vars
 uint8_t debug1 = 0;
@@ -278,7 +293,7 @@ void ICACHE_RAM_ATTR getRFlinkInfo()
 {
     int32_t rssiDBM = Radio.LastPacketRSSI;
 
-    if (GPIO_PIN_NSS_2 != UNDEF_PIN)
+    if (RadioPins.hasSecondRadio)
     {
         int32_t rssiDBM2 = Radio.LastPacketRSSI2;
 
@@ -496,6 +511,7 @@ bool ICACHE_RAM_ATTR HandleSendTelemetryResponse()
         else
         {
             otaPkt.std.tlm_dl.type = ELRS_TELEMETRY_TYPE_LINK;
+            otaPkt.std.tlm_dl.ul_link_stats.mspSack = MspReceiver.GetCurrentSack();
             ls = &otaPkt.std.tlm_dl.ul_link_stats.stats;
         }
         LinkStatsToOta(ls);
@@ -663,6 +679,7 @@ void ICACHE_RAM_ATTR updatePhaseLock()
 
 void ICACHE_RAM_ATTR HWtimerCallbackTick() // this is 180 out of phase with the other callback, occurs mid-packet reception
 {
+    TRACE(TRACE_TIMER_TICK);
     updatePhaseLock();
     OtaNonce++;
 
@@ -697,16 +714,16 @@ void ICACHE_RAM_ATTR HWtimerCallbackTick() // this is 180 out of phase with the
 // no-op if GPIO_PIN_ANT_CTRL not defined
 static inline void switchAntenna()
 {
-    if (GPIO_PIN_ANT_CTRL != UNDEF_PIN && config.GetAntennaMode() == 2)
+    if (RadioPins.antCtrl[0] != UNDEF_PIN && config.GetAntennaMode() == 2)
     {
         // 0 and 1 is use for gpio_antenna_select
         // 2 is diversity
         antenna = !antenna;
         (antenna == 0) ? LPF_UplinkRSSI0.reset() : LPF_UplinkRSSI1.reset(); // discard the outdated value after switching
-        digitalWrite(GPIO_PIN_ANT_CTRL, antenna);
-        if (GPIO_PIN_ANT_CTRL_COMPL != UNDEF_PIN)
+        digitalWrite(RadioPins.antCtrl[0], antenna);
+        if (RadioPins.antCtrl[1] != UNDEF_PIN)
         {
-            digitalWrite(GPIO_PIN_ANT_CTRL_COMPL, !antenna);
+            digitalWrite(RadioPins.antCtrl[1], !antenna);
         }
     }
 }
@@ -714,7 +731,7 @@ static inline void switchAntenna()
 static void ICACHE_RAM_ATTR updateDiversity()
 {
 
-    if (GPIO_PIN_ANT_CTRL != UNDEF_PIN)
+    if (RadioPins.antCtrl[0] != UNDEF_PIN)
     {
         if(config.GetAntennaMode() == 2)
         {
@@ -782,6 +799,7 @@ static void ICACHE_RAM_ATTR updateDiversity()
 
 void ICACHE_RAM_ATTR HWtimerCallbackTock()
 {
+    TRACE(TRACE_TIMER_TOCK);
     PFDloop.intEvent(micros()); // our internal osc just fired
 
     if (ExpressLRS_currAirRate_Modparams->numOfSends > 1 && !(OtaNonce % ExpressLRS_currAirRate_Modparams->numOfSends))
@@ -835,6 +853,12 @@ void LostConnection(bool resumeRx)
     if (connectionState == connected)
         config.SetRateInitialIdx(ExpressLRS_nextAirRateIndex);
 
+#if defined(RX_WARM_START)
+    // The link is gone, a reset from here on should look for it from scratch
+    warmStart = false;
+    WarmStartClear();
+#endif
+
     RFmodeCycleMultiplier = 1;
     connectionState = disconnected; //set lost connection
     RXtimerState = tim_disconnected;
@@ -848,6 +872,7 @@ void LostConnection(bool resumeRx)
     LPF_OffsetDx.init(0);
     alreadyTLMresp = false;
     alreadyFHSS = false;
+    TelemetryEncoder.Disable();
 
     if (!InBindingMode)
     {
@@ -889,6 +914,10 @@ void GotConnection(unsigned long now)
     }
 
     LockRFmode = firmwareOptions.lock_on_first_connection;
+#if defined(RX_WARM_START)
+    warmStart = false;
+    warmStartLastSaved = now - WARM_START_SAVE_INTERVAL; // save on the next loop()
+#endif
 
     connectionState = connected; //we got a packet, therefore no lost connection
     RXtimerState = tim_tentative;
@@ -1001,9 +1030,11 @@ static void ICACHE_RAM_ATTR ProcessRfPacket_MSP(OTA_Packet_s const * const otaPk
     if (connectionState != connected)
         return;
 
+    // Send link stats when the confirm changes, or the SACK does because packages were received ahead
     bool currentMspConfirmValue = MspReceiver.GetCurrentConfirm();
+    uint8_t currentMspSack = MspReceiver.GetCurrentSack();
     MspReceiver.ReceiveData(packageIndex, payload, dataLen);
-    if (currentMspConfirmValue != MspReceiver.GetCurrentConfirm())
+    if (currentMspConfirmValue != MspReceiver.GetCurrentConfirm() || currentMspSack != MspReceiver.GetCurrentSack())
     {
         NextTelemetryType = ELRS_TELEMETRY_TYPE_LINK;
     }
@@ -1178,12 +1209,16 @@ bool ICACHE_RAM_ATTR ProcessRFPacket(SX12xxDriverCommon::rx_status const status)
 
 bool ICACHE_RAM_ATTR RXdoneISR(SX12xxDriverCommon::rx_status const status)
 {
+    TRACE(TRACE_RX_DONE);
     if (LQCalc.currentIsSet() && connectionState == connected)
     {
         return false; // Already received a packet, do not run ProcessRFPacket() again.
     }
 
-    if (ProcessRFPacket(status))
+    TRACE(TRACE_PROCESS_RF_BEGIN);
+    bool const packetValid = ProcessRFPacket(status);
+    TRACE(TRACE_PROCESS_RF_END);
+    if (packetValid)
     {
         didFHSS = HandleFHSS();
 
@@ -1200,6 +1235,7 @@ bool ICACHE_RAM_ATTR RXdoneISR(SX12xxDriverCommon::rx_status const status)
 
 void ICACHE_RAM_ATTR TXdoneISR()
 {
+    TRACE(TRACE_TX_DONE);
     Radio.RXnb();
 #if defined(Regulatory_Domain_EU_CE_2400)
     SetClearChannelAssessmentTime();
@@ -1236,6 +1272,9 @@ void MspReceiveComplete()
         });
 #endif
         break;
+    case MSP_ELRS_TLM_COMPACT:
+        TelemetryEncoder.HandleRequest(MspData[1]);
+        break;
     case MSP_ELRS_MAVLINK_TLM: // 0xFD
         // raw mavlink data
         mavlinkOutputBuffer.atomicPushBytes(&MspData[2], MspData[1]);
@@ -1260,7 +1299,7 @@ void MspReceiveComplete()
                         vtxSPIPowerIdx = MspData[10];
                         vtxSPIPitmode = MspData[11];
                     }
-                    devicesTriggerEvent();
+                    devicesTriggerEvent(EVENT_VTX_CHANGED);
                     break;
 #if defined(PLATFORM_ESP32)
                 } else if (config.GetSerial1Protocol() == PROTOCOL_SERIAL1_TRAMP || config.GetSerial1Protocol() == PROTOCOL_SERIAL1_SMARTAUDIO) {
@@ -1546,6 +1585,12 @@ static void setupConfigAndPocCheck()
     config.SetStorageProvider(&eeprom); // Pass pointer to the Config class for access to storage
     config.Load();
 
+#if defined(RX_WARM_START)
+    // A reset with the link up is not a plug cycle. Counting it would also drop the link again
+    // as soon as it is back, when the counter is cleared and the config committed.
+    warmStart = config.GetIsBound() && WarmStartLoad(&warmStartState);
+    if (!warmStart)
+#endif
     // If bound, track number of plug/unplug cycles to go to binding mode in eeprom
     if (config.GetIsBound() && config.GetPowerOnCounter() < 3)
     {
@@ -1619,10 +1664,31 @@ static void setupRadio()
     Radio.TXdoneCallback = &TXdoneISR;
 
     scanIndex = config.GetRateInitialIdx();
+#if defined(RX_WARM_START)
+    warmStart = warmStart && warmStartState.uidSeed == uidMacSeedGet() && warmStartState.rateIndex < RATE_MAX;
+    if (warmStart)
+    {
+        DBGLN("Warm start rate=%u fo=%d", warmStartState.rateIndex, warmStartState.freqOffset);
+        scanIndex = warmStartState.rateIndex;
+    }
+#endif
     SetRFLinkRate(scanIndex, false);
     // Start slow on the selected rate to give it the best chance
     // to connect before beginning rate cycling
     RFmodeCycleMultiplier = RFmodeCycleMultiplierSlow / 2;
+
+#if defined(RX_WARM_START)
+    if (warmStart)
+    {
+        // Be ready to output the first RC packet after the sync, with the timer already
+        // running at the rate it was locked at
+        OtaUpdateSerializers((OtaSwitchMode_e)warmStartState.switchMode, ExpressLRS_currAirRate_Modparams->PayloadLength);
+        ExpressLRS_currTlmDenom = warmStartState.tlmDenom;
+        hwTimer::setFreqOffset(warmStartState.freqOffset);
+        // The TX only sends sync while it sees the link as down, give it the time to notice
+        RFmodeCycleMultiplier = RFmodeCycleMultiplierSlow;
+    }
+#endif
 }
 
 static void updateTelemetryBurst()
@@ -1638,6 +1704,27 @@ static void updateTelemetryBurst()
     TelemetrySender.UpdateTelemetryRate(hz, ExpressLRS_currTlmDenom, telemetryBurstMax);
 }
 
+#if defined(RX_WARM_START)
+/* Keep the state of the link for a warm start after a reset
+ */
+static void updateWarmStart(unsigned long now)
+{
+    if (connectionState != connected || SwitchModePending || now - warmStartLastSaved < WARM_START_SAVE_INTERVAL)
+        return;
+
+    warmStartLastSaved = now;
+    warm_start_state_t state = {
+        .uidSeed = uidMacSeedGet(),
+        .rateIndex = ExpressLRS_currAirRate_Modparams->index,
+        .switchMode = (uint8_t)OtaSwitchModeCurrent,
+        .tlmDenom = ExpressLRS_currTlmDenom,
+        .unused = 0,
+        .freqOffset = hwTimer::getFreqOffset(),
+    };
+    WarmStartSave(state);
+}
+#endif
+
 /* If not connected will rotate through the RF modes looking for sync
  * and blink LED
  */
@@ -1662,6 +1749,10 @@ static void cycleRfMode(unsigned long now)
 
         // Switch to FAST_SYNC if not already in it (won't be if was just connected)
         RFmodeCycleMultiplier = 1;
+#if defined(RX_WARM_START)
+        // Nothing heard on the rate from before the reset, look for the TX from scratch
+        warmStart = false;
+#endif
     } // if time to switch RF mode
 }
 
@@ -1689,7 +1780,7 @@ static void EnterBindingMode()
     Radio.RXnb();
 
     DBGLN("Entered binding mode at freq = %d", Radio.currFreq);
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_BINDING_CHANGED);
 }
 
 static void ExitBindingMode()
@@ -1724,7 +1815,7 @@ static void ExitBindingMode()
     // if we're in binding mode
     InBindingMode = false;
     DBGLN("Exiting binding mode");
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_BINDING_CHANGED);
 }
 
 static void updateBindingMode(unsigned long now)
@@ -1937,7 +2028,7 @@ static void CheckConfigChangePending()
     {
         LostConnection(false);
         config.Commit();
-        devicesTriggerEvent();
+        devicesTriggerEvent(EVENT_CONFIG_CHANGED);
 #if defined(Regulatory_Domain_EU_CE_2400)
         LBTEnabled = (config.GetPower() > PWR_10mW);
 #endif
@@ -2089,6 +2180,7 @@ void loop()
     }
 
     devicesUpdate(now);
+    traceDump(now);
 
     // read and process any data from serial ports, send any queued non-RC data
     handleSerialIO();
@@ -2143,6 +2235,15 @@ void loop()
     {
         GotConnection(now);
     }
+#if defined(RX_WARM_START)
+    // A sync for the binding and rate the link had before the reset, the link is back
+    else if (connectionState == tentative && warmStart && connectionHasModelMatch)
+    {
+        DBGLN("Warm start conn");
+        GotConnection(now);
+    }
+    updateWarmStart(now);
+#endif
 
     checkSendLinkStatsToFc(now);
 
@@ -2154,8 +2255,14 @@ void loop()
 
     uint8_t *nextPayload = 0;
     uint8_t nextPlayloadSize = 0;
-    if (!TelemetrySender.IsActive() && telemetry.GetNextPayload(&nextPlayloadSize, &nextPayload))
+    if (!TelemetrySender.IsActive() && telemetry.GetNextPayload(&nextPlayloadSize, &nextPayload, now))
     {
+        uint8_t compactSize = TelemetryEncoder.EncodeIfEnabled(nextPayload, telemetryCompactBuffer);
+        if (compactSize)
+        {
+            nextPayload = telemetryCompactBuffer;
+            nextPlayloadSize = compactSize;
+        }
         TelemetrySender.SetDataToTransmit(nextPayload, nextPlayloadSize);
     }
 
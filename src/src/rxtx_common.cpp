@@ -2,26 +2,13 @@
 #include "common.h"
 #include "config.h"
 #include "logging.h"
-
-#include <functional>
+#include "deferred.h"
 
 #if defined(USE_I2C)
 #include <Wire.h>
 #endif
 
-static const int maxDeferredFunctions = 3;
-
-struct deferred_t {
-    unsigned long started;
-    unsigned long timeout;
-    std::function<void()> function;
-};
-
-static deferred_t deferred[maxDeferredFunctions] = {
-    {0, 0, nullptr},
-    {0, 0, nullptr},
-    {0, 0, nullptr},
-};
+DeferredQueue<maxDeferredFunctions> deferredFunctions;
 
 boolean i2c_enabled = false;
 
@@ -70,33 +57,3 @@ void setupTargetCommon()
 {
     setupWire();
 }
-
-void deferExecutionMicros(unsigned long us, std::function<void()> f)
-{
-    for (int i=0 ; i<maxDeferredFunctions ; i++)
-    {
-        if (deferred[i].function == nullptr)
-        {
-            deferred[i].started = micros();
-            deferred[i].timeout = us;
-            deferred[i].function = f;
-            return;
-        }
-    }
-
-    // Bail out, there are no slots available!
-    DBGLN("No more deferred function slots available!");
-}
-
-void executeDeferredFunction(unsigned long now)
-{
-    // execute deferred function if its time has elapsed
-    for (int i=0 ; i<maxDeferredFunctions ; i++)
-    {
-        if (deferred[i].function != nullptr && (now - deferred[i].started) > deferred[i].timeout)
-        {
-            deferred[i].function();
-            deferred[i].function = nullptr;
-        }
-    }
-}
@@ -8,6 +8,7 @@
 #include "telemetry_protocol.h"
 #include "stubborn_receiver.h"
 #include "stubborn_sender.h"
+#include "telemetry_compact.h"
 
 #include "devHandset.h"
 #include "devLED.h"
@@ -84,6 +85,7 @@ uint8_t MSPDataPackage[5];
 #define BindingSpamAmount 25
 static uint8_t BindingSendCount;
 bool RxWiFiReadyToSend = false;
+static bool TlmCompactReadyToSend = false;
 
 bool headTrackingEnabled = false;
 #if !defined(CRITICAL_FLASH)
@@ -95,6 +97,8 @@ static TxTlmRcvPhase_e TelemetryRcvPhase = ttrpTransmitting;
 StubbornReceiver TelemetryReceiver;
 StubbornSender MspSender;
 uint8_t CRSFinBuffer[CRSF_MAX_PACKET_LEN+1];
+TelemetryCompactDecoder TelemetryDecoder;
+uint8_t TelemetryDecoded[CRSF_MAX_PACKET_LEN];
 
 device_affinity_t ui_devices[] = {
   {&Handset_device, 1},
@@ -152,7 +156,7 @@ void switchDiversityAntennas()
   }
 }
 
-void ICACHE_RAM_ATTR LinkStatsFromOta(OTA_LinkStats_s * const ls)
+void ICACHE_RAM_ATTR LinkStatsFromOta(OTA_LinkStats_s * const ls, uint8_t mspSack)
 {
   int8_t snrScaled = ls->SNR;
   DynamicPower_TelemetryUpdate(snrScaled);
@@ -175,7 +179,7 @@ void ICACHE_RAM_ATTR LinkStatsFromOta(OTA_LinkStats_s * const ls)
   // -- uplink_TX_Power is updated when sending to the handset, so it updates when missing telemetry
   // -- rf_mode is updated when we change rates
   // -- downlink_Link_quality is updated before the LQ period is incremented
-  MspSender.ConfirmCurrentPayload(ls->mspConfirm);
+  MspSender.ConfirmCurrentPayload(ls->mspConfirm, mspSack);
 }
 
 bool ICACHE_RAM_ATTR ProcessTLMpacket(SX12xxDriverCommon::rx_status const status)
@@ -215,7 +219,8 @@ bool ICACHE_RAM_ATTR ProcessTLMpacket(SX12xxDriverCommon::rx_status const status
     uint8_t dataLen;
     if (ota8->tlm_dl.containsLinkStats)
     {
-      LinkStatsFromOta(&ota8->tlm_dl.ul_link_stats.stats);
+      // No room for the MSP SACK in full res, so MSP is sent non-windowed
+      LinkStatsFromOta(&ota8->tlm_dl.ul_link_stats.stats, 0);
       telemPtr = ota8->tlm_dl.ul_link_stats.payload;
       dataLen = sizeof(ota8->tlm_dl.ul_link_stats.payload);
     }
@@ -238,7 +243,7 @@ bool ICACHE_RAM_ATTR ProcessTLMpacket(SX12xxDriverCommon::rx_status const status
     switch (otaPktPtr->std.tlm_dl.type)
     {
       case ELRS_TELEMETRY_TYPE_LINK:
-        LinkStatsFromOta(&otaPktPtr->std.tlm_dl.ul_link_stats.stats);
+        LinkStatsFromOta(&otaPktPtr->std.tlm_dl.ul_link_stats.stats, otaPktPtr->std.tlm_dl.ul_link_stats.mspSack);
         break;
 
       case ELRS_TELEMETRY_TYPE_DATA:
@@ -488,6 +493,7 @@ void injectBackpackPanTiltRollData(uint32_t const now)
 
 void ICACHE_RAM_ATTR SendRCdataToRF()
 {
+  TRACE(TRACE_SEND_RC_DATA);
   // Do not send a stale channels packet to the RX if one has not been received from the handset
   // *Do* send data if a packet has never been received from handset and the timer is running
   // this is the case when bench testing and TXing without a handset
@@ -573,8 +579,10 @@ void ICACHE_RAM_ATTR SendRCdataToRF()
       // always enable msp after a channel package since the slot is only used if MspSender has data to send
       NextPacketIsMspData = true;
 
+      Handset::lockChannelData();
       injectBackpackPanTiltRollData(now);
       OtaPackChannelData(&otaPkt, ChannelData, TelemetryReceiver.GetCurrentConfirm(), ExpressLRS_currTlmDenom);
+      Handset::unlockChannelData();
     }
   }
 
@@ -635,6 +643,7 @@ void ICACHE_RAM_ATTR nonceAdvance()
  */
 void ICACHE_RAM_ATTR timerCallback()
 {
+  TRACE(TRACE_TIMER_CALLBACK);
   /* If we are busy writing to EEPROM (committing config changes) then we just advance the nonces, i.e. no SPI traffic */
   if (commitInProgress)
   {
@@ -761,7 +770,7 @@ void ModelUpdateReq()
     ModelUpdatePending = true;
   }
 
-  devicesTriggerEvent();
+  devicesTriggerEvent(EVENT_CONFIG_CHANGED);
 
   // Jump from awaitingModelId to transmitting to break the startup delay now
   // that the ModelID has been confirmed by the handset
@@ -785,7 +794,7 @@ static void ConfigChangeCommit()
   commitInProgress = false;
   // UpdateFolderNames is expensive so it is called directly instead of in event() which gets called a lot
   luadevUpdateFolderNames();
-  devicesTriggerEvent();
+  devicesTriggerEvent(EVENT_CONFIG_CHANGED);
 }
 
 static void CheckConfigChangePending()
@@ -815,6 +824,7 @@ static void CheckConfigChangePending()
 
 bool ICACHE_RAM_ATTR RXdoneISR(SX12xxDriverCommon::rx_status const status)
 {
+  TRACE(TRACE_RX_DONE);
   if (LQCalc.currentIsSet())
   {
     return false; // Already received tlm, do not run ProcessTLMpacket() again.
@@ -833,6 +843,7 @@ bool ICACHE_RAM_ATTR RXdoneISR(SX12xxDriverCommon::rx_status const status)
 
 void ICACHE_RAM_ATTR TXdoneISR()
 {
+  TRACE(TRACE_TX_DONE);
   if (!busyTransmitting)
   {
     return; // Already finished transmission and do not call HandleFHSS() a second time, which may hop the frequency!
@@ -879,6 +890,9 @@ static void UpdateConnectDisconnectStatus()
       apOutputBuffer.flush();
       uartInputBuffer.flush();
 
+      TelemetryDecoder.Reset();
+      TlmCompactReadyToSend = true;
+
       VtxTriggerSend();
     }
   }
@@ -908,6 +922,19 @@ static void SendRxWiFiOverMSP()
   MspSender.SetDataToTransmit(MSPDataPackage, 1);
 }
 
+/***
+ * Ask the RX to send compact telemetry, see telemetry_compact.h.
+ * An RX which doesn't support it ignores the request because the dest is not the RX or FC
+ ***/
+static void SendTlmCompactOverMSP()
+{
+  MSPDataPackage[0] = MSP_ELRS_TLM_COMPACT;
+  MSPDataPackage[1] = TLM_COMPACT_VERSION;
+  MSPDataPackage[2] = 0;
+  MSPDataPackage[3] = CRSF_ADDRESS_RADIO_TRANSMITTER;
+  MspSender.SetDataToTransmit(MSPDataPackage, 4);
+}
+
 static void CheckReadyToSend()
 {
   if (RxWiFiReadyToSend)
@@ -918,6 +945,12 @@ static void CheckReadyToSend()
       SendRxWiFiOverMSP();
     }
   }
+  // Wait for any other MSP to finish so it is not aborted
+  if (TlmCompactReadyToSend && !MspSender.IsActive())
+  {
+    TlmCompactReadyToSend = false;
+    SendTlmCompactOverMSP();
+  }
 }
 
 #if !defined(CRITICAL_FLASH)
@@ -1417,6 +1450,7 @@ void loop()
 
   // Update UI devices
   devicesUpdate(now);
+  traceDump(now);
 
   // Not a device because it must be run on the loop core
   checkBackpackUpdate();
@@ -1473,6 +1507,14 @@ void loop()
           }
         }
       }
+      else if (TelemetryCompact::IsCompact(CRSFinBuffer))
+      {
+        if (TelemetryDecoder.Decode(CRSFinBuffer, TelemetryDecoded))
+        {
+          handset->sendTelemetryToTX(TelemetryDecoded);
+          sendCRSFTelemetryToBackpack(TelemetryDecoded);
+        }
+      }
       else
       {
         // Send all other tlm to handset
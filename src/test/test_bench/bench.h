@@ -0,0 +1,81 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Minimal host microbenchmark harness
+ *
+ * Each benchmark runs a fixed number of iterations (scaled by BENCH_SCALE) for
+ * BENCH_ROUNDS rounds and the fastest round is reported, which keeps results
+ * stable enough to compare between commits. A CSV summary of every benchmark
+ * is printed at the end between BENCH_CSV_BEGIN / BENCH_CSV_END markers.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#ifndef BENCH_SCALE
+#define BENCH_SCALE 1
+#endif
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS 5
+#endif
+
+typedef struct {
+    const char *name;
+    uint32_t iterations;
+    double nsPerOp;
+    double bytesPerSec;
+} bench_result_t;
+
+extern std::vector<bench_result_t> benchResults;
+
+// Results are accumulated here so the optimizer can not discard the work being timed
+extern volatile uint32_t benchSink;
+
+/**
+ * @brief Time fn() for iterations * BENCH_SCALE calls and record the result
+ * @param name benchmark name, used as the key in the CSV summary
+ * @param iterations calls per round before scaling
+ * @param bytesPerOp bytes processed by each call, 0 if throughput is not meaningful
+ */
+template <typename F>
+void benchRun(const char *name, uint32_t iterations, uint32_t bytesPerOp, F fn)
+{
+    const uint32_t n = iterations * BENCH_SCALE;
+    double best = 0;
+
+    // Warm-up pass so caches and branch predictors are in the same state every round
+    for (uint32_t i = 0; i < n / 10 + 1; ++i)
+        fn();
+
+    for (unsigned round = 0; round < BENCH_ROUNDS; ++round)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < n; ++i)
+            fn();
+        auto end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / n;
+        if (round == 0 || ns < best)
+            best = ns;
+    }
+
+    bench_result_t r = {name, n, best, bytesPerOp ? bytesPerOp * 1e9 / best : 0};
+    benchResults.push_back(r);
+    printf("%-32s %10u ops %10.1f ns/op", r.name, r.iterations, r.nsPerOp);
+    if (bytesPerOp)
+        printf(" %10.2f MB/s", r.bytesPerSec / 1e6);
+    printf("\n");
+}
+
+inline void benchPrintSummary()
+{
+    printf("BENCH_CSV_BEGIN\n");
+    printf("name,iterations,ns_per_op,bytes_per_sec\n");
+    for (const bench_result_t &r : benchResults)
+        printf("%s,%u,%.2f,%.0f\n", r.name, r.iterations, r.nsPerOp, r.bytesPerSec);
+    printf("BENCH_CSV_END\n");
+}
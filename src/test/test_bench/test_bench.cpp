@@ -0,0 +1,251 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Host microbenchmarks for the per-packet hot paths, see bench.h
+ *
+ * Run with `pio test -e native_bench`
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unity.h>
+
+#include "targets.h"
+#include "common.h"
+#include "CRSF.h"
+#include "OTA.h"
+#include "FHSS.h"
+#include "FIFO.h"
+#include "SPSCFIFO.h"
+#include "CRSFParser.h"
+#include "CRSFRxQueue.h"
+#include "FEC.h"
+#include "crc.h"
+#include "telemetry.h"
+#include "bench.h"
+
+CRSF crsf;  // need an instance to provide the fields used by the code under test
+uint32_t ChannelData[CRSF_NUM_CHANNELS];      // Current state of channels, CRSF format
+uint8_t UID[6] = {1,2,3,4,5,6};
+
+std::vector<bench_result_t> benchResults;
+volatile uint32_t benchSink;
+
+static void fillChannels()
+{
+    for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+        ChannelData[ch] = CRSF_CHANNEL_VALUE_MIN + ch * 97;
+}
+
+static void benchOtaMode(const char *packName, const char *unpackName, OtaSwitchMode_e mode, uint8_t packetSize)
+{
+    OtaUpdateSerializers(mode, packetSize);
+    fillChannels();
+
+    WORD_ALIGNED_ATTR OTA_Packet_s otaPkt = {};
+    uint32_t counter = 0;
+    benchRun(packName, 1000000, packetSize, [&]() {
+        ChannelData[0] = CRSF_CHANNEL_VALUE_MIN + (++counter & 0x3ff);
+        OtaNonce = counter;
+        OtaPackChannelData(&otaPkt, ChannelData, false, 4);
+        benchSink += otaPkt.std.crcLow;
+    });
+
+    uint32_t rxChannels[CRSF_NUM_CHANNELS] = {0};
+    benchRun(unpackName, 1000000, packetSize, [&]() {
+        OtaUnpackChannelData(&otaPkt, rxChannels, 4);
+        benchSink += rxChannels[0];
+    });
+}
+
+void bench_ota_serializers()
+{
+    benchOtaMode("ota_pack_wide", "ota_unpack_wide", smWideOr8ch, OTA4_PACKET_SIZE);
+    benchOtaMode("ota_pack_hybrid8", "ota_unpack_hybrid8", smHybridOr16ch, OTA4_PACKET_SIZE);
+    benchOtaMode("ota_pack_8ch", "ota_unpack_8ch", smWideOr8ch, OTA8_PACKET_SIZE);
+    benchOtaMode("ota_pack_16ch", "ota_unpack_16ch", smHybridOr16ch, OTA8_PACKET_SIZE);
+    benchOtaMode("ota_pack_12ch", "ota_unpack_12ch", sm12ch, OTA8_PACKET_SIZE);
+}
+
+void bench_ota_crc()
+{
+    OtaUpdateCrcInitFromUid();
+
+    OTA_Packet_s otaPkt;
+    memset(&otaPkt, 0x5a, sizeof(otaPkt));
+
+    OtaUpdateSerializers(smWideOr8ch, OTA4_PACKET_SIZE);
+    benchRun("ota_crc14_generate", 2000000, OTA4_CRC_CALC_LEN, [&]() {
+        ++otaPkt.std.rc.ch.raw[0];
+        OtaGeneratePacketCrc(&otaPkt);
+        benchSink += otaPkt.std.crcLow;
+    });
+    benchRun("ota_crc14_validate", 2000000, OTA4_CRC_CALC_LEN, [&]() {
+        benchSink += OtaValidatePacketCrc(&otaPkt);
+    });
+
+    OtaUpdateSerializers(smWideOr8ch, OTA8_PACKET_SIZE);
+    benchRun("ota_crc16_generate", 2000000, OTA8_CRC_CALC_LEN, [&]() {
+        ++otaPkt.full.rc.chLow.raw[0];
+        OtaGeneratePacketCrc(&otaPkt);
+        benchSink += otaPkt.full.crc;
+    });
+    benchRun("ota_crc16_validate", 2000000, OTA8_CRC_CALC_LEN, [&]() {
+        benchSink += OtaValidatePacketCrc(&otaPkt);
+    });
+}
+
+void bench_crc()
+{
+    uint8_t data[64];
+    for (unsigned i = 0; i < sizeof(data); ++i)
+        data[i] = i * 37;
+
+    Crc2Byte crc14;
+    crc14.init(14, ELRS_CRC14_POLY);
+    benchRun("crc2byte_14_7B", 2000000, 7, [&]() {
+        benchSink += crc14.calc(data, 7, ++data[0]);
+    });
+
+    Crc2Byte crc16;
+    crc16.init(16, ELRS_CRC16_POLY);
+    benchRun("crc2byte_16_11B", 2000000, 11, [&]() {
+        benchSink += crc16.calc(data, 11, ++data[0]);
+    });
+
+    GENERIC_CRC8 crc8(CRSF_CRC_POLY);
+    benchRun("crc8_crsf_rc_frame_23B", 2000000, 23, [&]() {
+        benchSink += crc8.calc(data, 23, ++data[0]);
+    });
+    benchRun("crc8_crsf_max_frame_62B", 1000000, 62, [&]() {
+        benchSink += crc8.calc(data, 62, ++data[0]);
+    });
+}
+
+void bench_fhss()
+{
+    FHSSrandomiseFHSSsequence(0x01020304L);
+    benchRun("fhss_get_next_freq", 5000000, 0, []() {
+        benchSink += FHSSgetNextFreq();
+    });
+}
+
+void bench_fifo()
+{
+    static FIFO<256> fifo;
+    uint8_t data[16];
+    for (unsigned i = 0; i < sizeof(data); ++i)
+        data[i] = i;
+
+    // Start part way in so the copies straddle the wrap point regularly
+    fifo.pushBytes(data, 7);
+    benchRun("fifo_push_pop_16B", 2000000, sizeof(data), [&]() {
+        fifo.pushBytes(data, sizeof(data));
+        fifo.popBytes(data, sizeof(data));
+        benchSink += data[0];
+    });
+
+    // The lock free FIFO used between the UART event task and the main loop
+    static SPSCFIFO<256> spsc;
+    spsc.pushBytes(data, 7);
+    benchRun("spscfifo_push_pop_16B", 2000000, sizeof(data), [&]() {
+        spsc.pushBytes(data, sizeof(data));
+        spsc.popBytes(data, sizeof(data));
+        benchSink += data[0];
+    });
+}
+
+void bench_fec()
+{
+    uint8_t in[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t fec[14];
+    uint8_t out[8];
+
+    benchRun("fec_encode_8B", 1000000, sizeof(in), [&]() {
+        ++in[0];
+        FECEncode(in, fec);
+        benchSink += fec[0];
+    });
+    benchRun("fec_decode_14B", 1000000, sizeof(fec), [&]() {
+        FECDecode(fec, out);
+        benchSink += out[0];
+    });
+}
+
+void bench_telemetry()
+{
+    static Telemetry telemetry;
+    uint8_t batterySequence[] = {0xEC,10,CRSF_FRAMETYPE_BATTERY_SENSOR,0,0,0,0,0,0,0,0,109};
+
+    telemetry.ResetState();
+    benchRun("telemetry_rx_uart_battery_12B", 1000000, sizeof(batterySequence), [&]() {
+        for (unsigned i = 0; i < sizeof(batterySequence); ++i)
+            benchSink += telemetry.RXhandleUARTin(batterySequence[i]);
+    });
+}
+
+void bench_crsf_handset()
+{
+    // CRSFHandset itself needs the UART so is not built for UNIT_TEST, time the input paths it
+    // is built from with an RC frame from the handset
+    uint8_t frame[CRSF_FRAME_SIZE(sizeof(crsf_channels_t)) + 2] = {
+        CRSF_ADDRESS_CRSF_TRANSMITTER, CRSF_FRAME_SIZE(sizeof(crsf_channels_t)), CRSF_FRAMETYPE_RC_CHANNELS_PACKED};
+    for (unsigned i = 3; i < sizeof(frame) - 1; ++i)
+        frame[i] = i * 13;
+    frame[sizeof(frame) - 1] = crsf_crc.calc(&frame[2], frame[1] - 1);
+
+    // ESP8266 pollFrame(): read only what the parser wants from the UART, straight into its buffer
+    static CRSFParser parser;
+    benchRun("crsf_handset_parser_rc_frame", 1000000, sizeof(frame), [&]() {
+        unsigned pos = 0;
+        while (pos < sizeof(frame))
+        {
+            const uint8_t n = std::min((unsigned)parser.bytesWanted(), (unsigned)sizeof(frame) - pos);
+            memcpy(parser.writePtr(), &frame[pos], n);
+            pos += n;
+            benchSink += parser.commit(n);
+        }
+    });
+
+    // ESP32 onRxEvent() and handleInput(): parse and timestamp a whole frame in the UART event, then pop it
+    static CRSFRxQueue queue;
+    queue.setBaudRate(5250000, 2);
+    uint32_t now = 0;
+    uint8_t out[CRSF_MAX_PACKET_LEN];
+    benchRun("crsf_handset_rxqueue_rc_frame", 1000000, sizeof(frame), [&]() {
+        uint32_t arrival;
+        queue.receive(frame, sizeof(frame), now += 1000);
+        benchSink += queue.pop(out, &arrival);
+    });
+
+    uint32_t channels[CRSF_NUM_CHANNELS];
+    benchRun("crsf_handset_rc_unpack", 2000000, sizeof(crsf_channels_t), [&]() {
+        ++frame[3];
+        CRSF::UnpackChannels((crsf_channels_t *)&frame[3], channels);
+        benchSink += channels[15];
+    });
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_ota_serializers);
+    RUN_TEST(bench_ota_crc);
+    RUN_TEST(bench_crc);
+    RUN_TEST(bench_fhss);
+    RUN_TEST(bench_fifo);
+    RUN_TEST(bench_fec);
+    RUN_TEST(bench_telemetry);
+    RUN_TEST(bench_crsf_handset);
+    UNITY_END();
+
+    benchPrintSummary();
+
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unity.h>
+
+#include "ConfigJournal.h"
+
+#define SECTOR_SIZE 4096
+#define JOURNAL_START 16    // after the power on counter, as on the ESP8266
+#define CONFIG_LEN 128      // about the size of rx_config_t
+
+// NOR flash: erased to 0xFF, programming can only clear bits. Optionally loses power part way through a write.
+class MockFlash
+{
+public:
+    MockFlash() { Erase(); erases = 0; }
+
+    void Read(uint32_t addr, uint8_t *buf, uint32_t len)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(SECTOR_SIZE, addr + len);
+        memcpy(buf, &mem[addr], len);
+    }
+
+    void Write(uint32_t addr, const uint8_t *buf, uint32_t len)
+    {
+        TEST_ASSERT_EQUAL(0, addr % 4);
+        TEST_ASSERT_EQUAL(0, len % 4);
+        TEST_ASSERT_GREATER_OR_EQUAL(JOURNAL_START, addr);
+        TEST_ASSERT_LESS_OR_EQUAL(SECTOR_SIZE, addr + len);
+        for (uint32_t i = 0; i < len; i++)
+        {
+            if (powerLossAfter == 0)
+                return;
+            if (powerLossAfter > 0)
+                powerLossAfter--;
+            TEST_ASSERT_EQUAL_HEX8(0xFF, mem[addr + i]);
+            mem[addr + i] &= buf[i];
+            bytesWritten++;
+        }
+    }
+
+    void Erase()
+    {
+        memset(mem, 0xFF, sizeof(mem));
+        erases++;
+    }
+
+    uint8_t mem[SECTOR_SIZE];
+    uint32_t bytesWritten = 0;
+    uint32_t erases = 0;
+    int32_t powerLossAfter = -1;
+};
+
+typedef ConfigJournal<MockFlash> Journal;
+
+// The config as the EEPROM holds it, and the journal on top
+static MockFlash flash;
+static uint8_t snapshot[CONFIG_LEN];
+static uint8_t config[CONFIG_LEN];
+
+static void randomChange(uint8_t *buf)
+{
+    // Mostly a single field, sometimes a few, sometimes a whole block like a UID or model list
+    const unsigned kind = rand() % 10;
+    const unsigned changes = kind < 6 ? 1 : kind < 9 ? 2 + rand() % 4 : 1;
+    for (unsigned c = 0; c < changes; c++)
+    {
+        const unsigned pos = rand() % CONFIG_LEN;
+        const unsigned len = kind == 9 ? 1 + rand() % 40 : 1 + rand() % 2;
+        for (unsigned i = pos; i < pos + len && i < CONFIG_LEN; i++)
+            buf[i] = rand();
+    }
+}
+
+// Boot: load the snapshot and replay the journal onto it
+static bool reboot(Journal &journal, uint8_t *loaded)
+{
+    flash.powerLossAfter = -1;
+    memcpy(loaded, snapshot, CONFIG_LEN);
+    return journal.Replay(loaded, CONFIG_LEN);
+}
+
+static void setUpStorage()
+{
+    flash.Erase();
+    flash.erases = 0;
+    flash.bytesWritten = 0;
+    for (unsigned i = 0; i < CONFIG_LEN; i++)
+        snapshot[i] = config[i] = rand();
+}
+
+void test_small_commit(void)
+{
+    static Journal journal(flash, JOURNAL_START, SECTOR_SIZE);
+    setUpStorage();
+    journal.Clear();
+
+    // The first commit writes the header, then one 4 byte record header and the data rounded up
+    uint8_t persisted[CONFIG_LEN];
+    memcpy(persisted, config, CONFIG_LEN);
+    config[10] ^= 1;
+    TEST_ASSERT_TRUE(journal.Append(config, persisted, CONFIG_LEN));
+    TEST_ASSERT_EQUAL(4 + 8, flash.bytesWritten);
+
+    memcpy(persisted, config, CONFIG_LEN);
+    config[20] ^= 1;
+    config[22] ^= 1; // close enough to share a record
+    TEST_ASSERT_TRUE(journal.Append(config, persisted, CONFIG_LEN));
+    TEST_ASSERT_EQUAL(4 + 8 + 8, flash.bytesWritten);
+
+    // Nothing changed, nothing written
+    memcpy(persisted, config, CONFIG_LEN);
+    TEST_ASSERT_TRUE(journal.Append(config, persisted, CONFIG_LEN));
+    TEST_ASSERT_EQUAL(4 + 8 + 8, flash.bytesWritten);
+    TEST_ASSERT_EQUAL(1, flash.erases);
+
+    uint8_t loaded[CONFIG_LEN];
+    TEST_ASSERT_TRUE(reboot(journal, loaded));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(config, loaded, CONFIG_LEN);
+}
+
+void test_replay_random_commits(void)
+{
+    static Journal journal(flash, JOURNAL_START, SECTOR_SIZE);
+    srand(23);
+    setUpStorage();
+    journal.Clear();
+    flash.erases = 0;
+
+    const unsigned commits = 5000;
+    uint8_t persisted[CONFIG_LEN];
+    uint8_t loaded[CONFIG_LEN];
+    for (unsigned n = 0; n < commits; n++)
+    {
+        memcpy(persisted, config, CONFIG_LEN);
+        randomChange(config);
+        if (!journal.Append(config, persisted, CONFIG_LEN))
+        {
+            // Full, compact into the snapshot
+            memcpy(snapshot, config, CONFIG_LEN);
+            journal.Clear();
+        }
+        TEST_ASSERT_TRUE(reboot(journal, loaded));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(config, loaded, CONFIG_LEN);
+    }
+
+    // Rewriting the snapshot each time erases a sector and writes all of it, every commit
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u commits: %.1f bytes written per commit, a sector erase every %.0f commits",
+        commits, (double)flash.bytesWritten / commits, (double)commits / flash.erases);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_THAN(commits / 50, flash.erases);
+}
+
+void test_power_loss(void)
+{
+    static Journal journal(flash, JOURNAL_START, SECTOR_SIZE);
+    srand(5);
+    setUpStorage();
+    journal.Clear();
+
+    uint8_t persisted[CONFIG_LEN];
+    uint8_t loaded[CONFIG_LEN];
+    for (unsigned n = 0; n < 300; n++)
+    {
+        memcpy(persisted, config, CONFIG_LEN);
+        randomChange(config);
+
+        // Power lost part way through the commit, after any number of bytes
+        uint8_t saved[SECTOR_SIZE];
+        memcpy(saved, flash.mem, SECTOR_SIZE);
+        const uint32_t written = flash.bytesWritten;
+        bool fits = journal.Append(config, persisted, CONFIG_LEN);
+        const uint32_t commitLen = flash.bytesWritten - written;
+        for (uint32_t lost = 0; fits && lost < commitLen; lost++)
+        {
+            memcpy(flash.mem, saved, SECTOR_SIZE);
+            TEST_ASSERT_TRUE(reboot(journal, loaded)); // the journal as it was is fine
+            flash.powerLossAfter = lost;
+            journal.Append(config, persisted, CONFIG_LEN);
+
+            // Then on boot the commit is either all there (only its padding was lost) or none of it
+            reboot(journal, loaded);
+            if (memcmp(config, loaded, CONFIG_LEN) != 0)
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(persisted, loaded, CONFIG_LEN);
+        }
+
+        // The last attempt goes through, or the caller compacts
+        if (fits)
+        {
+            memcpy(flash.mem, saved, SECTOR_SIZE);
+            reboot(journal, loaded);
+            fits = journal.Append(config, persisted, CONFIG_LEN);
+        }
+        if (!fits)
+        {
+            memcpy(snapshot, config, CONFIG_LEN);
+            journal.Clear();
+        }
+        TEST_ASSERT_TRUE(reboot(journal, loaded));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(config, loaded, CONFIG_LEN);
+    }
+}
+
+void test_stale_journal(void)
+{
+    static Journal journal(flash, JOURNAL_START, SECTOR_SIZE);
+    setUpStorage();
+    journal.Clear();
+
+    uint8_t persisted[CONFIG_LEN];
+    memcpy(persisted, config, CONFIG_LEN);
+    config[0] ^= 0xFF;
+    TEST_ASSERT_TRUE(journal.Append(config, persisted, CONFIG_LEN));
+
+    // Something else rewrote the snapshot, e.g. older firmware, so the journal no longer applies
+    snapshot[5] ^= 0xFF;
+    uint8_t loaded[CONFIG_LEN];
+    TEST_ASSERT_FALSE(reboot(journal, loaded));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(snapshot, loaded, CONFIG_LEN);
+
+    // Anything written over the erased space after the journal also needs a compaction
+    setUpStorage();
+    journal.Clear();
+    flash.mem[SECTOR_SIZE - 1] = 0;
+    TEST_ASSERT_FALSE(reboot(journal, loaded));
+}
+
+void test_replay_time(void)
+{
+    static Journal journal(flash, JOURNAL_START, SECTOR_SIZE);
+    srand(7);
+    setUpStorage();
+    journal.Clear();
+
+    // Fill the journal with single byte changes, the most records there can be
+    uint8_t persisted[CONFIG_LEN];
+    unsigned commits = 0;
+    for (;;)
+    {
+        memcpy(persisted, config, CONFIG_LEN);
+        config[rand() % CONFIG_LEN] ^= 1 + rand() % 255;
+        if (!journal.Append(config, persisted, CONFIG_LEN))
+            break;
+        commits++;
+    }
+    memcpy(config, persisted, CONFIG_LEN);
+
+    const unsigned iterations = 1000;
+    uint8_t loaded[CONFIG_LEN];
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+        TEST_ASSERT_TRUE(reboot(journal, loaded));
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(config, loaded, CONFIG_LEN);
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "Replay of a full journal, %u commits in %u bytes: %.1f us", commits, journal.BytesUsed(), us);
+    TEST_MESSAGE(msg);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_small_commit);
+    RUN_TEST(test_replay_random_commits);
+    RUN_TEST(test_power_loss);
+    RUN_TEST(test_stale_journal);
+    RUN_TEST(test_replay_time);
+    UNITY_END();
+
+    return 0;
+}
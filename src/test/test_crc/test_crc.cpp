@@ -276,6 +276,60 @@ void test_crc8(void)
     TEST_ASSERT_EQUAL_MESSAGE((int)(crc & 0xFF), c, genMsg(bytes, sizeof(bytes)));
 }
 
+void test_crc2byte_all_lengths(uint8_t crcbits, uint16_t poly)
+{
+    // Every length exercises the sliced rounds plus each possible tail length
+    uCRC_t ccrc = uCRC_t("CRC", crcbits, poly, 0, false, false, 0);
+    Crc2Byte ecrc;
+    ecrc.init(crcbits, poly);
+
+    uint8_t bytes[64];
+    for (int len = 0; len <= (int)sizeof(bytes); len++)
+    {
+        for (int i = 0; i < len; i++)
+            bytes[i] = random() % 256;
+        uint16_t init = random() % (1 << crcbits);
+
+        uint64_t crc = ccrc.get_raw_crc(bytes, len, init);
+        uint32_t mask = (1 << crcbits) - 1;
+        TEST_ASSERT_EQUAL_MESSAGE(crc & mask, ecrc.calc(bytes, len, init), genMsg(bytes, len < 20 ? len : 20));
+    }
+}
+
+void test_crc14_all_lengths(void)
+{
+    test_crc2byte_all_lengths(14, ELRS_CRC14_POLY);
+}
+
+void test_crc16_all_lengths(void)
+{
+    test_crc2byte_all_lengths(16, ELRS_CRC16_POLY);
+    test_crc2byte_all_lengths(16, 0x1021); // SUMD
+    test_crc2byte_all_lengths(16, 0x8005); // No precomputed table
+}
+
+void test_crc8_all_lengths(void)
+{
+    const uint8_t polys[] = {CRSF_CRC_POLY, ELRS_CRC_POLY};
+    for (uint8_t poly : polys)
+    {
+        uCRC_t ccrc = uCRC_t("CRC8", 8, poly, 0, false, false, 0);
+        GENERIC_CRC8 ecrc = GENERIC_CRC8(poly);
+
+        uint8_t bytes[64];
+        for (int len = 0; len <= (int)sizeof(bytes); len++)
+        {
+            for (int i = 0; i < len; i++)
+                bytes[i] = random() % 256;
+            uint8_t init = random() % 256;
+
+            uint64_t crc = ccrc.get_raw_crc(bytes, len, init);
+            TEST_ASSERT_EQUAL_MESSAGE((int)(crc & 0xFF), ecrc.calc(bytes, len, init), genMsg(bytes, len < 20 ? len : 20));
+        }
+        TEST_ASSERT_EQUAL((int)(ccrc.get_raw_crc(bytes, 1, 0) & 0xFF), ecrc.calc(bytes[0]));
+    }
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -290,6 +344,9 @@ int main(int argc, char **argv)
     RUN_TEST(test_crc16_implementation_compatibility);
     RUN_TEST(test_crc16_flip5);
     RUN_TEST(test_crc8);
+    RUN_TEST(test_crc14_all_lengths);
+    RUN_TEST(test_crc16_all_lengths);
+    RUN_TEST(test_crc8_all_lengths);
     UNITY_END();
 #endif
 #ifdef BIG_TEST
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <unity.h>
@@ -5,6 +6,8 @@
 
 #include "common.h"
 #include "CRSF.h"
+#include "CRSFParser.h"
+#include "CRSFRxQueue.h"
 
 using namespace std;
 
@@ -62,6 +65,412 @@ void test_device_info(void)
     TEST_ASSERT_EQUAL(test_crc.calc(&deviceInformation[2], DEVICE_INFORMATION_LENGTH-3), deviceInformation[DEVICE_INFORMATION_LENGTH - 1]);
 }
 
+void test_unpack_channels(void)
+{
+    // Every 11-bit value in each of the 16 positions, with random values in the others
+    for (unsigned pos = 0; pos < 16; ++pos)
+    {
+        for (uint32_t val = 0; val < 2048; ++val)
+        {
+            // Random trailing byte, stands in for the CRC that follows the payload in a frame
+            struct {
+                crsf_channels_t ch;
+                uint8_t guard;
+            } PACKED frame;
+            uint8_t *raw = (uint8_t *)&frame;
+            for (unsigned i = 0; i < sizeof(frame); ++i)
+                raw[i] = random() % 256;
+
+            uint32_t channelsIn[16];
+            for (unsigned ch = 0; ch < 16; ++ch)
+                channelsIn[ch] = random() % 2048;
+            channelsIn[pos] = val;
+            frame.ch.ch0 = channelsIn[0]; frame.ch.ch1 = channelsIn[1]; frame.ch.ch2 = channelsIn[2]; frame.ch.ch3 = channelsIn[3];
+            frame.ch.ch4 = channelsIn[4]; frame.ch.ch5 = channelsIn[5]; frame.ch.ch6 = channelsIn[6]; frame.ch.ch7 = channelsIn[7];
+            frame.ch.ch8 = channelsIn[8]; frame.ch.ch9 = channelsIn[9]; frame.ch.ch10 = channelsIn[10]; frame.ch.ch11 = channelsIn[11];
+            frame.ch.ch12 = channelsIn[12]; frame.ch.ch13 = channelsIn[13]; frame.ch.ch14 = channelsIn[14]; frame.ch.ch15 = channelsIn[15];
+
+            uint32_t channelsOut[16];
+            CRSF::UnpackChannels(&frame.ch, channelsOut);
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(channelsIn, channelsOut, 16);
+        }
+    }
+}
+
+void test_pack_channels(void)
+{
+    // Every 11-bit value in each of the 16 positions, with random values in the others.
+    // Bits above the 11 are dropped, like assigning the bitfields does
+    for (unsigned pos = 0; pos < 16; ++pos)
+    {
+        for (uint32_t val = 0; val < 2048; ++val)
+        {
+            uint32_t channelsIn[16];
+            for (unsigned ch = 0; ch < 16; ++ch)
+                channelsIn[ch] = random();
+            channelsIn[pos] = val;
+
+            struct {
+                crsf_channels_t ch;
+                uint8_t guard;
+            } PACKED expected, actual;
+            memset(&expected, 0xA5, sizeof(expected));
+            memset(&actual, 0xA5, sizeof(actual));
+            expected.ch.ch0 = channelsIn[0]; expected.ch.ch1 = channelsIn[1]; expected.ch.ch2 = channelsIn[2]; expected.ch.ch3 = channelsIn[3];
+            expected.ch.ch4 = channelsIn[4]; expected.ch.ch5 = channelsIn[5]; expected.ch.ch6 = channelsIn[6]; expected.ch.ch7 = channelsIn[7];
+            expected.ch.ch8 = channelsIn[8]; expected.ch.ch9 = channelsIn[9]; expected.ch.ch10 = channelsIn[10]; expected.ch.ch11 = channelsIn[11];
+            expected.ch.ch12 = channelsIn[12]; expected.ch.ch13 = channelsIn[13]; expected.ch.ch14 = channelsIn[14]; expected.ch.ch15 = channelsIn[15];
+
+            CRSF::PackChannels(channelsIn, &actual.ch);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY((uint8_t *)&expected, (uint8_t *)&actual, sizeof(expected));
+        }
+    }
+}
+
+static uint32_t rngState = 1;
+static uint32_t rng()
+{
+    rngState = rngState * 1664525 + 1013904223;
+    return rngState >> 8;
+}
+
+// Write a frame of `payloadLen` random bytes, which may include sync bytes
+static uint8_t makeTestFrame(uint8_t *frame, uint8_t type, uint8_t payloadLen)
+{
+    frame[0] = (rng() & 1) ? CRSF_SYNC_BYTE : CRSF_ADDRESS_CRSF_TRANSMITTER;
+    frame[1] = CRSF_FRAME_SIZE(payloadLen);
+    frame[2] = type;
+    for (unsigned i = 0; i < payloadLen; ++i)
+        frame[3 + i] = rng();
+    frame[3 + payloadLen] = test_crc.calc(&frame[2], payloadLen + 1);
+    return CRSF_FRAME_NOT_COUNTED_BYTES + CRSF_FRAME_SIZE(payloadLen);
+}
+
+// As makeTestFrame, but with no sync bytes after the first so a corrupt copy fails its CRC only once
+static uint8_t makeTestFrameNoSyncs(uint8_t *frame, uint8_t type, uint8_t payloadLen)
+{
+    while (true)
+    {
+        const uint8_t frameLen = makeTestFrame(frame, type, payloadLen);
+        if (std::none_of(&frame[1], &frame[frameLen], [](uint8_t b) { return b == CRSF_SYNC_BYTE || b == CRSF_ADDRESS_CRSF_TRANSMITTER; }))
+            return frameLen;
+    }
+}
+
+/**
+ * Feed `len` bytes to the parser in random sized reads like the UART would, calling onFrame
+ * with each frame which is parsed
+ */
+template <typename F>
+static void feedParser(CRSFParser &parser, const uint8_t *data, unsigned len, unsigned maxChunk, F onFrame)
+{
+    unsigned pos = 0;
+    while (pos < len)
+    {
+        unsigned available = std::min(len - pos, 1 + rng() % maxChunk);
+        while (available > 0)
+        {
+            // The parser must never ask for more than fits in a frame
+            const uint8_t wanted = parser.bytesWanted();
+            TEST_ASSERT_TRUE(parser.writePtr() - parser.frame().asUint8_t + wanted <= CRSF_MAX_PACKET_LEN);
+            const unsigned n = std::min(available, (unsigned)wanted);
+            memcpy(parser.writePtr(), &data[pos], n);
+            pos += n;
+            available -= n;
+            onFrame(parser.commit(n));
+        }
+        // Like the UART going quiet, finish any bytes kept after a bad CRC
+        while (rng() & 1 && parser.pendingBytes() != 0)
+        {
+            onFrame(parser.commit(0));
+        }
+    }
+    while (parser.pendingBytes() != 0)
+    {
+        onFrame(parser.commit(0));
+    }
+}
+
+void test_parser_frames_split_anywhere(void)
+{
+    static uint8_t stream[64 * 500];
+    uint8_t frames[500][CRSF_MAX_PACKET_LEN];
+    unsigned len = 0;
+    CRSFParser parser;
+
+    for (unsigned i = 0; i < 500; ++i)
+    {
+        const uint8_t payloadLen = (i % 3 == 0) ? sizeof(crsf_channels_t) : rng() % (CRSF_PAYLOAD_SIZE_MAX - 1);
+        len += makeTestFrame(frames[i], CRSF_FRAMETYPE_RC_CHANNELS_PACKED, payloadLen);
+        memcpy(&stream[len - (frames[i][1] + 2)], frames[i], frames[i][1] + 2);
+    }
+
+    for (unsigned maxChunk : {1, 7, 64, 300})
+    {
+        unsigned frameIdx = 0;
+        feedParser(parser, stream, len, maxChunk, [&](CRSFParser::result_e result) {
+            TEST_ASSERT_NOT_EQUAL(CRSFParser::FRAME_BAD_CRC, result);
+            if (result == CRSFParser::FRAME_OK)
+            {
+                TEST_ASSERT_EQUAL(frames[frameIdx][1] + 2, parser.size());
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(frames[frameIdx], parser.frame().asUint8_t, parser.size());
+                frameIdx++;
+            }
+        });
+        TEST_ASSERT_EQUAL(500, frameIdx);
+    }
+}
+
+void test_parser_resync(void)
+{
+    uint8_t frame[CRSF_MAX_PACKET_LEN];
+    const uint8_t frameLen = makeTestFrameNoSyncs(frame, CRSF_FRAMETYPE_RC_CHANNELS_PACKED, sizeof(crsf_channels_t));
+    uint8_t stream[256];
+    unsigned len = 0;
+
+    // Junk, a sync byte with a bad length, one which is followed by a sync byte then a frame
+    const uint8_t junk[] = {0x01, 0x55, CRSF_SYNC_BYTE, 0x00, 0x42, CRSF_ADDRESS_CRSF_TRANSMITTER, 0xff, CRSF_SYNC_BYTE};
+    memcpy(&stream[len], junk, sizeof(junk));
+    len += sizeof(junk);
+    memcpy(&stream[len], frame, frameLen);
+    len += frameLen;
+    // A frame with a bad CRC is dropped, and the one after it is still parsed
+    memcpy(&stream[len], frame, frameLen);
+    stream[len + 5] ^= 1;
+    len += frameLen;
+    memcpy(&stream[len], frame, frameLen);
+    len += frameLen;
+
+    CRSFParser parser;
+    unsigned good = 0;
+    unsigned bad = 0;
+    feedParser(parser, stream, len, 1, [&](CRSFParser::result_e result) {
+        if (result == CRSFParser::FRAME_OK)
+        {
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, parser.frame().asUint8_t, frameLen);
+            good++;
+        }
+        else if (result == CRSFParser::FRAME_BAD_CRC)
+        {
+            bad++;
+        }
+    });
+    TEST_ASSERT_EQUAL(2, good);
+    TEST_ASSERT_EQUAL(1, bad);
+}
+
+void test_parser_frame_inside_false_sync(void)
+{
+    static uint8_t stream[64 * 200];
+    uint8_t frames[100][CRSF_MAX_PACKET_LEN];
+    unsigned len = 0;
+    CRSFParser parser;
+
+    // Each frame is preceded by a false sync byte whose length takes in the start of the frame
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        const uint8_t frameLen = makeTestFrame(frames[i], CRSF_FRAMETYPE_RC_CHANNELS_PACKED, sizeof(crsf_channels_t));
+        stream[len++] = CRSF_SYNC_BYTE;
+        stream[len++] = 2 + rng() % (frameLen + 10);
+        memcpy(&stream[len], frames[i], frameLen);
+        len += frameLen;
+    }
+
+    for (unsigned maxChunk : {1, 7, 64, 300})
+    {
+        unsigned frameIdx = 0;
+        feedParser(parser, stream, len, maxChunk, [&](CRSFParser::result_e result) {
+            if (result == CRSFParser::FRAME_OK)
+            {
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(frames[frameIdx], parser.frame().asUint8_t, parser.size());
+                frameIdx++;
+            }
+        });
+        TEST_ASSERT_EQUAL(100, frameIdx);
+    }
+}
+
+void test_parser_fuzz(void)
+{
+    static uint8_t stream[256 * 1024];
+    CRSFParser parser;
+
+    // Random bytes, with a high proportion of sync bytes and short lengths so some frames get through
+    for (unsigned i = 0; i < sizeof(stream); ++i)
+    {
+        const uint32_t r = rng();
+        stream[i] = (r & 7) == 0 ? CRSF_SYNC_BYTE : ((r & 7) == 1 ? 2 + (r >> 3) % 4 : r >> 3);
+    }
+
+    unsigned good = 0;
+    feedParser(parser, stream, sizeof(stream), 64, [&](CRSFParser::result_e result) {
+        if (result == CRSFParser::FRAME_OK)
+        {
+            const uint8_t *frame = parser.frame().asUint8_t;
+            TEST_ASSERT_EQUAL(frame[1] + 2, parser.size());
+            TEST_ASSERT_TRUE(parser.size() >= 4 && parser.size() <= CRSF_MAX_PACKET_LEN);
+            TEST_ASSERT_EQUAL(test_crc.calc(&frame[2], parser.size() - 3), frame[parser.size() - 1]);
+            good++;
+        }
+    });
+    TEST_ASSERT_TRUE(good > 0);
+}
+
+void test_parser_throughput(void)
+{
+    constexpr unsigned frameCount = 50000;
+    static uint8_t stream[frameCount * 26];
+    unsigned len = 0;
+    for (unsigned i = 0; i < frameCount; ++i)
+    {
+        len += makeTestFrame(&stream[len], CRSF_FRAMETYPE_RC_CHANNELS_PACKED, sizeof(crsf_channels_t));
+    }
+
+    CRSFParser parser;
+    unsigned good = 0;
+    const uint32_t start = micros();
+    feedParser(parser, stream, len, 64, [&](CRSFParser::result_e result) {
+        good += result == CRSFParser::FRAME_OK;
+    });
+    const uint32_t elapsed = micros() - start;
+
+    TEST_ASSERT_EQUAL(frameCount, good);
+    char msg[80];
+    snprintf(msg, sizeof(msg), "%u RC frames in %u us, %.1f MB/s", frameCount, elapsed, (double)len / std::max(elapsed, 1U));
+    TEST_MESSAGE(msg);
+}
+
+static uint8_t rxFramesSeen;
+static uint32_t rxLastArrival;
+static void onRxFrame(const uint8_t *frame, uint32_t arrivalMicros)
+{
+    rxFramesSeen++;
+    rxLastArrival = arrivalMicros;
+}
+
+/**
+ * Mock the UART event source: frames arrive back to back at 400k baud (25us per byte), and the
+ * event fires after the line has been idle for 2 byte times, sometimes late because the event
+ * task was busy, in which case bytes of the next frame may have arrived too
+ */
+void test_rxqueue_timestamps(void)
+{
+    constexpr uint32_t baud = 400000;
+    constexpr uint32_t byteMicros = 25;
+    constexpr uint8_t idle = 2;
+    CRSFRxQueue queue;
+    queue.setBaudRate(baud, idle);
+    queue.setFrameCallback(onRxFrame);
+    rxFramesSeen = 0;
+
+    uint8_t frames[8][CRSF_MAX_PACKET_LEN];
+    uint8_t sizes[8];
+    uint32_t frameEnd[8];
+    uint32_t t = 1000000;
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        sizes[i] = makeTestFrame(frames[i], CRSF_FRAMETYPE_RC_CHANNELS_PACKED, sizeof(crsf_channels_t));
+        // The time the last byte of the frame arrived, frames are 4ms apart
+        frameEnd[i] = t + sizes[i] * byteMicros;
+        t += 4000;
+    }
+
+    // Frame 0: one event just after the idle time
+    queue.receive(frames[0], sizes[0], frameEnd[0] + idle * byteMicros);
+    TEST_ASSERT_EQUAL(1, rxFramesSeen);
+    TEST_ASSERT_EQUAL(frameEnd[0], rxLastArrival);
+
+    // Frame 1: the read is handed over in two pieces
+    queue.receive(frames[1], 10, frameEnd[1] + idle * byteMicros, sizes[1] - 10);
+    TEST_ASSERT_EQUAL(1, rxFramesSeen);
+    queue.receive(&frames[1][10], sizes[1] - 10, frameEnd[1] + idle * byteMicros);
+    TEST_ASSERT_EQUAL(2, rxFramesSeen);
+    TEST_ASSERT_EQUAL(frameEnd[1], rxLastArrival);
+
+    // Frame 2: a gap in the middle of the frame fired an event with a partial frame
+    queue.receive(frames[2], 5, frameEnd[2] - (sizes[2] - 5) * byteMicros + idle * byteMicros);
+    queue.receive(&frames[2][5], sizes[2] - 5, frameEnd[2] + idle * byteMicros);
+    TEST_ASSERT_EQUAL(3, rxFramesSeen);
+    TEST_ASSERT_EQUAL(frameEnd[2], rxLastArrival);
+
+    // Frames 3 and 4 together, the event for 3 was missed so 4 ended 2 bytes before the event
+    uint8_t both[2 * CRSF_MAX_PACKET_LEN];
+    memcpy(both, frames[3], sizes[3]);
+    memcpy(&both[sizes[3]], frames[4], sizes[4]);
+    queue.receive(both, sizes[3] + sizes[4], frameEnd[4] + idle * byteMicros);
+    TEST_ASSERT_EQUAL(5, rxFramesSeen);
+    TEST_ASSERT_EQUAL(frameEnd[4], rxLastArrival);
+
+    // The consumer gets all the frames in order with their arrival times, the time for frame 3 is
+    // only as good as its bytes being back to back with 4
+    uint8_t frame[CRSF_MAX_PACKET_LEN];
+    uint32_t arrival;
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        TEST_ASSERT_EQUAL(sizes[i], queue.pop(frame, &arrival));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(frames[i], frame, sizes[i]);
+        if (i != 3)
+        {
+            TEST_ASSERT_EQUAL(frameEnd[i], arrival);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, queue.pop(frame, &arrival));
+
+    uint32_t good = 0;
+    uint32_t bad = 0;
+    queue.takeCounts(&good, &bad);
+    TEST_ASSERT_EQUAL(5, good);
+    TEST_ASSERT_EQUAL(0, bad);
+}
+
+void test_rxqueue_flush(void)
+{
+    CRSFRxQueue queue;
+    queue.setBaudRate(5250000, 2);
+    uint8_t frame[CRSF_MAX_PACKET_LEN];
+    const uint8_t size = makeTestFrameNoSyncs(frame, CRSF_FRAMETYPE_RC_CHANNELS_PACKED, sizeof(crsf_channels_t));
+
+    // A complete frame and half of the next are discarded by the flush
+    queue.receive(frame, size, 100);
+    queue.receive(frame, size / 2, 200);
+    queue.flush(250);
+    uint8_t out[CRSF_MAX_PACKET_LEN];
+    uint32_t arrival;
+    TEST_ASSERT_EQUAL(0, queue.pop(out, &arrival));
+
+    // So is an event from before the flush which is handled after it
+    queue.receive(frame, size, 240);
+    TEST_ASSERT_EQUAL(0, queue.pop(out, &arrival));
+
+    // And the start of an event which arrived before the flush, but not the frame after it
+    uint8_t stream[10 + CRSF_MAX_PACKET_LEN];
+    memset(stream, 0x55, 10);
+    memcpy(&stream[10], frame, size);
+    queue.receive(stream, 10 + size, 301);
+    TEST_ASSERT_EQUAL(size, queue.pop(out, &arrival));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, out, size);
+    TEST_ASSERT_EQUAL(0, queue.pop(out, &arrival));
+
+    // A corrupt frame is counted
+    frame[5] ^= 1;
+    queue.receive(frame, size, 400);
+    frame[5] ^= 1;
+    queue.receive(frame, size, 500);
+    TEST_ASSERT_EQUAL(size, queue.pop(out, &arrival));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, out, size);
+    // 2 byte times at 5.25Mbaud is under 4us
+    TEST_ASSERT_UINT32_WITHIN(1, 500 - 4, arrival);
+
+    uint32_t good = 0;
+    uint32_t bad = 0;
+    queue.takeCounts(&good, &bad);
+    TEST_ASSERT_EQUAL(3, good);
+    TEST_ASSERT_EQUAL(1, bad);
+    queue.takeCounts(&good, &bad);
+    TEST_ASSERT_EQUAL(3, good);
+    TEST_ASSERT_EQUAL(1, bad);
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -71,6 +480,15 @@ int main(int argc, char **argv)
     UNITY_BEGIN();
     RUN_TEST(test_ver_to_u32);
     RUN_TEST(test_device_info);
+    RUN_TEST(test_unpack_channels);
+    RUN_TEST(test_pack_channels);
+    RUN_TEST(test_parser_frames_split_anywhere);
+    RUN_TEST(test_parser_resync);
+    RUN_TEST(test_parser_frame_inside_false_sync);
+    RUN_TEST(test_parser_fuzz);
+    RUN_TEST(test_parser_throughput);
+    RUN_TEST(test_rxqueue_timestamps);
+    RUN_TEST(test_rxqueue_flush);
     UNITY_END();
 
     return 0;
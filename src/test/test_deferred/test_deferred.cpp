@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <unity.h>
+
+#include "deferred.h"
+
+// Normally from rxtx_common.cpp
+DeferredQueue<maxDeferredFunctions> deferredFunctions;
+
+// Count every allocation so the tests can check deferring does not allocate
+static unsigned allocations = 0;
+void *operator new(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+static uint8_t callLog[32];
+static uint8_t callCount;
+
+static void logCall(uint8_t id)
+{
+    callLog[callCount++] = id;
+}
+
+static void functionPointer()
+{
+    logCall(99);
+}
+
+void test_deferred_order(void)
+{
+    DeferredQueue<8> queue;
+    callCount = 0;
+
+    // Deferred out of order, with captures of different sizes
+    const uint8_t a = 1;
+    const uint32_t b = 2;
+    const uint16_t c = 3;
+    const uint64_t d = 4;
+    queue.defer(1000, 500, [a]() { logCall(a); });
+    queue.defer(1000, 100, [b]() { logCall(b); });
+    queue.defer(1100, 300, [b, c]() { logCall(c); });
+    queue.defer(1050, 1000, [d, a]() { logCall(d); });
+    queue.defer(1000, 200, functionPointer);
+    TEST_ASSERT_EQUAL(5, queue.pending());
+
+    // Nothing until the time has elapsed
+    queue.execute(1100);
+    TEST_ASSERT_EQUAL(0, callCount);
+
+    // Several expired together are called earliest deadline first
+    queue.execute(1450);
+    const uint8_t expected1[] = {2, 99, 3};
+    TEST_ASSERT_EQUAL(sizeof(expected1), callCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected1, callLog, sizeof(expected1));
+
+    queue.execute(5000);
+    const uint8_t expected2[] = {2, 99, 3, 1, 4};
+    TEST_ASSERT_EQUAL(sizeof(expected2), callCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected2, callLog, sizeof(expected2));
+    TEST_ASSERT_EQUAL(0, queue.pending());
+
+    // Across the micros() wraparound
+    queue.defer(0xFFFFFF00, 0x200, []() { logCall(5); });
+    queue.execute(0xFFFFFFF0);
+    queue.execute(0x00000050);
+    TEST_ASSERT_EQUAL(5, callCount);
+    queue.execute(0x00000101);
+    TEST_ASSERT_EQUAL(6, callCount);
+}
+
+static DeferredQueue<2> *reentrantQueue;
+
+void test_deferred_full_and_cancel(void)
+{
+    DeferredQueue<2> queue;
+    callCount = 0;
+
+    const deferred_handle_t h1 = queue.defer(0, 100, []() { logCall(1); });
+    const deferred_handle_t h2 = queue.defer(0, 100, []() { logCall(2); });
+    TEST_ASSERT_NOT_EQUAL(DEFERRED_HANDLE_NONE, h1);
+    TEST_ASSERT_NOT_EQUAL(DEFERRED_HANDLE_NONE, h2);
+    TEST_ASSERT_EQUAL(DEFERRED_HANDLE_NONE, queue.defer(0, 100, []() { logCall(3); }));
+
+    TEST_ASSERT_TRUE(queue.cancel(h1));
+    TEST_ASSERT_FALSE(queue.cancel(h1));
+    TEST_ASSERT_FALSE(queue.cancel(DEFERRED_HANDLE_NONE));
+
+    // The slot is reused and the old handle does not cancel the new function
+    const deferred_handle_t h3 = queue.defer(10, 100, []() { logCall(3); });
+    TEST_ASSERT_NOT_EQUAL(h1, h3);
+    TEST_ASSERT_FALSE(queue.cancel(h1));
+
+    queue.execute(200);
+    const uint8_t expected[] = {2, 3};
+    TEST_ASSERT_EQUAL(sizeof(expected), callCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, callLog, sizeof(expected));
+    TEST_ASSERT_FALSE(queue.cancel(h3));
+
+    // A function can defer another into its own slot, which is not called in the same pass
+    reentrantQueue = &queue;
+    callCount = 0;
+    queue.defer(200, 0, []() { logCall(4); });
+    queue.defer(200, 10, []() {
+        logCall(5);
+        reentrantQueue->defer(300, 10, []() { logCall(6); });
+        reentrantQueue->defer(300, 20, []() { logCall(7); });
+    });
+    queue.execute(300);
+    TEST_ASSERT_EQUAL(2, callCount);
+    queue.execute(400);
+    const uint8_t expected2[] = {4, 5, 6, 7};
+    TEST_ASSERT_EQUAL(sizeof(expected2), callCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected2, callLog, sizeof(expected2));
+}
+
+void test_deferred_no_allocation(void)
+{
+    callCount = 0;
+    const unsigned before = allocations;
+    for (int i = 0; i < 1000; i++)
+    {
+        const uint32_t x = i;
+        const uint8_t y = i;
+        const deferred_handle_t handle = deferExecutionMicros(0, [x, y]() { logCall(x + y); });
+        TEST_ASSERT_NOT_EQUAL(DEFERRED_HANDLE_NONE, handle);
+        deferExecutionMillis(1, functionPointer);
+        cancelDeferredExecution(handle);
+        executeDeferredFunction(micros() + 1001);
+        callCount = 0;
+    }
+    TEST_ASSERT_EQUAL(before, allocations);
+    TEST_ASSERT_EQUAL(0, deferredFunctions.pending());
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_deferred_order);
+    RUN_TEST(test_deferred_full_and_cancel);
+    RUN_TEST(test_deferred_no_allocation);
+    UNITY_END();
+
+    return 0;
+}
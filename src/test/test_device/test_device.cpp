@@ -0,0 +1,206 @@
+#include <cstdint>
+#include <cstring>
+#include <unity.h>
+
+#include "common.h"
+#include "device.h"
+
+// Normally from common.cpp
+bool connectionHasModelMatch = false;
+bool teamraceHasModelMatch = true;
+connectionState_e connectionState = disconnected;
+
+static constexpr int NUM_DEVICES = 16;
+
+// What each device returns from start(), event() and timeout()
+static int startDelay[NUM_DEVICES];
+static int eventDelay[NUM_DEVICES];
+static int timeoutDelay[NUM_DEVICES];
+
+// The order in which the devices' functions were called
+static uint8_t timeoutLog[64];
+static uint8_t timeoutLogCount;
+static uint8_t eventLog[64];
+static uint8_t eventLogCount;
+
+template <int N> static int start() { return startDelay[N]; }
+template <int N> static int event() { eventLog[eventLogCount++] = N; return eventDelay[N]; }
+template <int N> static int timeout() { timeoutLog[timeoutLogCount++] = N; return timeoutDelay[N]; }
+
+#define TEST_DEVICE(N) {nullptr, start<N>, event<N>, timeout<N>, 0}
+static device_t devices[NUM_DEVICES] = {
+    TEST_DEVICE(0), TEST_DEVICE(1), TEST_DEVICE(2), TEST_DEVICE(3),
+    TEST_DEVICE(4), TEST_DEVICE(5), TEST_DEVICE(6), TEST_DEVICE(7),
+    TEST_DEVICE(8), TEST_DEVICE(9), TEST_DEVICE(10), TEST_DEVICE(11),
+    TEST_DEVICE(12), TEST_DEVICE(13), TEST_DEVICE(14), TEST_DEVICE(15),
+};
+static device_affinity_t affinity[NUM_DEVICES];
+
+static void startDevices(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        affinity[i] = {&devices[i], 1};
+    }
+    devicesRegister(affinity, count);
+    devicesStart(); // at millis() == 0
+    timeoutLogCount = 0;
+    eventLogCount = 0;
+}
+
+void test_timeout_ordering(void)
+{
+    // Deadlines deliberately not in registration order, 3 and 9 are the same
+    const int delays[NUM_DEVICES] = {70, 10, 150, 40, 5, DURATION_NEVER, 90, 20, 130, 40, 60, 110, 30, 80, 140, 100};
+    for (int i = 0; i < NUM_DEVICES; i++)
+    {
+        startDelay[i] = delays[i];
+        eventDelay[i] = DURATION_IGNORE;
+        timeoutDelay[i] = DURATION_NEVER;
+    }
+    startDevices(NUM_DEVICES);
+
+    // Nothing expired yet, the next is device 4 at 5ms
+    TEST_ASSERT_EQUAL(5, devicesUpdate(0));
+    TEST_ASSERT_EQUAL(0, timeoutLogCount);
+
+    // Everything up to 45ms, in deadline order then registration order
+    TEST_ASSERT_EQUAL(15, devicesUpdate(45));
+    const uint8_t expected1[] = {4, 1, 7, 12, 3, 9};
+    TEST_ASSERT_EQUAL(sizeof(expected1), timeoutLogCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected1, timeoutLog, sizeof(expected1));
+
+    // The rest, late, in order
+    timeoutLogCount = 0;
+    TEST_ASSERT_EQUAL(DURATION_NEVER, devicesUpdate(1000));
+    const uint8_t expected2[] = {10, 0, 13, 6, 15, 11, 8, 14, 2};
+    TEST_ASSERT_EQUAL(sizeof(expected2), timeoutLogCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected2, timeoutLog, sizeof(expected2));
+}
+
+void test_timeout_rearm(void)
+{
+    startDelay[0] = DURATION_IMMEDIATELY; // called every update
+    timeoutDelay[0] = DURATION_IMMEDIATELY;
+    startDelay[1] = 10;                    // periodic every 10ms
+    timeoutDelay[1] = 10;
+    startDelay[2] = 5;                     // once, then only after an event
+    timeoutDelay[2] = DURATION_NEVER;
+    eventDelay[0] = DURATION_IGNORE;
+    eventDelay[1] = DURATION_IGNORE;
+    eventDelay[2] = 3;
+    startDevices(3);
+
+    // An immediate device is only called once per update
+    TEST_ASSERT_EQUAL(DURATION_IMMEDIATELY, devicesUpdate(0));
+    TEST_ASSERT_EQUAL(1, timeoutLogCount);
+    TEST_ASSERT_EQUAL(0, timeoutLog[0]);
+
+    unsigned counts[3] = {0, 0, 0};
+    timeoutLogCount = 0;
+    for (unsigned long now = 1; now <= 50; now++)
+    {
+        devicesUpdate(now);
+    }
+    for (int i = 0; i < timeoutLogCount; i++)
+    {
+        counts[timeoutLog[i]]++;
+    }
+    TEST_ASSERT_EQUAL(50, counts[0]);
+    TEST_ASSERT_EQUAL(5, counts[1]);
+    TEST_ASSERT_EQUAL(1, counts[2]);
+
+    // An event re-arms device 2 for 3ms later, and leaves the others alone
+    timeoutLogCount = 0;
+    devicesTriggerEvent();
+    devicesUpdate(51);
+    TEST_ASSERT_EQUAL(3, eventLogCount);
+    TEST_ASSERT_EQUAL(1, timeoutLogCount);
+    devicesUpdate(54);
+    TEST_ASSERT_EQUAL(3, timeoutLogCount);
+    TEST_ASSERT_EQUAL(2, timeoutLog[2]);
+
+    // An event can cancel a timeout
+    eventDelay[1] = DURATION_NEVER;
+    eventDelay[2] = DURATION_IGNORE;
+    devicesTriggerEvent();
+    timeoutLogCount = 0;
+    for (unsigned long now = 55; now <= 100; now++)
+    {
+        devicesUpdate(now);
+    }
+    for (int i = 0; i < timeoutLogCount; i++)
+    {
+        TEST_ASSERT_EQUAL(0, timeoutLog[i]);
+    }
+}
+
+void test_event_fanout(void)
+{
+    const uint32_t subscriptions[NUM_DEVICES] = {
+        0, EVENT_POWER_CHANGED, EVENT_CONNECTION_CHANGED, EVENT_CONFIG_CHANGED,
+        EVENT_CONNECTION_CHANGED | EVENT_CONFIG_CHANGED, EVENT_VTX_CHANGED, 0, EVENT_ARM_CHANGED,
+        EVENT_BINDING_CHANGED, EVENT_POWER_CHANGED | EVENT_VTX_CHANGED, EVENT_CONNECTION_CHANGED, EVENT_CONFIG_CHANGED,
+        EVENT_CONFIG_CHANGED, EVENT_ARM_CHANGED, EVENT_CONNECTION_CHANGED | EVENT_POWER_CHANGED, EVENT_ALL,
+    };
+    for (int i = 0; i < NUM_DEVICES; i++)
+    {
+        devices[i].events = subscriptions[i];
+        startDelay[i] = DURATION_NEVER;
+        eventDelay[i] = DURATION_IGNORE;
+    }
+    connectionState = disconnected;
+    startDevices(NUM_DEVICES);
+
+    // No events, nothing called
+    devicesUpdate(0);
+    TEST_ASSERT_EQUAL(0, eventLogCount);
+
+    devicesTriggerEvent(EVENT_POWER_CHANGED);
+    devicesUpdate(1);
+    const uint8_t power[] = {0, 1, 6, 9, 14, 15};
+    TEST_ASSERT_EQUAL(sizeof(power), eventLogCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(power, eventLog, sizeof(power));
+
+    // A connection state change fires EVENT_CONNECTION_CHANGED by itself
+    eventLogCount = 0;
+    connectionState = connected;
+    devicesUpdate(2);
+    const uint8_t connection[] = {0, 2, 4, 6, 10, 14, 15};
+    TEST_ASSERT_EQUAL(sizeof(connection), eventLogCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(connection, eventLog, sizeof(connection));
+
+    // Several events before an update call each device once
+    eventLogCount = 0;
+    devicesTriggerEvent(EVENT_CONFIG_CHANGED);
+    devicesTriggerEvent(EVENT_ARM_CHANGED);
+    devicesUpdate(3);
+    const uint8_t configArm[] = {0, 3, 4, 6, 7, 11, 12, 13, 15};
+    TEST_ASSERT_EQUAL(sizeof(configArm), eventLogCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(configArm, eventLog, sizeof(configArm));
+
+    // And the events are cleared
+    eventLogCount = 0;
+    devicesUpdate(4);
+    TEST_ASSERT_EQUAL(0, eventLogCount);
+
+    for (int i = 0; i < NUM_DEVICES; i++)
+    {
+        devices[i].events = 0;
+    }
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_timeout_ordering);
+    RUN_TEST(test_timeout_rearm);
+    RUN_TEST(test_event_fanout);
+    UNITY_END();
+
+    return 0;
+}
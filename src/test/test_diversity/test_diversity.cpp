@@ -0,0 +1,214 @@
+#include <cstdint>
+#include <cstring>
+#include <SX12xxDiversity.h>
+#include <unity.h>
+
+typedef SX12xxDriverCommon::rx_status rx_status;
+
+#define IRQ_RX_DONE 0x0002
+#define IRQ_CRC_ERROR 0x0040
+#define PAYLOAD_LENGTH 8
+
+// A model of two SX1280s, counting the SPI bytes each command would transfer
+class MockRadio
+{
+public:
+    uint16_t irqStatus[2];
+    int8_t rssi[2];
+    int8_t snr[2];
+    uint8_t payload[2][PAYLOAD_LENGTH];
+
+    uint8_t RXdataBuffer[PAYLOAD_LENGTH];
+    uint32_t spiBytes;
+    uint8_t payloadReads;
+    uint8_t callbacks;
+    rx_status lastStatus;
+
+    MockRadio()
+    {
+        memset(this, 0, sizeof(*this));
+    }
+
+    uint16_t GetIrqStatus(SX12XX_Radio_Number_t radioNumber)
+    {
+        spiBytes += 2 + 2; // opcode, status, 2 bytes IRQ
+        return irqStatus[index(radioNumber)];
+    }
+
+    rx_status GetRxStatus(uint16_t irq)
+    {
+        if (!(irq & IRQ_RX_DONE))
+            return SX12xxDriverCommon::SX12XX_RX_TIMEOUT;
+        return (irq & IRQ_CRC_ERROR) ? SX12xxDriverCommon::SX12XX_RX_CRC_FAIL : SX12xxDriverCommon::SX12XX_RX_OK;
+    }
+
+    void GetPacketStats(SX12XX_Radio_Number_t radioNumber, int8_t *r, int8_t *s)
+    {
+        spiBytes += 2 + 2; // GET_PACKETSTATUS: opcode, status, 2 bytes
+        *r = rssi[index(radioNumber)];
+        *s = snr[index(radioNumber)];
+    }
+
+    void ReadPayload(SX12XX_Radio_Number_t radioNumber)
+    {
+        spiBytes += 2 + 2;              // GET_RXBUFFERSTATUS: opcode, status, 2 bytes
+        spiBytes += 3 + PAYLOAD_LENGTH; // READ_BUFFER: opcode, offset, status, payload
+        payloadReads++;
+        memcpy(RXdataBuffer, payload[index(radioNumber)], PAYLOAD_LENGTH);
+    }
+
+    // The OTA CRC, modelled as the first byte of the payload being 0x55
+    bool RXdoneCallback(rx_status status)
+    {
+        callbacks++;
+        lastStatus = status;
+        return status == SX12xxDriverCommon::SX12XX_RX_OK && RXdataBuffer[0] == 0x55;
+    }
+
+    static uint8_t index(SX12XX_Radio_Number_t radioNumber) { return radioNumber == SX12XX_Radio_1 ? 0 : 1; }
+};
+
+static void setPacket(MockRadio &radio, uint8_t i, int8_t rssi, int8_t snr, bool good = true)
+{
+    radio.irqStatus[i] = IRQ_RX_DONE;
+    radio.rssi[i] = rssi;
+    radio.snr[i] = snr;
+    memset(radio.payload[i], i + 1, PAYLOAD_LENGTH);
+    radio.payload[i][0] = good ? 0x55 : 0xAA;
+}
+
+// SPI bytes the previous implementation transferred for a packet received on both radios:
+// the other radio's IRQ status, both RX buffer addresses and payloads, both packet statuses
+static uint32_t dualReadSpiBytes()
+{
+    return 4 + 2 * (4 + 3 + PAYLOAD_LENGTH) + 2 * 4;
+}
+
+void test_diversity_single_radio(void)
+{
+    MockRadio radio;
+    SX12xxDiversity diversity;
+    setPacket(radio, 0, -60, 20);
+
+    TEST_ASSERT_TRUE(diversity.receive(radio, radio.irqStatus[0], SX12XX_Radio_1, false));
+    TEST_ASSERT_EQUAL(SX12XX_Radio_1, diversity.usedRadio);
+    TEST_ASSERT_TRUE(diversity.gotRadio[0]);
+    TEST_ASSERT_FALSE(diversity.gotRadio[1]);
+    TEST_ASSERT_EQUAL(-60, diversity.rssi[0]);
+    TEST_ASSERT_EQUAL(1, radio.payloadReads);
+    TEST_ASSERT_EQUAL(1, radio.callbacks);
+    // Packet status and one payload read, the other radio is not touched
+    TEST_ASSERT_EQUAL(4 + 4 + 3 + PAYLOAD_LENGTH, radio.spiBytes);
+}
+
+void test_diversity_reads_stronger_radio_once(void)
+{
+    MockRadio radio;
+    SX12xxDiversity diversity;
+    setPacket(radio, 0, -90, 5);
+    setPacket(radio, 1, -70, 10);
+
+    TEST_ASSERT_TRUE(diversity.receive(radio, radio.irqStatus[0], SX12XX_Radio_1, true));
+    TEST_ASSERT_EQUAL(SX12XX_Radio_2, diversity.usedRadio);
+    TEST_ASSERT_TRUE(diversity.gotRadio[0]);
+    TEST_ASSERT_TRUE(diversity.gotRadio[1]);
+    TEST_ASSERT_EQUAL(-90, diversity.rssi[0]);
+    TEST_ASSERT_EQUAL(-70, diversity.rssi[1]);
+    TEST_ASSERT_EQUAL(10, diversity.snr[1]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(radio.payload[1], radio.RXdataBuffer, PAYLOAD_LENGTH);
+    TEST_ASSERT_EQUAL(1, radio.payloadReads);
+    TEST_ASSERT_EQUAL(1, radio.callbacks);
+
+    const uint32_t dual = dualReadSpiBytes();
+    char msg[64];
+    snprintf(msg, sizeof(msg), "SPI bytes per packet %u, dual read %u", (unsigned)radio.spiBytes, (unsigned)dual);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(4 + 2 * 4 + 4 + 3 + PAYLOAD_LENGTH, radio.spiBytes);
+    TEST_ASSERT_LESS_THAN(dual, radio.spiBytes);
+
+    // Same RSSI, SNR decides, then a full tie stays with the radio which raised the IRQ
+    MockRadio tie;
+    setPacket(tie, 0, -80, 4);
+    setPacket(tie, 1, -80, 8);
+    diversity.receive(tie, tie.irqStatus[0], SX12XX_Radio_1, true);
+    TEST_ASSERT_EQUAL(SX12XX_Radio_2, diversity.usedRadio);
+    tie.snr[1] = 4;
+    diversity.receive(tie, tie.irqStatus[1], SX12XX_Radio_2, true);
+    TEST_ASSERT_EQUAL(SX12XX_Radio_2, diversity.usedRadio);
+    diversity.receive(tie, tie.irqStatus[0], SX12XX_Radio_1, true);
+    TEST_ASSERT_EQUAL(SX12XX_Radio_1, diversity.usedRadio);
+}
+
+void test_diversity_fallback_on_crc_fail(void)
+{
+    MockRadio radio;
+    SX12xxDiversity diversity;
+    setPacket(radio, 0, -95, 2);
+    setPacket(radio, 1, -60, 20, false);
+
+    // The stronger radio's payload fails the CRC, the other radio's is read and used
+    TEST_ASSERT_TRUE(diversity.receive(radio, radio.irqStatus[1], SX12XX_Radio_2, true));
+    TEST_ASSERT_EQUAL(SX12XX_Radio_1, diversity.usedRadio);
+    TEST_ASSERT_TRUE(diversity.gotRadio[0]);
+    TEST_ASSERT_FALSE(diversity.gotRadio[1]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(radio.payload[0], radio.RXdataBuffer, PAYLOAD_LENGTH);
+    TEST_ASSERT_EQUAL(2, radio.payloadReads);
+    TEST_ASSERT_EQUAL(2, radio.callbacks);
+    TEST_ASSERT_TRUE(diversity.triedBoth);
+
+    // Both bad, the ISR clears both radios rather than reading them again
+    MockRadio bad;
+    setPacket(bad, 0, -95, 2, false);
+    setPacket(bad, 1, -60, 20, false);
+    TEST_ASSERT_FALSE(diversity.receive(bad, bad.irqStatus[0], SX12XX_Radio_1, true));
+    TEST_ASSERT_EQUAL(2, bad.payloadReads);
+    TEST_ASSERT_TRUE(diversity.triedBoth);
+
+    // Only one radio got it, no fallback
+    MockRadio one;
+    setPacket(one, 0, -95, 2, false);
+    TEST_ASSERT_FALSE(diversity.receive(one, one.irqStatus[0], SX12XX_Radio_1, true));
+    TEST_ASSERT_EQUAL(1, one.payloadReads);
+    TEST_ASSERT_EQUAL(1, one.callbacks);
+    TEST_ASSERT_FALSE(diversity.triedBoth);
+}
+
+void test_diversity_other_radio_failed(void)
+{
+    MockRadio radio;
+    SX12xxDiversity diversity;
+    setPacket(radio, 0, -90, 5);
+    setPacket(radio, 1, -50, 30);
+
+    // Other radio's hardware CRC failed, its stats are not read even though it is stronger
+    radio.irqStatus[1] |= IRQ_CRC_ERROR;
+    TEST_ASSERT_TRUE(diversity.receive(radio, radio.irqStatus[0], SX12XX_Radio_1, true));
+    TEST_ASSERT_EQUAL(SX12XX_Radio_1, diversity.usedRadio);
+    TEST_ASSERT_FALSE(diversity.gotRadio[1]);
+    TEST_ASSERT_EQUAL(4 + 4 + 4 + 3 + PAYLOAD_LENGTH, radio.spiBytes);
+
+    // The radio which raised the IRQ failed, nothing is read
+    MockRadio failed;
+    setPacket(failed, 0, -90, 5);
+    failed.irqStatus[0] |= IRQ_CRC_ERROR;
+    TEST_ASSERT_FALSE(diversity.receive(failed, failed.irqStatus[0], SX12XX_Radio_1, true));
+    TEST_ASSERT_EQUAL(SX12xxDriverCommon::SX12XX_RX_CRC_FAIL, failed.lastStatus);
+    TEST_ASSERT_EQUAL(0, failed.spiBytes);
+    TEST_ASSERT_FALSE(diversity.gotRadio[0]);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_diversity_single_radio);
+    RUN_TEST(test_diversity_reads_stronger_radio_once);
+    RUN_TEST(test_diversity_fallback_on_crc_fail);
+    RUN_TEST(test_diversity_other_radio_failed);
+    UNITY_END();
+
+    return 0;
+}
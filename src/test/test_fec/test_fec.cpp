@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <unity.h>
+
+#include "FEC.h"
+
+// The bit at a time implementation which FECEncode/FECDecode must match exactly
+static void referenceEncode(const uint8_t *incomingData, uint8_t *FECBuffer)
+{
+    uint8_t encodedBuffer[8 * 2] = {0};
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        encodedBuffer[i * 2 + 0] = HammingTableEncode(incomingData[i] & 0x0F);
+        encodedBuffer[i * 2 + 1] = HammingTableEncode(incomingData[i] >> 4);
+    }
+
+    memset(FECBuffer, 0, 14);
+    for (uint8_t i = 0; i < (14 / 2); i++)
+    {
+        for (uint8_t j = 0; j < 8; j++)
+        {
+            FECBuffer[i * 2 + 0] |= ((encodedBuffer[j + 0] >> i) & 0x01) << j;
+            FECBuffer[i * 2 + 1] |= ((encodedBuffer[j + 8] >> i) & 0x01) << j;
+        }
+    }
+}
+
+static void referenceDecode(const uint8_t *incomingFECBuffer, uint8_t *outgoingData)
+{
+    uint8_t encodedBuffer[16] = {0};
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        for (uint8_t j = 0; j < 7; j++)
+        {
+            encodedBuffer[i + 0] |= ((incomingFECBuffer[j * 2 + 0] >> i) & 0x01) << j;
+            encodedBuffer[i + 8] |= ((incomingFECBuffer[j * 2 + 1] >> i) & 0x01) << j;
+        }
+    }
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        outgoingData[i] = HammingTableDecode(encodedBuffer[i * 2 + 0]);
+        outgoingData[i] |= HammingTableDecode(encodedBuffer[i * 2 + 1]) << 4;
+    }
+}
+
+static void randomBytes(uint8_t *buf, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+        buf[i] = rand();
+}
+
+void test_fec_encode_matches_reference(void)
+{
+    // Every value in every position, with random data around it
+    for (uint8_t pos = 0; pos < 8; pos++)
+    {
+        for (unsigned value = 0; value < 256; value++)
+        {
+            uint8_t data[8];
+            randomBytes(data, sizeof(data));
+            data[pos] = value;
+
+            uint8_t expected[14];
+            uint8_t actual[14];
+            referenceEncode(data, expected);
+            memset(actual, 0xA5, sizeof(actual)); // the whole buffer is written
+            FECEncode(data, actual);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, sizeof(expected));
+        }
+    }
+}
+
+void test_fec_decode_matches_reference(void)
+{
+    // Every value in every position, which covers all errors in one byte
+    for (uint8_t pos = 0; pos < 14; pos++)
+    {
+        for (unsigned value = 0; value < 256; value++)
+        {
+            uint8_t fec[14];
+            randomBytes(fec, sizeof(fec));
+            fec[pos] = value;
+
+            uint8_t expected[8];
+            uint8_t actual[8];
+            referenceDecode(fec, expected);
+            FECDecode(fec, actual);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, sizeof(expected));
+        }
+    }
+}
+
+void test_fec_decode_table_matches_hamming(void)
+{
+    // One codeword at a time through the interleave, every 7 bit word, checks the whole decode table
+    for (uint8_t codeword = 0; codeword < 16; codeword++)
+    {
+        for (uint8_t code = 0; code < 128; code++)
+        {
+            uint8_t fec[14] = {0};
+            for (uint8_t bit = 0; bit < 7; bit++)
+            {
+                fec[bit * 2 + codeword / 8] |= ((code >> bit) & 1) << (codeword % 8);
+            }
+            uint8_t out[8];
+            FECDecode(fec, out);
+            const uint8_t nibble = (codeword % 2) ? out[codeword / 2] >> 4 : out[codeword / 2] & 0x0F;
+            TEST_ASSERT_EQUAL(HammingTableDecode(code), nibble);
+        }
+    }
+}
+
+void test_fec_corrects_burst(void)
+{
+    // A whole byte lost is one bit error in each of 8 codewords, all corrected
+    for (int iteration = 0; iteration < 1000; iteration++)
+    {
+        uint8_t data[8];
+        uint8_t fec[14];
+        uint8_t out[8];
+        randomBytes(data, sizeof(data));
+        FECEncode(data, fec);
+        fec[rand() % 14] ^= rand() | 1;
+        FECDecode(fec, out);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(data, out, sizeof(data));
+    }
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fec_encode_matches_reference);
+    RUN_TEST(test_fec_decode_matches_reference);
+    RUN_TEST(test_fec_decode_table_matches_hamming);
+    RUN_TEST(test_fec_corrects_burst);
+    UNITY_END();
+
+    return 0;
+}
@@ -84,6 +84,23 @@ void test_fhss_reg_same(void)
     }
 }
 
+void test_fhss_gemini_offset(void)
+{
+    FHSSrandomiseFHSSsequence(0x01020304L);
+
+    const uint32_t numFhss = FHSSgetChannelCount();
+
+    TEST_ASSERT_EQUAL(FHSSconfig->freq_start + freq_spread * ((sync_channel + numFhss / 2) % numFhss) / FREQ_SPREAD_SCALE,
+        FHSSgetInitialGeminiFreq());
+
+    for (unsigned int i = 0; i < FHSSgetSequenceCount(); i++) {
+        FHSSgetNextFreq();
+        uint32_t offsetIdx = (FHSSsequence[FHSSgetCurrIndex()] + numFhss / 2) % numFhss;
+        uint32_t expected = FHSSconfig->freq_start + freq_spread * offsetIdx / FREQ_SPREAD_SCALE;
+        TEST_ASSERT_EQUAL(expected, FHSSgetGeminiFreq());
+    }
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -96,6 +113,7 @@ int main(int argc, char **argv)
     RUN_TEST(test_fhss_unique);
     RUN_TEST(test_fhss_same);
     RUN_TEST(test_fhss_reg_same);
+    RUN_TEST(test_fhss_gemini_offset);
     UNITY_END();
 
     return 0;
@@ -1,5 +1,6 @@
 #include <cstdint>
 #include <FIFO.h>
+#include <SPSCFIFO.h>
 #include <unity.h>
 #include <set>
 
@@ -58,6 +59,99 @@ void test_fifo_ensure()
         TEST_ASSERT_EQUAL(10, f.pop()); // and that all the bytes in the head packet are what we expect
 }
 
+// Move the head and tail of a new SPSC FIFO past the middle so the next long push wraps
+static void spsc_init(SPSCFIFO<fifoSize> &spsc)
+{
+    uint8_t buf[fifoSize / 2 + 7] = {0};
+    TEST_ASSERT_TRUE(spsc.pushBytes(buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(spsc.popBytes(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL(0, spsc.size());
+}
+
+void test_spsc_bytes_wrap()
+{
+    SPSCFIFO<fifoSize> spsc;
+    spsc_init(spsc);
+    uint8_t in[fifoSize];
+    uint8_t out[fifoSize] = {0};
+    for (unsigned i = 0; i < fifoSize; i++)
+        in[i] = i ^ 0x5a;
+
+    TEST_ASSERT_TRUE(spsc.pushBytes(in, fifoSize));
+    TEST_ASSERT_EQUAL(fifoSize, spsc.size());
+    TEST_ASSERT_EQUAL(0, spsc.free());
+    TEST_ASSERT_EQUAL(in[0], spsc.peek());
+    TEST_ASSERT_TRUE(spsc.popBytes(out, fifoSize));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, out, fifoSize);
+    TEST_ASSERT_EQUAL(0, spsc.size());
+}
+
+void test_spsc_full_rejected()
+{
+    SPSCFIFO<fifoSize> spsc;
+    spsc_init(spsc);
+    uint8_t buf[fifoSize] = {0};
+    TEST_ASSERT_TRUE(spsc.pushBytes(buf, fifoSize - 10));
+    // All or nothing, a write that does not fit leaves the FIFO untouched
+    TEST_ASSERT_FALSE(spsc.pushBytes(buf, 11));
+    TEST_ASSERT_EQUAL(fifoSize - 10, spsc.size());
+    TEST_ASSERT_TRUE(spsc.pushBytes(buf, 10));
+    TEST_ASSERT_FALSE(spsc.push(1));
+    // Reading more than is available fails without consuming anything
+    TEST_ASSERT_TRUE(spsc.popBytes(buf, fifoSize - 1));
+    TEST_ASSERT_FALSE(spsc.popBytes(buf, 2));
+    TEST_ASSERT_EQUAL(1, spsc.size());
+}
+
+void test_spsc_commit()
+{
+    SPSCFIFO<fifoSize> spsc;
+    spsc_init(spsc);
+    uint8_t const hdr[] = {3, 1, 2};
+    TEST_ASSERT_TRUE(spsc.writeBytes(hdr, sizeof(hdr)));
+    TEST_ASSERT_TRUE(spsc.write(3));
+    // Nothing is visible to the consumer until the write is committed
+    TEST_ASSERT_EQUAL(0, spsc.size());
+    TEST_ASSERT_EQUAL(fifoSize - 4, spsc.free());
+    spsc.commitWrite();
+    TEST_ASSERT_EQUAL(4, spsc.size());
+
+    // An aborted write is discarded and its space is returned
+    TEST_ASSERT_TRUE(spsc.write(9));
+    spsc.abortWrite();
+    spsc.commitWrite();
+    TEST_ASSERT_EQUAL(4, spsc.size());
+    TEST_ASSERT_EQUAL(fifoSize - 4, spsc.free());
+    for (unsigned i = 0; i < 4; i++)
+        TEST_ASSERT_EQUAL(i == 0 ? 3 : i, spsc.pop());
+}
+
+void test_spsc_peek_span()
+{
+    SPSCFIFO<fifoSize> spsc;
+    spsc_init(spsc);
+    uint8_t in[fifoSize];
+    for (unsigned i = 0; i < fifoSize; i++)
+        in[i] = i;
+    TEST_ASSERT_TRUE(spsc.pushBytes(in, 200));
+
+    // The committed data wraps, so the first span stops at the end of the buffer
+    const uint8_t *span;
+    uint16_t spanLen = spsc.peekSpan(&span);
+    uint16_t const firstLen = fifoSize - (fifoSize / 2 + 7);
+    TEST_ASSERT_EQUAL(firstLen, spanLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, span, spanLen);
+    TEST_ASSERT_EQUAL(200, spsc.size());
+    spsc.commitRead(spanLen);
+
+    spanLen = spsc.peekSpan(&span);
+    TEST_ASSERT_EQUAL(200 - firstLen, spanLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&in[firstLen], span, spanLen);
+    spsc.commitRead(spanLen);
+    TEST_ASSERT_EQUAL(0, spsc.size());
+    TEST_ASSERT_EQUAL(0, spsc.peekSpan(&span));
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -68,6 +162,10 @@ int main(int argc, char **argv)
     RUN_TEST(test_fifo_pop_wrap);
     RUN_TEST(test_fifo_popBytes_wrap);
     RUN_TEST(test_fifo_ensure);
+    RUN_TEST(test_spsc_bytes_wrap);
+    RUN_TEST(test_spsc_full_rejected);
+    RUN_TEST(test_spsc_commit);
+    RUN_TEST(test_spsc_peek_span);
     UNITY_END();
 
     return 0;
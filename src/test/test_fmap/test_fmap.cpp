@@ -35,6 +35,17 @@ void test_fmap_consistent_bider(void)
     }
 }
 
+void test_crsf_map_matches_fmap(void)
+{
+    // Every 11-bit value, including those outside CRSF_CHANNEL_VALUE_MIN..MAX
+    for (uint16_t i = 0; i < 2048; i++)
+    {
+        TEST_ASSERT_EQUAL(fmap(i, CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 988, 2012), CRSF_to_US(i));
+        TEST_ASSERT_EQUAL(fmap(i, CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696), CRSF_map(i, CRSF_MAP_DJI_RS_PRO));
+        TEST_ASSERT_EQUAL(fmap(i, CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 176, 848), CRSF_map(i, CRSF_MAP_DJI_RS_PRO_HALF));
+    }
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -44,6 +55,7 @@ int main(int argc, char **argv)
     UNITY_BEGIN();
     RUN_TEST(test_fmap_consistent_with_float);
     RUN_TEST(test_fmap_consistent_bider);
+    RUN_TEST(test_crsf_map_matches_fmap);
     UNITY_END();
 
     return 0;
@@ -0,0 +1,225 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unity.h>
+#include <ArduinoJson.h>
+
+#include "HardwareBlob.h"
+
+#define HARDWARE_SIZE 2048 // ELRSOPTS_HARDWARE_SIZE
+
+// An ESP8285 RX layout as the configurator writes it
+static const char layoutJson[] = "{\"serial_rx\": 3, \"serial_tx\": 1, \"radio_busy\": 5, \"radio_dio1\": 4, \"radio_miso\": 12, "
+    "\"radio_mosi\": 13, \"radio_nss\": 15, \"radio_rst\": 2, \"radio_sck\": 14, \"radio_dcdc\": true, \"power_min\": 0, "
+    "\"power_high\": 3, \"power_max\": 3, \"power_default\": 2, \"power_control\": 0, \"power_values\": [-18, -15, -12, -9], "
+    "\"power_pdet_intercept\": 2.5, \"power_pdet_slope\": 0.032, \"led_rgb\": 16, \"led_rgb_isgrb\": true, "
+    "\"ledidx_rgb_status\": [0], \"button\": 0, \"vbat\": 17, \"vbat_offset\": -12, \"vbat_scale\": 410, "
+    "\"pwm_outputs\": [0, 1, 2, 3, 9, 10]}";
+
+// python/hardware_blob.py of the layout above, the blob then its trailer
+static const uint8_t layoutBlob[] = {
+    0x01, 0x09, 0x00, 0x00, 0x9A, 0x01, 0x00, 0x00, 0x0D, 0x0E, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0xD3, 0x1E, 0x03, 0x01, 0xD0, 0x00, 0x00, 0x00, 0xBB, 0x28, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0xEE, 0x2F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC3, 0x37, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x2C, 0x49, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x16, 0x58, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x5C, 0x5A, 0x03, 0x04, 0xD2, 0x00, 0x00, 0x00, 0xDD, 0x5A, 0x02, 0x00, 0x6F, 0x12, 0x03, 0x3D,
+    0xF4, 0x67, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x05, 0x69, 0x02, 0x00, 0x00, 0x00, 0x20, 0x40,
+    0xE3, 0x6B, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x6D, 0x7C, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x97, 0x88, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x11, 0x8C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x7D, 0xA0, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0C, 0xAA, 0x03, 0x06, 0xDA, 0x00, 0x00, 0x00,
+    0xBF, 0xAF, 0x00, 0x00, 0x0D, 0x00, 0x00, 0x00, 0x36, 0xB4, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x1B, 0xBE, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x00, 0xCA, 0xC4, 0x00, 0x00, 0xF4, 0xFF, 0xFF, 0xFF,
+    0xFC, 0xCD, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x70, 0xDC, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00,
+    0xBF, 0xDF, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x03, 0xE1, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xEE, 0xFF, 0xF1, 0xFF, 0xF4, 0xFF, 0xF7, 0xFF, 0x00, 0x00, 0x01, 0x00, 0x02, 0x00,
+    0x03, 0x00, 0x09, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x45, 0x4C, 0x48, 0x57, 0x01, 0x1A, 0xE8, 0x00,
+    0x27, 0x24, 0x00, 0x00,
+};
+
+// The hardware area appended to the firmware: JSON, padding, blob, trailer
+static uint8_t hardwareArea[HARDWARE_SIZE];
+static hardware_blob_trailer_t trailer;
+static const uint8_t *blob;
+
+static void buildHardwareArea()
+{
+    memset(hardwareArea, 0, sizeof(hardwareArea));
+    memcpy(hardwareArea, layoutJson, strlen(layoutJson));
+    memcpy(&hardwareArea[HARDWARE_SIZE - sizeof(layoutBlob)], layoutBlob, sizeof(layoutBlob));
+
+    // As hardware_LoadFromBlob() finds it
+    memcpy(&trailer, &hardwareArea[HARDWARE_SIZE - sizeof(trailer)], sizeof(trailer));
+    blob = &hardwareArea[HARDWARE_SIZE - sizeof(trailer) - trailer.size];
+}
+
+void test_key_matches_tool(void)
+{
+    // Values from key() in python/hardware_blob.py
+    TEST_ASSERT_EQUAL_HEX16(0x492C, HardwareBlobKey("serial_rx"));
+    TEST_ASSERT_EQUAL_HEX16(0x5A5C, HardwareBlobKey("power_values"));
+    TEST_ASSERT_EQUAL_HEX16(0xA07D, HardwareBlobKey("radio_dcdc"));
+    TEST_ASSERT_EQUAL_HEX16(0x5ADD, HardwareBlobKey("power_pdet_slope"));
+    TEST_ASSERT_EQUAL_HEX16(0xC4CA, HardwareBlobKey("vbat_offset"));
+}
+
+void test_blob_values(void)
+{
+    buildHardwareArea();
+    TEST_ASSERT_TRUE(HardwareBlobTrailerValid(trailer, HARDWARE_SIZE - sizeof(trailer)));
+    TEST_ASSERT_TRUE(HardwareBlobValid(blob, trailer));
+    TEST_ASSERT_EQUAL(26, trailer.count);
+
+    const hardware_blob_entry_t *entry = HardwareBlobFind(blob, trailer, HardwareBlobKey("serial_rx"));
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(3, HardwareBlobInt(entry));
+    TEST_ASSERT_EQUAL(-12, HardwareBlobInt(HardwareBlobFind(blob, trailer, HardwareBlobKey("vbat_offset"))));
+    TEST_ASSERT_EQUAL(1, HardwareBlobInt(HardwareBlobFind(blob, trailer, HardwareBlobKey("radio_dcdc"))));
+    // Floats are stored as float, so come back exactly as the literal
+    TEST_ASSERT_TRUE(0.032f == HardwareBlobFloat(HardwareBlobFind(blob, trailer, HardwareBlobKey("power_pdet_slope"))));
+    TEST_ASSERT_TRUE(410.0f == HardwareBlobFloat(HardwareBlobFind(blob, trailer, HardwareBlobKey("vbat_scale"))));
+    TEST_ASSERT_EQUAL(2, HardwareBlobInt(HardwareBlobFind(blob, trailer, HardwareBlobKey("power_pdet_intercept"))));
+
+    entry = HardwareBlobFind(blob, trailer, HardwareBlobKey("power_values"));
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(HARDWARE_BLOB_ARRAY, entry->type);
+    const int16_t expected[] = {-18, -15, -12, -9};
+    TEST_ASSERT_EQUAL(4, entry->count);
+    for (unsigned i = 0; i < 4; i++)
+        TEST_ASSERT_EQUAL(expected[i], HardwareBlobArray(blob, entry)[i]);
+
+    TEST_ASSERT_NULL(HardwareBlobFind(blob, trailer, HardwareBlobKey("radio_nss_2")));
+    TEST_ASSERT_NULL(HardwareBlobFind(blob, trailer, 0));
+    TEST_ASSERT_NULL(HardwareBlobFind(blob, trailer, 0xFFFF));
+}
+
+void test_blob_rejects_corruption(void)
+{
+    buildHardwareArea();
+    uint8_t copy[sizeof(layoutBlob)];
+    for (unsigned pos = 0; pos < trailer.size; pos++)
+    {
+        for (unsigned bit = 0; bit < 8; bit++)
+        {
+            memcpy(copy, blob, trailer.size);
+            copy[pos] ^= 1 << bit;
+            TEST_ASSERT_FALSE(HardwareBlobValid(copy, trailer));
+        }
+    }
+
+    // Firmware without a blob has the JSON's padding there, and a later layout version is left to the JSON
+    hardware_blob_trailer_t bad = trailer;
+    memset(&bad, 0, sizeof(bad));
+    TEST_ASSERT_FALSE(HardwareBlobTrailerValid(bad, HARDWARE_SIZE - sizeof(bad)));
+    bad = trailer;
+    bad.version++;
+    TEST_ASSERT_FALSE(HardwareBlobTrailerValid(bad, HARDWARE_SIZE - sizeof(bad)));
+    bad = trailer;
+    bad.size = HARDWARE_SIZE;
+    TEST_ASSERT_FALSE(HardwareBlobTrailerValid(bad, HARDWARE_SIZE - sizeof(bad)));
+}
+
+// Every field hardware_init() looks for, about 120 of them, most not in any one layout
+static const char *fieldNames[120];
+static char unusedNames[120][24];
+
+static unsigned fillFieldNames()
+{
+    static const char *used[] = {"serial_rx", "serial_tx", "radio_busy", "radio_dio1", "radio_miso", "radio_mosi",
+        "radio_nss", "radio_rst", "radio_sck", "radio_dcdc", "power_min", "power_high", "power_max", "power_default",
+        "power_control", "power_values", "power_pdet_intercept", "power_pdet_slope", "led_rgb", "led_rgb_isgrb",
+        "ledidx_rgb_status", "button", "vbat", "vbat_offset", "vbat_scale", "pwm_outputs"};
+    const unsigned numUsed = sizeof(used) / sizeof(used[0]);
+    for (unsigned i = 0; i < 120; i++)
+    {
+        if (i < numUsed)
+        {
+            fieldNames[i] = used[i];
+        }
+        else
+        {
+            snprintf(unusedNames[i], sizeof(unusedNames[i]), "unused_field_%u", i);
+            fieldNames[i] = unusedNames[i];
+        }
+    }
+    return 120;
+}
+
+void test_boot_parse_time(void)
+{
+    buildHardwareArea();
+    const unsigned numFields = fillFieldNames();
+    uint16_t keys[120];
+    for (unsigned i = 0; i < numFields; i++)
+        keys[i] = HardwareBlobKey(fieldNames[i]); // the firmware has these at compile time
+
+    const unsigned iterations = 20000;
+    volatile int32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned n = 0; n < iterations; n++)
+    {
+        hardware_blob_trailer_t t;
+        memcpy(&t, &hardwareArea[HARDWARE_SIZE - sizeof(t)], sizeof(t));
+        const uint8_t *b = &hardwareArea[HARDWARE_SIZE - sizeof(t) - t.size];
+        TEST_ASSERT_TRUE(HardwareBlobTrailerValid(t, HARDWARE_SIZE - sizeof(t)) && HardwareBlobValid(b, t));
+        for (unsigned i = 0; i < numFields; i++)
+        {
+            const hardware_blob_entry_t *entry = HardwareBlobFind(b, t, keys[i]);
+            if (entry)
+                sink += entry->type == HARDWARE_BLOB_ARRAY ? HardwareBlobArray(b, entry)[0] : HardwareBlobInt(entry);
+        }
+    }
+    const double blobUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    // What hardware_init() did before: parse, keep the text, look up every field, copy the arrays to the heap
+    start = std::chrono::steady_clock::now();
+    for (unsigned n = 0; n < iterations; n++)
+    {
+        JsonDocument doc;
+        TEST_ASSERT_FALSE(deserializeJson(doc, (const char *)hardwareArea));
+        std::string text;
+        serializeJson(doc, text);
+        for (unsigned i = 0; i < numFields; i++)
+        {
+            if (doc.containsKey(fieldNames[i]))
+            {
+                if (doc[fieldNames[i]].is<JsonArray>())
+                {
+                    JsonArray array = doc[fieldNames[i]].as<JsonArray>();
+                    int16_t *values = new int16_t[array.size()];
+                    copyArray(doc[fieldNames[i]], values, array.size());
+                    sink += array.size() ? values[0] : 0;
+                    delete[] values;
+                }
+                else
+                {
+                    sink += doc[fieldNames[i]].as<int>();
+                }
+            }
+        }
+    }
+    const double jsonUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u fields from a %u byte layout: JSON %.1f us, binary %.1f us (%u bytes)",
+        numFields, (unsigned)strlen(layoutJson), jsonUs, blobUs, (unsigned)sizeof(layoutBlob));
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(blobUs < jsonUs, msg);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_key_matches_tool);
+    RUN_TEST(test_blob_values);
+    RUN_TEST(test_blob_rejects_corruption);
+    RUN_TEST(test_boot_parse_time);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,991 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Closed-loop TX/RX link simulator, see linksim.h
+ *
+ * The tx/rx functions below model tx_main.cpp / rx_main.cpp and must be kept in step with them
+ */
+
+#include "linksim.h"
+
+#include <queue>
+#include <vector>
+#include <cstring>
+
+#include "SX1280_Regs.h"
+#include "OTA.h"
+#include "FHSS.h"
+#include "PFD.h"
+#include "LQCALC.h"
+#include "LowPassFilter.h"
+#include "WarmStart.h"
+
+#define PACKET_TO_TOCK_SLACK 200 // Desired buffer time between Packet ISR and Tock ISR (rx_main.cpp)
+#define LOOP_INTERVAL_US 1000    // How often the RX loop() connection state machine runs
+#define RF_MODE_CYCLE_MULTIPLIER_SLOW 10
+#define WARM_START_SAVE_INTERVAL 1000
+
+#ifndef RADIO_SNR_SCALE
+#define RADIO_SNR_SCALE 4        // SX1280.h, the driver itself is not part of the native build
+#endif
+
+// The RS rate is left out, the native build does not have USE_OTA8_RS
+expresslrs_mod_settings_s LinkSimAirRateConfig[LINKSIM_RATE_COUNT] = {SX128X_AIR_RATE_CONFIG};
+expresslrs_rf_pref_params_s LinkSimAirRateRFperf[LINKSIM_RATE_COUNT] = {SX128X_AIR_RATE_RFPERF};
+
+namespace {
+
+// uidMacSeedGet(), common.cpp is not part of the native build
+uint32_t uidSeed()
+{
+    return ((uint32_t)UID[2] << 24) + ((uint32_t)UID[3] << 16) + ((uint32_t)UID[4] << 8) + (UID[5] ^ OTA_VERSION_ID);
+}
+
+typedef enum
+{
+    evTxTimer,  // TX hwTimer tock
+    evTxDone,   // TX radio finished sending
+    evTxRxDone, // TX radio received a (telemetry) packet
+    evRxTimer,  // RX hwTimer tick or tock
+    evRxRxDone, // RX radio received a packet
+    evRxLoop,   // RX main loop()
+    evRxReset,  // RX resets
+    evRxBoot,   // RX setup() after a reset
+} simEventType_e;
+
+typedef struct {
+    uint64_t time;          // true time, us
+    uint32_t seq;           // insertion order, keeps simultaneous events FIFO
+    simEventType_e type;
+    uint32_t timerGen;      // for evRxTimer, dropped if the timer was stopped/restarted since
+    uint32_t freq;          // frequency the packet was sent on
+    uint64_t sampleTime;    // when the channels carried by the packet were sampled
+    OTA_Packet_s pkt;
+} simEvent_t;
+
+struct simEventLater
+{
+    bool operator()(const simEvent_t &a, const simEvent_t &b) const
+    {
+        return (a.time > b.time) || (a.time == b.time && a.seq > b.seq);
+    }
+};
+
+/**
+ * A crystal running ppm parts per million fast, converts between true time
+ * and the local micros()/millis() seen by the firmware
+ */
+struct simClock_t
+{
+    int32_t ppm;
+
+    int64_t local(uint64_t t) const { return (int64_t)t + (int64_t)t * ppm / 1000000; }
+    uint32_t micros(uint64_t t) const { return (uint32_t)local(t); }
+    uint32_t millis(uint64_t t) const { return (uint32_t)(local(t) / 1000); }
+    uint64_t toTrue(int64_t localUs) const { return (uint64_t)(localUs * 1000000 / (1000000 + ppm)); }
+};
+
+// Per-end copy of the global OTA/FHSS state
+struct simOtaContext_t
+{
+    uint8_t nonce;
+    uint8_t fhssPtr;
+
+    void enter() const { OtaNonce = nonce; FHSSptr = fhssPtr; }
+    void leave() { nonce = OtaNonce; fhssPtr = FHSSptr; }
+};
+
+class LinkSim
+{
+public:
+    LinkSim(uint8_t rateIndex, const linksim_channel_t &chan, const linksim_reset_t *reset);
+    void run(uint32_t durationMs, linksim_result_t *result);
+
+private:
+    const expresslrs_mod_settings_s *ModParams;
+    const expresslrs_rf_pref_params_s *RFperf;
+    const uint8_t rateIndex;
+    const linksim_channel_t chan;
+    const linksim_reset_t *reset;
+
+    std::priority_queue<simEvent_t, std::vector<simEvent_t>, simEventLater> events;
+    uint32_t eventSeq = 0;
+    uint32_t rngState;
+    bool inFade = false;
+
+    // TX state
+    struct {
+        simClock_t clock;
+        simOtaContext_t ota;
+        int64_t alarmLocal;
+        uint32_t freq;
+        TxTlmRcvPhase_e TelemetryRcvPhase;
+        bool busyTransmitting;
+        uint8_t syncSlot;
+        uint32_t SyncPacketLastSent;
+        uint32_t LastTLMpacketRecvMillis;
+        bool connected;
+        uint64_t handsetSampleTime;
+        LQCALC<25> LQCalc;
+    } tx;
+
+    // RX state
+    struct {
+        simClock_t clock;
+        simOtaContext_t ota;
+        uint32_t freq;
+        bool down;
+        uint8_t rateIndex;  // the rate the radio is set to, only packets sent on the same rate are received
+        connectionState_e connectionState;
+        RXtimerState_e RXtimerState;
+        // virtual hwTimer
+        bool running;
+        bool isTick;
+        int32_t FreqOffset;
+        int32_t PhaseShift;
+        int64_t alarmLocal;
+        uint32_t timerGen;
+        // rx_main state
+        PFD PFDloop;
+        LPF LPF_Offset{2};
+        LPF LPF_OffsetDx{4};
+        LQCALC<100> LQCalc;
+        LQCALC<100> LQCalcDVDA;
+        int32_t PfdPrevRawOffset;
+        bool alreadyFHSS;
+        bool alreadyTLMresp;
+        bool didFHSS;
+        bool doStartTimer;
+        uint32_t LastValidPacket;
+        uint32_t LastSyncPacket;
+        uint32_t GotConnectionMillis;
+        uint32_t RFmodeLastCycled;
+        uint8_t RFmodeCycleMultiplier;
+        uint8_t scanIndex;
+        bool LockRFmode;
+        bool warmStart;
+        uint32_t warmStartLastSaved;
+        uint8_t tlmDenom;
+        uint8_t uplinkLQ;
+        uint64_t dvdaSampleTime;
+        uint32_t ChannelData[CRSF_NUM_CHANNELS];
+    } rx;
+
+    // Metrics
+    uint64_t connectTime;
+    uint64_t lockTime;
+    uint32_t lostConnections;
+    int64_t offsetSum;
+    int64_t offsetSqSum;
+    uint32_t offsetCount;
+    uint64_t lqSum;
+    uint32_t lqCount;
+    uint32_t tlmSlots;
+    uint32_t tlmReceived;
+    uint32_t rcFrames;
+    uint64_t latencySum;
+    uint32_t latencyMax;
+    uint64_t resetTime;
+    uint64_t resumeTime;
+
+    uint32_t rng();
+    uint32_t isrDelay() { return chan.jitterUs ? rng() % (chan.jitterUs + 1) : 0; }
+    bool locked() const { return rx.RXtimerState == tim_locked; }
+    void schedule(uint64_t time, simEventType_e type, uint32_t timerGen = 0);
+    void transmit(uint64_t time, OTA_Packet_s const * const otaPkt, uint32_t freq, simEventType_e rxEvent, uint64_t sampleTime);
+
+    // TX, following tx_main.cpp
+    void txTimerCallback(uint64_t t);
+    void txSendRCdataToRF(uint64_t t);
+    void txGenerateSyncPacketData(uint64_t t, OTA_Sync_s * const syncPtr);
+    void txTXdoneISR(uint64_t t);
+    void txRXdoneISR(uint64_t t, simEvent_t &ev);
+
+    // RX, following rx_main.cpp
+    void rxTimerResume(uint64_t t);
+    void rxTimerStop();
+    void rxTimerCallback(uint64_t t, uint32_t gen);
+    void rxPhaseShift(int32_t newPhaseShift);
+    void rxHWtimerCallbackTick(uint64_t t);
+    void rxHWtimerCallbackTock(uint64_t t);
+    void rxUpdatePhaseLock();
+    bool rxHandleFHSS();
+    void rxHandleSendTelemetryResponse(uint64_t t);
+    void rxRXdoneISR(uint64_t t, simEvent_t &ev);
+    bool rxProcessRFPacket(uint64_t t, simEvent_t &ev);
+    bool rxProcessRfPacket_SYNC(uint32_t now, OTA_Sync_s const * const otaSync);
+    void rxRcFrameAvailable(uint64_t t, uint64_t sampleTime);
+    void rxTentativeConnection(uint32_t now);
+    void rxGotConnection(uint64_t t, uint32_t now);
+    void rxLostConnection();
+    uint8_t rxMinLqForChaos() const;
+    void rxCycleRfMode(uint32_t now);
+    void rxUpdateWarmStart(uint32_t now);
+    void rxInit();
+    void rxBoot(uint64_t t);
+    void rxLoop(uint64_t t);
+};
+
+LinkSim::LinkSim(uint8_t rateIndex, const linksim_channel_t &chan, const linksim_reset_t *reset)
+    : ModParams(&LinkSimAirRateConfig[rateIndex]), RFperf(&LinkSimAirRateRFperf[rateIndex]),
+      rateIndex(rateIndex), chan(chan), reset(reset), rngState(chan.seed ? chan.seed : 1)
+{
+    memset(&tx.ota, 0, sizeof(tx.ota));
+    tx.clock.ppm = chan.txPpm;
+    tx.TelemetryRcvPhase = ttrpTransmitting;
+    tx.busyTransmitting = false;
+    tx.syncSlot = 0;
+    tx.SyncPacketLastSent = 0;
+    tx.LastTLMpacketRecvMillis = 0;
+    tx.connected = false;
+    tx.handsetSampleTime = 0;
+
+    rx.clock.ppm = chan.rxPpm;
+    rx.timerGen = 0;
+    rxInit();
+    rx.rateIndex = rateIndex;
+    rx.scanIndex = rateIndex;
+    rx.RFmodeCycleMultiplier = RF_MODE_CYCLE_MULTIPLIER_SLOW / 2;
+
+    connectTime = 0;
+    lockTime = 0;
+    lostConnections = 0;
+    offsetSum = 0;
+    offsetSqSum = 0;
+    offsetCount = 0;
+    lqSum = 0;
+    lqCount = 0;
+    tlmSlots = 0;
+    tlmReceived = 0;
+    rcFrames = 0;
+    latencySum = 0;
+    latencyMax = 0;
+    resetTime = 0;
+    resumeTime = 0;
+}
+
+// The RX state as setup() leaves it, other than the rate
+void LinkSim::rxInit()
+{
+    memset(&rx.ota, 0, sizeof(rx.ota));
+    rx.down = false;
+    rx.connectionState = disconnected;
+    rx.RXtimerState = tim_disconnected;
+    rx.running = false;
+    rx.isTick = false;
+    rx.FreqOffset = 0;
+    rx.PhaseShift = 0;
+    rx.alarmLocal = 0;
+    rx.PfdPrevRawOffset = 0;
+    rx.alreadyFHSS = false;
+    rx.alreadyTLMresp = false;
+    rx.didFHSS = false;
+    rx.doStartTimer = false;
+    rx.LastValidPacket = 0;
+    rx.LastSyncPacket = 0;
+    rx.GotConnectionMillis = 0;
+    rx.RFmodeLastCycled = 0;
+    rx.LockRFmode = false;
+    rx.warmStart = false;
+    rx.warmStartLastSaved = 0;
+    rx.tlmDenom = 1;
+    rx.uplinkLQ = 0;
+    rx.dvdaSampleTime = 0;
+    // As constructed, setup() does not reset these
+    rx.PFDloop = PFD();
+    rx.LQCalc = LQCALC<100>();
+    rx.LQCalcDVDA = LQCALC<100>();
+    rx.LPF_Offset = LPF(2);
+    rx.LPF_OffsetDx = LPF(4);
+    memset(rx.ChannelData, 0, sizeof(rx.ChannelData));
+    rx.freq = FHSSgetInitialFreq();
+}
+
+uint32_t LinkSim::rng()
+{
+    // xorshift32, independent of the libc random() the firmware code may use
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+void LinkSim::schedule(uint64_t time, simEventType_e type, uint32_t timerGen)
+{
+    simEvent_t ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.time = time;
+    ev.seq = eventSeq++;
+    ev.type = type;
+    ev.timerGen = timerGen;
+    events.push(ev);
+}
+
+void LinkSim::transmit(uint64_t time, OTA_Packet_s const * const otaPkt, uint32_t freq, simEventType_e rxEvent, uint64_t sampleTime)
+{
+    // Gilbert-Elliott burst fading, then independent loss
+    const float r = (float)(rng() % 1000000) / 1000000.0f;
+    if (inFade)
+        inFade = r >= chan.fadeExitRate;
+    else
+        inFade = r < chan.fadeEnterRate;
+    if (inFade)
+        return;
+    if ((float)(rng() % 1000000) / 1000000.0f < chan.lossRate)
+        return;
+
+    simEvent_t ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.time = time + RFperf->TOA + isrDelay();
+    ev.seq = eventSeq++;
+    ev.type = rxEvent;
+    ev.freq = freq;
+    ev.sampleTime = sampleTime;
+    ev.pkt = *otaPkt;
+    events.push(ev);
+}
+
+/***
+ * TX
+ ***/
+
+void LinkSim::txGenerateSyncPacketData(uint64_t t, OTA_Sync_s * const syncPtr)
+{
+    tx.SyncPacketLastSent = tx.clock.millis(t);
+
+    syncPtr->fhssIndex = FHSSgetCurrIndex();
+    syncPtr->nonce = OtaNonce;
+    syncPtr->rateIndex = rateIndex;
+    syncPtr->newTlmRatio = ModParams->TLMinterval - TLM_RATIO_NO_TLM;
+    syncPtr->switchEncMode = OtaSwitchModeCurrent;
+    syncPtr->UID3 = UID[3];
+    syncPtr->UID4 = UID[4];
+    syncPtr->UID5 = UID[5];
+}
+
+void LinkSim::txSendRCdataToRF(uint64_t t)
+{
+    tx.busyTransmitting = true;
+
+    uint32_t const now = tx.clock.millis(t);
+    WORD_ALIGNED_ATTR OTA_Packet_s otaPkt = {0};
+
+    uint32_t SyncInterval = tx.connected ? RFperf->SyncPktIntervalConnected : RFperf->SyncPktIntervalDisconnected;
+    uint8_t NonceFHSSresult = OtaNonce % ModParams->FHSShopInterval;
+
+    if (((tx.syncSlot / 2) <= NonceFHSSresult) && (now - tx.SyncPacketLastSent > SyncInterval) && FHSSonSyncChannel())
+    {
+        otaPkt.std.type = PACKET_TYPE_SYNC;
+        txGenerateSyncPacketData(t, OtaIsFullRes ? &otaPkt.full.sync.sync : &otaPkt.std.sync);
+        tx.syncSlot = (tx.syncSlot + 1) % (ModParams->FHSShopInterval * 2);
+    }
+    else
+    {
+        OtaPackChannelData(&otaPkt, ChannelData, false, ModParams->TLMinterval ? TLMratioEnumToValue(ModParams->TLMinterval) : 1);
+    }
+
+    OtaGeneratePacketCrc(&otaPkt);
+    transmit(t, &otaPkt, tx.freq, evRxRxDone, tx.handsetSampleTime);
+    schedule(t + RFperf->TOA, evTxDone);
+}
+
+void LinkSim::txTimerCallback(uint64_t t)
+{
+    tx.alarmLocal += ModParams->interval;
+    schedule(tx.clock.toTrue(tx.alarmLocal), evTxTimer);
+
+    const uint64_t tIsr = t + isrDelay();
+    tx.ota.enter();
+
+    // handset->JustSentRFpacket() syncs the handset to this point, so new channels are sampled here
+    if (!(OtaNonce % ModParams->numOfSends))
+    {
+        tx.handsetSampleTime = tIsr;
+        // Move the sticks so each new frame carries different data
+        for (unsigned ch = 0; ch < 4; ++ch)
+            ChannelData[ch] = CRSF_CHANNEL_VALUE_MIN + ((tIsr / 1000 + ch * 256) % (CRSF_CHANNEL_VALUE_MAX - CRSF_CHANNEL_VALUE_MIN));
+    }
+
+    OtaNonce++;
+
+    if (tx.TelemetryRcvPhase == ttrpPreReceiveGap)
+    {
+        tx.TelemetryRcvPhase = ttrpExpectingTelem;
+        if (locked())
+            ++tlmSlots;
+        tx.LQCalc.inc();
+        tx.ota.leave();
+        return;
+    }
+
+    // UpdateConnectDisconnectStatus() with RX_LOSS_CNT = 5
+    uint8_t const tlmDenom = TLMratioEnumToValue(ModParams->TLMinterval);
+    uint32_t const msConnectionLostTimeout = std::max((uint32_t)512U,
+        (uint32_t)tlmDenom * ModParams->interval / (1000U / 5)) + 2U;
+    tx.connected = tx.LastTLMpacketRecvMillis && (tx.clock.millis(tIsr) - tx.LastTLMpacketRecvMillis <= msConnectionLostTimeout);
+
+    tx.TelemetryRcvPhase = ttrpTransmitting;
+    txSendRCdataToRF(tIsr);
+    tx.ota.leave();
+}
+
+void LinkSim::txTXdoneISR(uint64_t t)
+{
+    (void)t;
+    if (!tx.busyTransmitting)
+        return;
+
+    tx.ota.enter();
+    // HandleFHSS()
+    if ((OtaNonce + 1) % ModParams->FHSShopInterval == 0)
+        tx.freq = FHSSgetNextFreq();
+    // HandlePrepareForTLM()
+    uint8_t const tlmDenom = TLMratioEnumToValue(ModParams->TLMinterval);
+    if (tlmDenom != 1 && ((OtaNonce + 1) % tlmDenom) == 0)
+        tx.TelemetryRcvPhase = ttrpPreReceiveGap;
+    tx.ota.leave();
+
+    tx.busyTransmitting = false;
+}
+
+void LinkSim::txRXdoneISR(uint64_t t, simEvent_t &ev)
+{
+    // Radio is only in receive mode while waiting for telemetry, and must be on the right channel
+    if (tx.TelemetryRcvPhase == ttrpTransmitting || ev.freq != tx.freq || tx.LQCalc.currentIsSet())
+        return;
+
+    tx.ota.enter();
+    bool const valid = OtaValidatePacketCrc(&ev.pkt) && ev.pkt.std.type == PACKET_TYPE_TLM;
+    tx.ota.leave();
+    if (!valid)
+        return;
+
+    tx.LQCalc.add();
+    tx.LastTLMpacketRecvMillis = tx.clock.millis(t);
+    if (locked())
+        ++tlmReceived;
+}
+
+/***
+ * RX
+ ***/
+
+void LinkSim::rxTimerResume(uint64_t t)
+{
+    if (rx.running)
+        return;
+    // Tock fires immediately after resume()
+    rx.running = true;
+    rx.isTick = false;
+    rx.alarmLocal = rx.clock.local(t);
+    schedule(t, evRxTimer, ++rx.timerGen);
+}
+
+void LinkSim::rxTimerStop()
+{
+    rx.running = false;
+    ++rx.timerGen;
+}
+
+void LinkSim::rxPhaseShift(int32_t newPhaseShift)
+{
+    int32_t const maxVal = ModParams->interval >> 2;
+    rx.PhaseShift = constrain(newPhaseShift, -maxVal, maxVal);
+}
+
+void LinkSim::rxTimerCallback(uint64_t t, uint32_t gen)
+{
+    if (!rx.running || gen != rx.timerGen)
+        return;
+
+    // Same sequencing as the hwTimer::callback(), the next alarm is written before the callback runs
+    int32_t NextInterval = (ModParams->interval >> 1) + rx.FreqOffset;
+    const uint64_t tIsr = t + isrDelay();
+    if (rx.isTick)
+    {
+        rx.alarmLocal += NextInterval;
+        schedule(rx.clock.toTrue(rx.alarmLocal), evRxTimer, rx.timerGen);
+        rx.isTick = !rx.isTick;
+        rxHWtimerCallbackTick(tIsr);
+    }
+    else
+    {
+        NextInterval += rx.PhaseShift;
+        rx.PhaseShift = 0;
+        rx.alarmLocal += NextInterval;
+        schedule(rx.clock.toTrue(rx.alarmLocal), evRxTimer, rx.timerGen);
+        rx.isTick = !rx.isTick;
+        rxHWtimerCallbackTock(tIsr);
+    }
+}
+
+void LinkSim::rxUpdatePhaseLock()
+{
+    if (rx.connectionState != disconnected && rx.PFDloop.hasResult())
+    {
+        int32_t RawOffset = rx.PFDloop.calcResult();
+        int32_t Offset = rx.LPF_Offset.update(RawOffset);
+        rx.LPF_OffsetDx.update(RawOffset - rx.PfdPrevRawOffset);
+        rx.PfdPrevRawOffset = RawOffset;
+
+        if (rx.RXtimerState == tim_locked)
+        {
+            if (OtaNonce % 8 == 1)
+            {
+                if (Offset > 0)
+                    rx.FreqOffset++;
+                else if (Offset < 0)
+                    rx.FreqOffset--;
+            }
+
+            offsetSum += RawOffset;
+            offsetSqSum += (int64_t)RawOffset * RawOffset;
+            ++offsetCount;
+        }
+
+        if (rx.connectionState != connected)
+            rxPhaseShift(RawOffset >> 1);
+        else
+            rxPhaseShift(Offset >> 2);
+    }
+
+    rx.PFDloop.reset();
+}
+
+bool LinkSim::rxHandleFHSS()
+{
+    uint8_t modresultFHSS = (OtaNonce + 1) % ModParams->FHSShopInterval;
+
+    if ((ModParams->FHSShopInterval == 0) || rx.alreadyFHSS || (modresultFHSS != 0) || (rx.connectionState == disconnected))
+        return false;
+
+    rx.alreadyFHSS = true;
+    rx.freq = FHSSgetNextFreq();
+    return true;
+}
+
+void LinkSim::rxHWtimerCallbackTick(uint64_t t)
+{
+    (void)t;
+    rx.ota.enter();
+    rxUpdatePhaseLock();
+    OtaNonce++;
+
+    if (ModParams->numOfSends == 1)
+    {
+        rx.uplinkLQ = rx.LQCalc.getLQ();
+    }
+    else if (!((OtaNonce - 1) % ModParams->numOfSends))
+    {
+        rx.uplinkLQ = rx.LQCalcDVDA.getLQ();
+        rx.LQCalcDVDA.inc();
+    }
+
+    if (!rx.alreadyTLMresp)
+        rx.LQCalc.inc();
+
+    rx.alreadyTLMresp = false;
+    rx.alreadyFHSS = false;
+    rx.ota.leave();
+}
+
+void LinkSim::rxHWtimerCallbackTock(uint64_t t)
+{
+    rx.ota.enter();
+    rx.PFDloop.intEvent(rx.clock.micros(t));
+
+    if (ModParams->numOfSends > 1 && !(OtaNonce % ModParams->numOfSends))
+    {
+        if (rx.LQCalcDVDA.currentIsSet())
+            rxRcFrameAvailable(t, rx.dvdaSampleTime);
+    }
+
+    if (!rx.didFHSS)
+        rxHandleFHSS();
+    rx.didFHSS = false;
+
+    rxHandleSendTelemetryResponse(t);
+    rx.ota.leave();
+}
+
+void LinkSim::rxHandleSendTelemetryResponse(uint64_t t)
+{
+    uint8_t modresult = (OtaNonce + 1) % rx.tlmDenom;
+
+    if ((rx.connectionState == disconnected) || (rx.tlmDenom == 1) || rx.alreadyTLMresp || (modresult != 0))
+        return;
+
+    WORD_ALIGNED_ATTR OTA_Packet_s otaPkt = {0};
+    rx.alreadyTLMresp = true;
+    otaPkt.std.type = PACKET_TYPE_TLM;
+
+    OTA_LinkStats_s *ls;
+    if (OtaIsFullRes)
+    {
+        otaPkt.full.tlm_dl.containsLinkStats = 1;
+        ls = &otaPkt.full.tlm_dl.ul_link_stats.stats;
+    }
+    else
+    {
+        otaPkt.std.tlm_dl.type = ELRS_TELEMETRY_TYPE_LINK;
+        ls = &otaPkt.std.tlm_dl.ul_link_stats.stats;
+    }
+    ls->lq = rx.uplinkLQ;
+
+    OtaGeneratePacketCrc(&otaPkt);
+    transmit(t, &otaPkt, rx.freq, evTxRxDone, 0);
+}
+
+void LinkSim::rxRcFrameAvailable(uint64_t t, uint64_t sampleTime)
+{
+    if (resetTime && !resumeTime)
+        resumeTime = t;
+    if (!locked())
+        return;
+
+    uint32_t latency = (uint32_t)(t - sampleTime);
+    ++rcFrames;
+    latencySum += latency;
+    latencyMax = std::max(latencyMax, latency);
+}
+
+void LinkSim::rxTentativeConnection(uint32_t now)
+{
+    (void)now;
+    rx.PFDloop.reset();
+    rx.connectionState = tentative;
+    rx.RXtimerState = tim_disconnected;
+    rx.PfdPrevRawOffset = 0;
+    rx.LPF_Offset.init(0);
+    rx.RFmodeLastCycled = now;
+}
+
+void LinkSim::rxGotConnection(uint64_t t, uint32_t now)
+{
+    rx.LockRFmode = true; // lock_on_first_connection
+    rx.warmStart = false;
+    rx.warmStartLastSaved = now - WARM_START_SAVE_INTERVAL;
+    rx.connectionState = connected;
+    rx.RXtimerState = tim_tentative;
+    rx.GotConnectionMillis = now;
+    if (connectTime == 0)
+        connectTime = t;
+}
+
+void LinkSim::rxLostConnection()
+{
+    if (rx.connectionState == connected)
+        ++lostConnections;
+
+    rx.warmStart = false;
+    WarmStartClear();
+    rx.RFmodeCycleMultiplier = 1;
+    rx.connectionState = disconnected;
+    rx.RXtimerState = tim_disconnected;
+    rx.FreqOffset = 0;
+    rx.PfdPrevRawOffset = 0;
+    rx.GotConnectionMillis = 0;
+    rx.uplinkLQ = 0;
+    rx.LQCalc.reset();
+    rx.LQCalcDVDA.reset();
+    rx.LPF_Offset.init(0);
+    rx.LPF_OffsetDx.init(0);
+    rx.alreadyTLMresp = false;
+    rx.alreadyFHSS = false;
+
+    rxTimerStop();
+    // SetRFLinkRate() returns the radio to the sync channel
+    rx.freq = FHSSgetInitialFreq();
+}
+
+bool LinkSim::rxProcessRfPacket_SYNC(uint32_t now, OTA_Sync_s const * const otaSync)
+{
+    if (otaSync->UID3 != UID[3] || otaSync->UID4 != UID[4] || otaSync->UID5 != UID[5])
+        return false;
+
+    rx.LastSyncPacket = now;
+
+    expresslrs_tlm_ratio_e TLMrateIn = (expresslrs_tlm_ratio_e)(otaSync->newTlmRatio + (uint8_t)TLM_RATIO_NO_TLM);
+    rx.tlmDenom = TLMratioEnumToValue(TLMrateIn);
+
+    if (rx.connectionState == disconnected
+        || OtaNonce != otaSync->nonce
+        || FHSSgetCurrIndex() != otaSync->fhssIndex)
+    {
+        FHSSsetCurrIndex(otaSync->fhssIndex);
+        OtaNonce = otaSync->nonce;
+        rxTentativeConnection(now);
+        return true;
+    }
+
+    return false;
+}
+
+bool LinkSim::rxProcessRFPacket(uint64_t t, simEvent_t &ev)
+{
+    uint32_t const beginProcessing = rx.clock.micros(t);
+
+    OTA_Packet_s * const otaPktPtr = &ev.pkt;
+    if (!OtaValidatePacketCrc(otaPktPtr))
+        return false;
+
+    rx.PFDloop.extEvent(beginProcessing + PACKET_TO_TOCK_SLACK);
+
+    rx.doStartTimer = false;
+    uint32_t const now = rx.clock.millis(t);
+    rx.LastValidPacket = now;
+
+    switch (otaPktPtr->std.type)
+    {
+    case PACKET_TYPE_RCDATA:
+        if (rx.connectionState == connected)
+        {
+            OtaUnpackChannelData(otaPktPtr, rx.ChannelData, rx.tlmDenom);
+            if (ModParams->numOfSends == 1)
+            {
+                rxRcFrameAvailable(t, ev.sampleTime);
+            }
+            else if (!rx.LQCalcDVDA.currentIsSet())
+            {
+                rx.LQCalcDVDA.add();
+                rx.dvdaSampleTime = ev.sampleTime;
+            }
+        }
+        break;
+    case PACKET_TYPE_SYNC:
+        rx.doStartTimer = rxProcessRfPacket_SYNC(now,
+            OtaIsFullRes ? &otaPktPtr->full.sync.sync : &otaPktPtr->std.sync);
+        break;
+    default:
+        break;
+    }
+
+    rx.LQCalc.add();
+    return true;
+}
+
+void LinkSim::rxRXdoneISR(uint64_t t, simEvent_t &ev)
+{
+    // Radio is off, or tuned to a different channel or rate, nothing is received
+    if (rx.down || ev.freq != rx.freq || rx.rateIndex != rateIndex)
+        return;
+
+    if (rx.LQCalc.currentIsSet() && rx.connectionState == connected)
+        return;
+
+    rx.ota.enter();
+    if (rxProcessRFPacket(t, ev))
+    {
+        rx.didFHSS = rxHandleFHSS();
+
+        if (rx.doStartTimer)
+        {
+            rx.doStartTimer = false;
+            rxTimerResume(t);
+        }
+    }
+    rx.ota.leave();
+}
+
+uint8_t LinkSim::rxMinLqForChaos() const
+{
+    const uint32_t numfhss = FHSSgetChannelCount();
+    const uint8_t interval = ModParams->FHSShopInterval;
+    return interval * ((interval * numfhss + 99) / (interval * numfhss));
+}
+
+void LinkSim::rxCycleRfMode(uint32_t now)
+{
+    if (rx.connectionState == connected || rx.LockRFmode)
+        return;
+
+    const expresslrs_mod_settings_s *const scanParams = &LinkSimAirRateConfig[rx.rateIndex];
+    uint32_t const cycleInterval = ((uint32_t)11U * FHSSgetChannelCount() * scanParams->FHSShopInterval * scanParams->interval) / (10U * 1000U);
+    if (now - rx.RFmodeLastCycled > cycleInterval * rx.RFmodeCycleMultiplier)
+    {
+        rx.RFmodeLastCycled = now;
+        rx.LastSyncPacket = now;
+        rx.rateIndex = rx.scanIndex % LINKSIM_RATE_COUNT;
+        rx.freq = FHSSgetInitialFreq();
+        rx.LQCalc.reset100();
+        rx.LQCalcDVDA.reset100();
+        rx.scanIndex++;
+        rx.RFmodeCycleMultiplier = 1;
+        rx.warmStart = false;
+    }
+}
+
+void LinkSim::rxUpdateWarmStart(uint32_t now)
+{
+    if (!reset || !reset->warmStart || rx.connectionState != connected || now - rx.warmStartLastSaved < WARM_START_SAVE_INTERVAL)
+        return;
+
+    rx.warmStartLastSaved = now;
+    warm_start_state_t state = {uidSeed(), rx.rateIndex, (uint8_t)OtaSwitchModeCurrent, rx.tlmDenom, 0, rx.FreqOffset};
+    WarmStartSave(state);
+}
+
+void LinkSim::rxBoot(uint64_t t)
+{
+    rxInit();
+    uint32_t const now = rx.clock.millis(t);
+    rx.RFmodeLastCycled = now;
+    rx.rateIndex = reset->configRateIndex;
+    rx.RFmodeCycleMultiplier = RF_MODE_CYCLE_MULTIPLIER_SLOW / 2;
+
+    warm_start_state_t state;
+    if (reset->warmStart && WarmStartLoad(&state) && state.uidSeed == uidSeed())
+    {
+        rx.warmStart = true;
+        rx.rateIndex = state.rateIndex;
+        rx.tlmDenom = state.tlmDenom;
+        rx.FreqOffset = state.freqOffset;
+        rx.RFmodeCycleMultiplier = RF_MODE_CYCLE_MULTIPLIER_SLOW;
+    }
+    rx.scanIndex = rx.rateIndex;
+}
+
+void LinkSim::rxLoop(uint64_t t)
+{
+    schedule(t + LOOP_INTERVAL_US, evRxLoop);
+    if (rx.down)
+        return;
+    uint32_t const now = rx.clock.millis(t);
+
+    rx.ota.enter();
+    if (rx.connectionState == tentative && (now - rx.LastSyncPacket > RFperf->RxLockTimeoutMs))
+    {
+        rxLostConnection();
+        rx.LastSyncPacket = now;
+    }
+
+    if ((rx.connectionState == connected) && ((int32_t)RFperf->DisconnectTimeoutMs < (int32_t)(now - rx.LastValidPacket)))
+    {
+        rxLostConnection();
+    }
+
+    rxCycleRfMode(now);
+
+    if ((rx.connectionState == tentative) && (abs(rx.LPF_OffsetDx.value()) <= 10) && (rx.LPF_Offset.value() < 100) && (rx.LQCalc.getLQRaw() > rxMinLqForChaos()))
+    {
+        rxGotConnection(t, now);
+    }
+    else if (rx.connectionState == tentative && rx.warmStart)
+    {
+        rxGotConnection(t, now);
+    }
+    rxUpdateWarmStart(now);
+
+    if ((rx.RXtimerState == tim_tentative) && ((now - rx.GotConnectionMillis) > 1000) && (abs(rx.LPF_OffsetDx.value()) <= 5))
+    {
+        rx.RXtimerState = tim_locked;
+        if (lockTime == 0)
+            lockTime = t;
+    }
+
+    if (locked())
+    {
+        lqSum += rx.uplinkLQ;
+        ++lqCount;
+    }
+    rx.ota.leave();
+}
+
+void LinkSim::run(uint32_t durationMs, linksim_result_t *result)
+{
+    OtaUpdateCrcInitFromUid();
+    OtaUpdateSerializers(smWideOr8ch, ModParams->PayloadLength);
+    FHSSrandomiseFHSSsequence(uidSeed());
+    FHSSptr = 0;
+    OtaNonce = 0;
+
+    tx.freq = FHSSgetInitialFreq();
+    rx.freq = FHSSgetInitialFreq();
+
+    // Start the TX at a random phase relative to the RX loop
+    uint64_t const txStart = rng() % ModParams->interval;
+    tx.alarmLocal = tx.clock.local(txStart);
+    schedule(txStart, evTxTimer);
+    schedule(0, evRxLoop);
+    if (reset)
+    {
+        WarmStartClear();
+        schedule((uint64_t)reset->resetAtMs * 1000, evRxReset);
+        schedule((uint64_t)(reset->resetAtMs + reset->bootMs) * 1000, evRxBoot);
+    }
+
+    uint64_t const endTime = (uint64_t)durationMs * 1000;
+    while (!events.empty() && events.top().time < endTime)
+    {
+        simEvent_t ev = events.top();
+        events.pop();
+
+        switch (ev.type)
+        {
+        case evTxTimer:
+            txTimerCallback(ev.time);
+            break;
+        case evTxDone:
+            txTXdoneISR(ev.time);
+            break;
+        case evTxRxDone:
+            txRXdoneISR(ev.time, ev);
+            break;
+        case evRxTimer:
+            rxTimerCallback(ev.time, ev.timerGen);
+            break;
+        case evRxRxDone:
+            rxRXdoneISR(ev.time, ev);
+            break;
+        case evRxLoop:
+            rxLoop(ev.time);
+            break;
+        case evRxReset:
+            resetTime = ev.time;
+            rx.down = true;
+            rxTimerStop();
+            break;
+        case evRxBoot:
+            rxBoot(ev.time);
+            break;
+        }
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->timeToConnectMs = connectTime / 1000;
+    result->timeToLockMs = lockTime / 1000;
+    result->lostConnections = lostConnections;
+    result->freqOffset = rx.FreqOffset;
+    if (offsetCount)
+    {
+        int64_t const mean = offsetSum / offsetCount;
+        result->offsetMean = mean;
+        result->offsetVariance = offsetSqSum / offsetCount - mean * mean;
+    }
+    if (lqCount)
+        result->uplinkLq = lqSum / lqCount;
+    if (tlmSlots)
+        result->downlinkLq = (uint64_t)tlmReceived * 100 / tlmSlots;
+    result->rcFramesDelivered = rcFrames;
+    if (rcFrames)
+        result->latencyMeanUs = latencySum / rcFrames;
+    result->latencyMaxUs = latencyMax;
+    if (resumeTime)
+        result->timeToResumeMs = (resumeTime - resetTime) / 1000;
+}
+
+} // namespace
+
+void LinkSimRun(uint8_t rateIndex, const linksim_channel_t &chan, uint32_t durationMs, linksim_result_t *result)
+{
+    LinkSim sim(rateIndex, chan, nullptr);
+    sim.run(durationMs, result);
+}
+
+void LinkSimRunReset(uint8_t rateIndex, const linksim_channel_t &chan, const linksim_reset_t &reset,
+    uint32_t durationMs, linksim_result_t *result)
+{
+    LinkSim sim(rateIndex, chan, &reset);
+    sim.run(durationMs, result);
+}
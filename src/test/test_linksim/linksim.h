@@ -0,0 +1,82 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Closed-loop TX/RX link simulator
+ *
+ * Drives the real OTA serializers/CRC, FHSS, PFD, LPF and LQCALC code from
+ * both ends of a link against a virtual radio channel and a virtual hwTimer
+ * per end. The TX side follows tx_main's timerCallback / SendRCdataToRF /
+ * nonceAdvance / TXdoneISR sequencing and the RX side follows rx_main's
+ * RXdoneISR / ProcessRFPacket / HandleFHSS / updatePhaseLock and the loop()
+ * connection state machine, including cycling through the rates and the
+ * RX_WARM_START fast path after a reset, so changes to the timing loop can be
+ * measured as numbers instead of on hardware.
+ *
+ * Both ends share the OtaNonce/FHSSptr globals, so the simulator swaps each
+ * end's copy in before running any of its code.
+ *
+ * NOTE: the TX and RX sides here are a MODEL of tx_main.cpp / rx_main.cpp,
+ * not that code. Only the library code named above is the real thing; the
+ * ISR sequencing, timeouts and connection state machine are re-implemented
+ * in linksim.cpp because src/ is not part of the native build. A change to
+ * that logic in tx_main/rx_main must be mirrored here by hand, or the
+ * simulator will go on measuring the old behaviour.
+ */
+#pragma once
+
+#include "targets.h"
+#include "common.h"
+#include "sx128x_air_rates.h"
+
+typedef struct {
+    float lossRate;         // probability any single packet is lost (0-1)
+    float fadeEnterRate;    // per-packet probability of entering a burst fade (Gilbert-Elliott)
+    float fadeExitRate;     // per-packet probability of leaving a burst fade
+    int32_t txPpm;          // TX crystal error
+    int32_t rxPpm;          // RX crystal error
+    uint32_t jitterUs;      // max ISR service latency added to each event (uniform 0..jitterUs)
+    uint32_t seed;          // RNG seed, the run is fully deterministic for a given seed
+} linksim_channel_t;
+
+typedef struct {
+    uint32_t timeToConnectMs;   // RX tentative -> connected, 0 if never
+    uint32_t timeToLockMs;      // RX timer locked, 0 if never
+    uint32_t lostConnections;   // RX connected -> disconnected transitions
+    int32_t offsetMean;         // PFD raw offset (us) once locked
+    uint32_t offsetVariance;    // PFD raw offset variance (us^2) once locked
+    int32_t freqOffset;         // RX hwTimer FreqOffset at the end of the run
+    uint8_t uplinkLq;           // mean RX LQ once locked
+    uint8_t downlinkLq;         // TLM packets received / TLM slots once locked
+    uint32_t rcFramesDelivered; // RC frames passed to the output once locked
+    uint32_t latencyMeanUs;     // handset sample -> RX channel output
+    uint32_t latencyMaxUs;
+    uint32_t timeToResumeMs;    // RX reset -> first RC frame output, 0 if never
+} linksim_result_t;
+
+typedef struct {
+    uint32_t resetAtMs;         // the RX resets (brownout, watchdog) while the TX keeps running
+    uint32_t bootMs;            // until the RX is listening again
+    uint8_t configRateIndex;    // rate a cold boot starts on before cycling, the RX config's initial rate
+    bool warmStart;             // keep the link state across the reset, as rx_main does with RX_WARM_START
+} linksim_reset_t;
+
+// SX128x air rates, built from the same rows as ExpressLRS_AirRateConfig / ExpressLRS_AirRateRFperf
+#define LINKSIM_RATE_COUNT SX128X_AIR_RATE_COUNT
+extern expresslrs_mod_settings_s LinkSimAirRateConfig[LINKSIM_RATE_COUNT];
+extern expresslrs_rf_pref_params_s LinkSimAirRateRFperf[LINKSIM_RATE_COUNT];
+
+/**
+ * @brief Run the TX and RX against each other for durationMs of simulated time
+ * @param rateIndex index into LinkSimAirRateConfig
+ * @param chan channel impairment model
+ * @param result filled with the link metrics
+ */
+void LinkSimRun(uint8_t rateIndex, const linksim_channel_t &chan, uint32_t durationMs, linksim_result_t *result);
+
+/**
+ * @brief As LinkSimRun(), with the RX reset part way through
+ * @param reset when and how the RX resets, result->timeToResumeMs is measured from reset.resetAtMs
+ */
+void LinkSimRunReset(uint8_t rateIndex, const linksim_channel_t &chan, const linksim_reset_t &reset,
+    uint32_t durationMs, linksim_result_t *result);
@@ -0,0 +1,151 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Closed-loop link simulation tests, runs the TX and RX timing loops against
+ * each other for every SX128x air rate and reports the link metrics
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+
+#include "targets.h"
+#include "common.h"
+#include "CRSF.h"
+#include "linksim.h"
+
+CRSF crsf;  // need an instance to provide the fields used by the code under test
+uint32_t ChannelData[CRSF_NUM_CHANNELS];      // Current state of channels, CRSF format
+uint8_t UID[6] = {1,2,3,4,5,6};
+
+// common.cpp is not part of the native build
+uint8_t TLMratioEnumToValue(expresslrs_tlm_ratio_e const enumval)
+{
+    if (enumval == TLM_RATIO_NO_TLM)
+        return 1;
+    return 1 << (8 + TLM_RATIO_NO_TLM - enumval);
+}
+
+#define SIM_DURATION_MS 10000
+
+static const linksim_channel_t chanClean = {0.0f, 0.0f, 0.0f, 0, 0, 0, 1};
+static const linksim_channel_t chanLossy = {0.10f, 0.002f, 0.25f, 0, 0, 20, 2};
+static const linksim_channel_t chanDrift = {0.0f, 0.0f, 0.0f, 20, -20, 20, 3};
+
+static void printResult(const char *name, uint8_t rateIndex, const linksim_result_t &r)
+{
+    printf("%-6s rate=%u interval=%5uus connect=%5ums lock=%5ums lost=%u offset=%4d var=%5u freqOff=%3d "
+        "LQ=%3u/%3u frames=%5u latency=%5u/%5uus\n",
+        name, rateIndex, LinkSimAirRateConfig[rateIndex].interval, r.timeToConnectMs, r.timeToLockMs, r.lostConnections,
+        r.offsetMean, r.offsetVariance, r.freqOffset, r.uplinkLq, r.downlinkLq, r.rcFramesDelivered,
+        r.latencyMeanUs, r.latencyMaxUs);
+}
+
+void test_linksim_clean()
+{
+    for (uint8_t rate = 0; rate < LINKSIM_RATE_COUNT; ++rate)
+    {
+        linksim_result_t r;
+        LinkSimRun(rate, chanClean, SIM_DURATION_MS, &r);
+        printResult("clean", rate, r);
+
+        TEST_ASSERT_NOT_EQUAL(0, r.timeToConnectMs);
+        TEST_ASSERT_NOT_EQUAL(0, r.timeToLockMs);
+        TEST_ASSERT_EQUAL(0, r.lostConnections);
+        TEST_ASSERT_GREATER_OR_EQUAL(99, r.uplinkLq);
+        TEST_ASSERT_GREATER_OR_EQUAL(99, r.downlinkLq);
+        TEST_ASSERT_NOT_EQUAL(0, r.rcFramesDelivered);
+        // A frame can never arrive before it was sent, nor should it take more than a few packet intervals
+        TEST_ASSERT_GREATER_OR_EQUAL(LinkSimAirRateRFperf[rate].TOA, r.latencyMeanUs);
+        TEST_ASSERT_LESS_OR_EQUAL(LinkSimAirRateConfig[rate].interval * LinkSimAirRateConfig[rate].numOfSends * 2, r.latencyMeanUs);
+    }
+}
+
+void test_linksim_lossy()
+{
+    for (uint8_t rate = 0; rate < LINKSIM_RATE_COUNT; ++rate)
+    {
+        linksim_result_t r;
+        LinkSimRun(rate, chanLossy, SIM_DURATION_MS, &r);
+        printResult("lossy", rate, r);
+
+        TEST_ASSERT_NOT_EQUAL(0, r.timeToLockMs);
+        // 10% independent loss plus ~0.8% of the time in a fade, DVDA only needs one of the sends
+        if (LinkSimAirRateConfig[rate].numOfSends == 1)
+            TEST_ASSERT_UINT32_WITHIN(8, 89, r.uplinkLq);
+        else
+            TEST_ASSERT_GREATER_OR_EQUAL(89, r.uplinkLq);
+    }
+}
+
+void test_linksim_drift()
+{
+    for (uint8_t rate = 0; rate < LINKSIM_RATE_COUNT; ++rate)
+    {
+        linksim_result_t r;
+        LinkSimRun(rate, chanDrift, SIM_DURATION_MS, &r);
+        printResult("drift", rate, r);
+
+        TEST_ASSERT_NOT_EQUAL(0, r.timeToLockMs);
+        TEST_ASSERT_EQUAL(0, r.lostConnections);
+        // 40ppm is well under 1us per interval, the RX timer should not need to walk far to track it
+        TEST_ASSERT_INT_WITHIN(2, 0, r.freqOffset);
+        TEST_ASSERT_INT_WITHIN(10, 0, r.offsetMean);
+    }
+}
+
+void test_linksim_deterministic()
+{
+    linksim_result_t a, b;
+    LinkSimRun(4, chanLossy, 3000, &a);
+    LinkSimRun(4, chanLossy, 3000, &b);
+    TEST_ASSERT_EQUAL(a.timeToConnectMs, b.timeToConnectMs);
+    TEST_ASSERT_EQUAL(a.timeToLockMs, b.timeToLockMs);
+    TEST_ASSERT_EQUAL(a.offsetVariance, b.offsetVariance);
+    TEST_ASSERT_EQUAL(a.rcFramesDelivered, b.rcFramesDelivered);
+}
+
+void test_linksim_reconnect()
+{
+    // A brownout once the link is locked, the RX takes a while to boot and listen again
+    linksim_reset_t reset = {3000, 300, 0, false};
+    for (uint8_t rate = 0; rate < LINKSIM_RATE_COUNT; ++rate)
+    {
+        linksim_result_t cold, stale, warm;
+        reset.configRateIndex = rate;
+        reset.warmStart = false;
+        LinkSimRunReset(rate, chanClean, reset, 2 * SIM_DURATION_MS, &cold);
+        // The rate in the config is only updated when the link is lost, not at a reset
+        reset.configRateIndex = (rate + LINKSIM_RATE_COUNT / 2) % LINKSIM_RATE_COUNT;
+        LinkSimRunReset(rate, chanClean, reset, 2 * SIM_DURATION_MS, &stale);
+        reset.warmStart = true;
+        LinkSimRunReset(rate, chanClean, reset, 2 * SIM_DURATION_MS, &warm);
+        printf("reset  rate=%u interval=%5uus resume cold=%5ums stale=%5ums warm=%5ums\n",
+            rate, LinkSimAirRateConfig[rate].interval, cold.timeToResumeMs, stale.timeToResumeMs, warm.timeToResumeMs);
+
+        TEST_ASSERT_NOT_EQUAL(0, cold.timeToResumeMs);
+        TEST_ASSERT_NOT_EQUAL(0, warm.timeToResumeMs);
+        TEST_ASSERT_LESS_OR_EQUAL(cold.timeToResumeMs, warm.timeToResumeMs);
+        // Not having to scan the rates is where most of the time goes
+        TEST_ASSERT_TRUE(stale.timeToResumeMs == 0 || warm.timeToResumeMs < stale.timeToResumeMs);
+        TEST_ASSERT_EQUAL(0, warm.lostConnections);
+    }
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_linksim_clean);
+    RUN_TEST(test_linksim_lossy);
+    RUN_TEST(test_linksim_drift);
+    RUN_TEST(test_linksim_deterministic);
+    RUN_TEST(test_linksim_reconnect);
+    UNITY_END();
+
+    return 0;
+}
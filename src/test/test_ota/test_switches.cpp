@@ -648,6 +648,95 @@ void test_decodingHybridWide_AUXX_low()
         test_decodingHybridWide(false, i, 0, CRSF_CHANNEL_VALUE_1000);
 }
 
+/**
+ * Bit-at-a-time 4x10 packer/unpacker, the original implementations, used as the
+ * reference for the word-parallel versions in OTA.cpp
+ */
+static void ref_PackUInt11ToChannels4x10(uint32_t const * const src, uint8_t *dest, bool limit)
+{
+    const unsigned DEST_PRECISION = 10;
+    *dest = 0;
+    unsigned destShift = 0;
+    for (unsigned ch=0; ch<4; ++ch)
+    {
+        unsigned chVal = limit ? CRSF_to_UINT10(constrain(src[ch], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX)) : src[ch] >> 1;
+        *dest++ |= chVal << destShift;
+        unsigned srcBitsLeft = DEST_PRECISION - 8 + destShift;
+        *dest = chVal >> (DEST_PRECISION - srcBitsLeft);
+        destShift = srcBitsLeft;
+    }
+}
+
+static void ref_UnpackChannels4x10ToUInt11(uint8_t const * const payload, uint32_t * const dest)
+{
+    uint8_t bitsMerged = 0;
+    uint32_t readValue = 0;
+    unsigned readByteIndex = 0;
+    for (uint8_t n = 0; n < 4; n++)
+    {
+        while (bitsMerged < 10)
+        {
+            readValue |= ((uint32_t)payload[readByteIndex++]) << bitsMerged;
+            bitsMerged += 8;
+        }
+        dest[n] = (readValue & 0x3ff) << 1;
+        readValue >>= 10;
+        bitsMerged -= 10;
+    }
+}
+
+static void test_channels4x10_roundtrip(OtaSwitchMode_e mode, uint8_t packetSize)
+{
+    const bool fullRes = packetSize == OTA8_PACKET_SIZE;
+    const unsigned chOffset = fullRes ? offsetof(OTA_Packet8_s, rc.chLow) : offsetof(OTA_Packet4_s, rc.ch);
+    OtaUpdateSerializers(mode, packetSize);
+    OtaSetFullResNextChannelSet(false);
+
+    // Every 11-bit value in each of the 4 positions, with random values in the others
+    for (unsigned pos = 0; pos < 4; ++pos)
+    {
+        for (uint32_t val = 0; val < 2048; ++val)
+        {
+            uint32_t channelsIn[CRSF_NUM_CHANNELS];
+            for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+                channelsIn[ch] = random() % 2048;
+            channelsIn[pos] = val;
+
+            WORD_ALIGNED_ATTR OTA_Packet_s otaPkt;
+            memset(&otaPkt, 0xff, sizeof(otaPkt));
+            OtaPackChannelData(&otaPkt, channelsIn, false, 0);
+            OtaSetFullResNextChannelSet(false);
+
+            uint8_t expected[6] = {0};
+            ref_PackUInt11ToChannels4x10(channelsIn, expected, !fullRes);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, &((uint8_t *)&otaPkt)[chOffset], 5);
+
+            uint32_t channelsOut[CRSF_NUM_CHANNELS] = {0};
+            uint32_t refOut[4];
+            OtaUnpackChannelData(&otaPkt, channelsOut, 0);
+            ref_UnpackChannels4x10ToUInt11(expected, refOut);
+            for (unsigned ch = 0; ch < 4; ++ch)
+            {
+                uint32_t ref = fullRes ? refOut[ch] : UINT10_to_CRSF(refOut[ch] >> 1);
+                TEST_ASSERT_EQUAL(ref, channelsOut[ch]);
+            }
+        }
+    }
+}
+
+void test_channels4x10_roundtrip_hybrid()
+{
+    test_channels4x10_roundtrip(smHybridOr16ch, OTA4_PACKET_SIZE);
+    test_channels4x10_roundtrip(smWideOr8ch, OTA4_PACKET_SIZE);
+}
+
+void test_channels4x10_roundtrip_fullres()
+{
+    test_channels4x10_roundtrip(smWideOr8ch, OTA8_PACKET_SIZE);
+    test_channels4x10_roundtrip(smHybridOr16ch, OTA8_PACKET_SIZE);
+    test_channels4x10_roundtrip(sm12ch, OTA8_PACKET_SIZE);
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -677,6 +766,9 @@ int main(int argc, char **argv)
     RUN_TEST(test_encodingFullres12ch);
     RUN_TEST(test_decodingFullres16chLow);
 
+    RUN_TEST(test_channels4x10_roundtrip_hybrid);
+    RUN_TEST(test_channels4x10_roundtrip_fullres);
+
     UNITY_END();
 
     return 0;
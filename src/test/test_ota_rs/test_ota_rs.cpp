@@ -0,0 +1,209 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Unit tests for the Reed-Solomon protected OTA8 packet mode
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unity.h>
+
+#include "targets.h"
+#include "common.h"
+#include "CRSF.h"
+#include "OTA.h"
+#include "ReedSolomon.h"
+
+CRSF crsf;  // need an instance to provide the fields used by the code under test
+uint32_t ChannelData[CRSF_NUM_CHANNELS];      // Current state of channels, CRSF format
+uint8_t UID[6] = {1,2,3,4,5,6};
+
+static void randomBytes(uint8_t *buf, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+        buf[i] = rand();
+}
+
+// Corrupt `count` different bytes of buf
+static void corruptBytes(uint8_t *buf, uint8_t len, uint8_t count)
+{
+    uint8_t positions[RS_PARITY_LEN] = {0};
+    for (uint8_t n = 0; n < count; n++)
+    {
+        bool unique;
+        do {
+            positions[n] = rand() % len;
+            unique = true;
+            for (uint8_t m = 0; m < n; m++)
+                unique &= positions[m] != positions[n];
+        } while (!unique);
+        buf[positions[n]] ^= 1 + rand() % 255;
+    }
+}
+
+void test_rs_corrects_byte_errors(void)
+{
+    for (uint8_t dataLen = 1; dataLen <= 32; dataLen++)
+    {
+        for (int iteration = 0; iteration < 500; iteration++)
+        {
+            uint8_t buf[32 + RS_PARITY_LEN];
+            uint8_t expected[sizeof(buf)];
+            const uint8_t len = dataLen + RS_PARITY_LEN;
+            randomBytes(buf, dataLen);
+            RSEncode(buf, dataLen);
+            memcpy(expected, buf, len);
+
+            // No errors, then every number the code can correct, in the data or the parity
+            const uint8_t errors = iteration % (RS_PARITY_LEN / 2 + 1);
+            corruptBytes(buf, len, errors);
+            TEST_ASSERT_EQUAL(errors, RSDecode(buf, dataLen));
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, len);
+        }
+    }
+}
+
+void test_rs_all_values_single_error(void)
+{
+    uint8_t buf[OTA8_RS_PACKET_SIZE];
+    uint8_t expected[OTA8_RS_PACKET_SIZE];
+    randomBytes(buf, OTA8_PACKET_SIZE);
+    RSEncode(buf, OTA8_PACKET_SIZE);
+    memcpy(expected, buf, sizeof(buf));
+
+    for (uint8_t pos = 0; pos < OTA8_RS_PACKET_SIZE; pos++)
+    {
+        for (unsigned value = 0; value < 256; value++)
+        {
+            buf[pos] = value;
+            TEST_ASSERT_EQUAL(value == expected[pos] ? 0 : 1, RSDecode(buf, OTA8_PACKET_SIZE));
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, sizeof(buf));
+        }
+    }
+}
+
+void test_ota_rs_roundtrip(void)
+{
+    OtaUpdateCrcInitFromUid();
+    OtaUpdateSerializers(sm12ch, OTA8_RS_PACKET_SIZE);
+    TEST_ASSERT_TRUE(OtaIsFullRes);
+
+    for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+        ChannelData[ch] = CRSF_CHANNEL_VALUE_MIN + ch * 97;
+
+    WORD_ALIGNED_ATTR OTA_Packet_s otaPkt;
+    memset(&otaPkt, 0, sizeof(otaPkt));
+    OtaPackChannelData(&otaPkt, ChannelData, false, 4);
+    OtaGeneratePacketCrc(&otaPkt);
+
+    // The first 13 bytes are a plain OTA8 packet
+    OTA_Packet_s plain = otaPkt;
+    OtaUpdateSerializers(sm12ch, OTA8_PACKET_SIZE);
+    TEST_ASSERT_TRUE(OtaValidatePacketCrc(&plain));
+    OtaUpdateSerializers(sm12ch, OTA8_RS_PACKET_SIZE);
+
+    // Two corrupted bytes, one in the CRC, are corrected before unpacking
+    otaPkt.full.rc.chLow.raw[2] ^= 0x5A;
+    ((uint8_t *)&otaPkt.full.crc)[1] ^= 0xFF;
+    TEST_ASSERT_TRUE(OtaValidatePacketCrc(&otaPkt));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY((uint8_t *)&plain, (uint8_t *)&otaPkt, OTA8_RS_PACKET_SIZE);
+
+    uint32_t channelsOut[CRSF_NUM_CHANNELS] = {0};
+    OtaUnpackChannelData(&otaPkt, channelsOut, 4);
+    for (unsigned ch = 0; ch < 4; ++ch)
+        TEST_ASSERT_UINT32_WITHIN(1, ChannelData[ch], channelsOut[ch]);
+}
+
+typedef struct {
+    unsigned received;   // passed the CRC with the data that was sent
+    unsigned corrupted;  // had at least one bit error
+    unsigned falseAccept;
+    double validateNs;   // total time in OtaValidatePacketCrc
+} ber_result_t;
+
+static void runBitErrors(uint8_t packetSize, double ber, unsigned packets, ber_result_t *result)
+{
+    OtaUpdateSerializers(smHybridOr16ch, packetSize);
+    memset(result, 0, sizeof(*result));
+    const uint32_t threshold = (uint32_t)(ber * RAND_MAX);
+
+    for (unsigned p = 0; p < packets; p++)
+    {
+        for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+            ChannelData[ch] = CRSF_CHANNEL_VALUE_MIN + rand() % (CRSF_CHANNEL_VALUE_MAX - CRSF_CHANNEL_VALUE_MIN);
+        WORD_ALIGNED_ATTR OTA_Packet_s sent;
+        memset(&sent, 0, sizeof(sent));
+        OtaPackChannelData(&sent, ChannelData, false, 4);
+        OtaGeneratePacketCrc(&sent);
+
+        // Independent bit errors over everything sent
+        WORD_ALIGNED_ATTR OTA_Packet_s received = sent;
+        uint8_t * const raw = (uint8_t *)&received;
+        bool corrupted = false;
+        for (unsigned bit = 0; bit < packetSize * 8U; bit++)
+        {
+            if ((uint32_t)rand() < threshold)
+            {
+                raw[bit / 8] ^= 1 << (bit % 8);
+                corrupted = true;
+            }
+        }
+        result->corrupted += corrupted;
+
+        auto start = std::chrono::steady_clock::now();
+        const bool valid = OtaValidatePacketCrc(&received);
+        result->validateNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (valid)
+        {
+            if (memcmp(&sent, &received, OTA8_PACKET_SIZE) == 0)
+                result->received++;
+            else
+                result->falseAccept++;
+        }
+    }
+}
+
+void test_ota_rs_bit_error_injection(void)
+{
+    OtaUpdateCrcInitFromUid();
+    srand(42);
+
+    const unsigned packets = 20000;
+    const double bers[] = {0.001, 0.003, 0.01, 0.02};
+    for (double ber : bers)
+    {
+        ber_result_t plain, rs;
+        runBitErrors(OTA8_PACKET_SIZE, ber, packets, &plain);
+        runBitErrors(OTA8_RS_PACKET_SIZE, ber, packets, &rs);
+
+        char msg[160];
+        snprintf(msg, sizeof(msg), "BER %.3f: OTA8 %.1f%% received, OTA8 RS %.1f%% received (%.1f%% of corrupted recovered), validate %.0f vs %.0f ns/packet",
+            ber, 100.0 * plain.received / packets, 100.0 * rs.received / packets,
+            100.0 * (rs.received - (packets - rs.corrupted)) / (rs.corrupted ? rs.corrupted : 1),
+            plain.validateNs / packets, rs.validateNs / packets);
+        TEST_MESSAGE(msg);
+
+        TEST_ASSERT_EQUAL(0, rs.falseAccept);
+        TEST_ASSERT_GREATER_THAN(plain.received, rs.received);
+    }
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rs_corrects_byte_errors);
+    RUN_TEST(test_rs_all_values_single_error);
+    RUN_TEST(test_ota_rs_roundtrip);
+    RUN_TEST(test_ota_rs_bit_error_injection);
+    UNITY_END();
+
+    return 0;
+}
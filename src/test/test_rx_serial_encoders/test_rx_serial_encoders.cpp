@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unity.h>
+
+#include "crsf_protocol.h"
+#include "RxSerialEncoders.h"
+
+// The SBUS frame as SerialSBUS built it field by field, which SbusEncodeFrame must match exactly
+static void referenceSbus(uint8_t *frame, const uint32_t *channelData, bool djiRsPro, uint8_t flags)
+{
+    crsf_channels_s PackedRCdataOut;
+    if (djiRsPro)
+    {
+        PackedRCdataOut.ch0 = fmap(channelData[0], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch1 = fmap(channelData[1], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch2 = fmap(channelData[2], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch3 = fmap(channelData[3], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch4 = fmap(channelData[5], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch5 = fmap(channelData[6], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch6 = fmap(channelData[7], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 176,  848);
+        PackedRCdataOut.ch7 = fmap(channelData[8], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch8 = fmap(channelData[9], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch9 = fmap(channelData[10], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch10 = fmap(channelData[11], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch11 = fmap(channelData[12], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch12 = fmap(channelData[13], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch13 = fmap(channelData[14], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch14 = fmap(channelData[15], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 352, 1696);
+        PackedRCdataOut.ch15 = channelData[4] < CRSF_CHANNEL_VALUE_MID ? 352 : 1696;
+    }
+    else
+    {
+        PackedRCdataOut.ch0 = channelData[0];
+        PackedRCdataOut.ch1 = channelData[1];
+        PackedRCdataOut.ch2 = channelData[2];
+        PackedRCdataOut.ch3 = channelData[3];
+        PackedRCdataOut.ch4 = channelData[4];
+        PackedRCdataOut.ch5 = channelData[5];
+        PackedRCdataOut.ch6 = channelData[6];
+        PackedRCdataOut.ch7 = channelData[7];
+        PackedRCdataOut.ch8 = channelData[8];
+        PackedRCdataOut.ch9 = channelData[9];
+        PackedRCdataOut.ch10 = channelData[10];
+        PackedRCdataOut.ch11 = channelData[11];
+        PackedRCdataOut.ch12 = channelData[12];
+        PackedRCdataOut.ch13 = channelData[13];
+        PackedRCdataOut.ch14 = channelData[14];
+        PackedRCdataOut.ch15 = channelData[15];
+    }
+    frame[0] = 0x0F;
+    memcpy(&frame[1], &PackedRCdataOut, sizeof(PackedRCdataOut));
+    frame[23] = flags;
+    frame[24] = 0x00;
+}
+
+// The SUMD frame as SerialSUMD built it, one fmap() per channel and the CRC over the whole frame
+static void referenceSumd(uint8_t *outBuffer, const uint32_t *channelData)
+{
+    static const uint8_t order[16] = {0, 1, 2, 3, 7, 5, 6, 4, 8, 9, 10, 11, 12, 13, 14, 15};
+    Crc2Byte crc2Byte;
+    crc2Byte.init(16, 0x1021);
+
+    outBuffer[0] = 0xA8;
+    outBuffer[1] = 0x01;
+    outBuffer[2] = 0x10;
+    for (unsigned ch = 0; ch < 16; ch++)
+    {
+        uint16_t us = fmap(channelData[order[ch]], CRSF_CHANNEL_VALUE_MIN, CRSF_CHANNEL_VALUE_MAX, 988, 2012) << 3;
+        outBuffer[3 + ch * 2] = us >> 8;
+        outBuffer[4 + ch * 2] = us & 0x00ff;
+    }
+    uint16_t crc = crc2Byte.calc(outBuffer, (SUMD_HEADER_SIZE + SUMD_DATA_SIZE_16CH), 0);
+    outBuffer[35] = (uint8_t)(crc >> 8);
+    outBuffer[36] = (uint8_t)(crc & 0x00ff);
+}
+
+// Every 11-bit value in each of the 16 positions, with random values in the others
+template <typename F>
+static void forEveryChannelValue(F check)
+{
+    for (unsigned pos = 0; pos < 16; ++pos)
+    {
+        for (uint32_t val = 0; val < 2048; ++val)
+        {
+            uint32_t channelData[16];
+            for (unsigned ch = 0; ch < 16; ++ch)
+                channelData[ch] = rand() % 2048;
+            channelData[pos] = val;
+            check(channelData);
+        }
+    }
+}
+
+void test_sbus_matches_reference(void)
+{
+    forEveryChannelValue([](const uint32_t *channelData) {
+        const uint8_t flags = rand() & (SBUS_FLAG_SIGNAL_LOSS | SBUS_FLAG_FAILSAFE_ACTIVE);
+        uint8_t expected[SBUS_FRAME_LEN];
+        uint8_t actual[SBUS_FRAME_LEN];
+        referenceSbus(expected, channelData, false, flags);
+        SbusEncodeFrame(actual, channelData, false, flags);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, SBUS_FRAME_LEN);
+    });
+}
+
+void test_sbus_dji_rs_pro_matches_reference(void)
+{
+    forEveryChannelValue([](const uint32_t *channelData) {
+        uint8_t expected[SBUS_FRAME_LEN];
+        uint8_t actual[SBUS_FRAME_LEN];
+        referenceSbus(expected, channelData, true, SBUS_FLAG_SIGNAL_LOSS);
+        SbusEncodeFrame(actual, channelData, true, SBUS_FLAG_SIGNAL_LOSS);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, SBUS_FRAME_LEN);
+    });
+}
+
+void test_sumd_matches_reference(void)
+{
+    SumdEncoder encoder;
+    forEveryChannelValue([&encoder](const uint32_t *channelData) {
+        uint8_t expected[SUMD_FRAME_16CH_LEN];
+        uint8_t actual[SUMD_FRAME_16CH_LEN];
+        referenceSumd(expected, channelData);
+        encoder.encodeFrame(actual, channelData);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, SUMD_FRAME_16CH_LEN);
+    });
+}
+
+void test_encoder_timing(void)
+{
+    const unsigned iterations = 200000;
+    uint32_t channelData[16];
+    for (unsigned ch = 0; ch < 16; ++ch)
+        channelData[ch] = CRSF_CHANNEL_VALUE_MIN + rand() % (CRSF_CHANNEL_VALUE_MAX - CRSF_CHANNEL_VALUE_MIN);
+
+    SumdEncoder encoder;
+    volatile uint8_t sink = 0;
+    uint8_t frame[SUMD_FRAME_16CH_LEN];
+    double ns[4];
+    for (unsigned impl = 0; impl < 4; ++impl)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            channelData[i % 16] ^= 1;
+            switch (impl)
+            {
+            case 0: referenceSbus(frame, channelData, true, 0); break;
+            case 1: SbusEncodeFrame(frame, channelData, true, 0); break;
+            case 2: referenceSumd(frame, channelData); break;
+            case 3: encoder.encodeFrame(frame, channelData); break;
+            }
+            sink += frame[5];
+        }
+        ns[impl] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "SBUS DJI RS Pro %.1f -> %.1f ns/frame, SUMD %.1f -> %.1f ns/frame", ns[0], ns[1], ns[2], ns[3]);
+    TEST_MESSAGE(msg);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sbus_matches_reference);
+    RUN_TEST(test_sbus_dji_rs_pro_matches_reference);
+    RUN_TEST(test_sumd_matches_reference);
+    RUN_TEST(test_encoder_timing);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <unity.h>
+
+#include "RxSerialScheduler.h"
+#include "device.h"
+
+#define SBUS_MIN_GAP_US (RxSerialScheduler::wireTimeUs(100000, 12, 25) + 500)
+#define LOOP_US 50  // main loop period while polling
+
+void test_wire_time(void)
+{
+    // SBUS 25 bytes 8E2 at 100000 baud, SUMD 37 bytes 8N1 at 115200 baud
+    TEST_ASSERT_EQUAL(3000, RxSerialScheduler::wireTimeUs(100000, 12, 25));
+    TEST_ASSERT_EQUAL(3212, RxSerialScheduler::wireTimeUs(115200, 10, 37));
+}
+
+void test_period_follows_packets(void)
+{
+    // Every arrival is offered, the frames are on the ones nearest the period
+    const struct { uint32_t packetUs; uint32_t periodUs; uint32_t expectedUs; } cases[] = {
+        {1000, 9000, 9000},
+        {2000, 9000, 8000},   // as near as 10000, not slower than asked for
+        {4000, 9000, 8000},
+        {20000, 9000, 20000}, // slower than the period, every packet
+        {1000, 4000, 4000},
+        {2000, 5000, 4000},
+        {1000, 2000, 4000},   // never below the minimum gap
+    };
+    for (auto &c : cases)
+    {
+        RxSerialScheduler scheduler;
+        scheduler.configure(SBUS_MIN_GAP_US, c.periodUs);
+        uint32_t lastSent = 0;
+        unsigned sent = 0;
+        // Start near the wrap to check it is handled
+        for (uint32_t now = 0xFFFF0000; sent < 20; now += c.packetUs)
+        {
+            if (scheduler.packetArrived(now, c.packetUs))
+            {
+                if (sent > 0)
+                    TEST_ASSERT_EQUAL(c.expectedUs, now - lastSent);
+                scheduler.frameSent(now);
+                lastSent = now;
+                sent++;
+            }
+        }
+    }
+}
+
+void test_keepalive(void)
+{
+    RxSerialScheduler scheduler;
+    scheduler.configure(SBUS_MIN_GAP_US, 9000);
+    TEST_ASSERT_TRUE(scheduler.keepaliveDue(0, 2000));
+    scheduler.frameSent(0);
+
+    // Waits for the period when the packets are faster
+    TEST_ASSERT_FALSE(scheduler.keepaliveDue(8999, 2000));
+    TEST_ASSERT_TRUE(scheduler.keepaliveDue(9000, 2000));
+
+    // and does not take the slot of the next packet when they are slower
+    TEST_ASSERT_FALSE(scheduler.keepaliveDue(20000, 20000));
+    TEST_ASSERT_TRUE(scheduler.keepaliveDue(40000, 20000));
+
+    // No polling needed until the minimum gap could have passed
+    TEST_ASSERT_EQUAL(2, scheduler.holdoffMs());
+    scheduler.configure(1500, 9000);
+    TEST_ASSERT_EQUAL(0, scheduler.holdoffMs());
+}
+
+typedef struct {
+    double meanLatencyUs;   // from the channels arriving to the start of the frame with them
+    uint32_t maxLatencyUs;
+    double meanIntervalUs;
+    double jitterUs;        // standard deviation of the time between frames
+    uint32_t minIntervalUs;
+} output_stats_t;
+
+/**
+ * Drive an SBUS output from a stream of packets with some jitter, the way devSerialIO does:
+ * the device timeout is polled on millisecond ticks, and sendRCFrame() consumes frameAvailable.
+ * The fixed cadence output is what SerialSBUS did before, send the first new channels at least 9ms
+ * after the last frame.
+ */
+static void simulate(bool packetSynchronous, uint32_t packetUs, uint32_t periodUs, output_stats_t *stats)
+{
+    RxSerialScheduler scheduler;
+    scheduler.configure(SBUS_MIN_GAP_US, periodUs);
+
+    // The packets are timed by the TX, so start at any point in the RX's millisecond and drift from it
+    const uint32_t durationUs = 5000000;
+    const double driftedPacketUs = packetUs * 1.00005;
+    double nextPacket = rand() % 1000;
+    uint32_t nextArrival = nextPacket;
+    uint32_t lastArrival = 0;
+    bool frameAvailable = false;
+    uint32_t nextTimeoutMs = 0;
+
+    uint32_t lastSent = 0;
+    unsigned frames = 0;
+    double latencySum = 0, intervalSum = 0, intervalSqSum = 0;
+    stats->maxLatencyUs = 0;
+    stats->minIntervalUs = UINT32_MAX;
+
+    for (uint32_t now = 0; now < durationUs; now += LOOP_US)
+    {
+        if (now >= nextArrival)
+        {
+            frameAvailable = true;
+            lastArrival = nextArrival;
+            nextPacket += driftedPacketUs;
+            nextArrival = nextPacket - 25 + rand() % 50;
+        }
+        if (now / 1000 < nextTimeoutMs)
+            continue;
+
+        const bool available = frameAvailable;
+        frameAvailable = false;
+        bool send;
+        int delay;
+        if (packetSynchronous)
+        {
+            send = available && scheduler.packetArrived(now, packetUs);
+            delay = send ? scheduler.holdoffMs() : DURATION_IMMEDIATELY;
+        }
+        else
+        {
+            send = available;
+            delay = send ? 9 : DURATION_IMMEDIATELY;
+        }
+        nextTimeoutMs = now / 1000 + delay;
+        if (!send)
+            continue;
+
+        scheduler.frameSent(now);
+        const uint32_t latency = now - lastArrival;
+        latencySum += latency;
+        if (latency > stats->maxLatencyUs)
+            stats->maxLatencyUs = latency;
+        if (frames > 0)
+        {
+            const uint32_t interval = now - lastSent;
+            intervalSum += interval;
+            intervalSqSum += (double)interval * interval;
+            if (interval < stats->minIntervalUs)
+                stats->minIntervalUs = interval;
+        }
+        lastSent = now;
+        frames++;
+    }
+
+    stats->meanLatencyUs = latencySum / frames;
+    stats->meanIntervalUs = intervalSum / (frames - 1);
+    stats->jitterUs = sqrt(intervalSqSum / (frames - 1) - stats->meanIntervalUs * stats->meanIntervalUs);
+}
+
+void test_packet_synchronous_latency_jitter(void)
+{
+    srand(21);
+    const uint32_t packetRates[] = {1000, 500, 250, 50};
+    for (uint32_t rate : packetRates)
+    {
+        const uint32_t packetUs = 1000000 / rate;
+        output_stats_t fixed, sync, fast;
+        simulate(false, packetUs, 9000, &fixed);
+        simulate(true, packetUs, 9000, &sync);
+        simulate(true, packetUs, 4000, &fast);
+
+        char msg[200];
+        snprintf(msg, sizeof(msg),
+            "%4uHz latency mean/max us: fixed %.0f/%u sync %.0f/%u fast %.0f/%u, interval/jitter us: fixed %.0f/%.0f sync %.0f/%.0f fast %.0f/%.0f",
+            rate, fixed.meanLatencyUs, fixed.maxLatencyUs, sync.meanLatencyUs, sync.maxLatencyUs, fast.meanLatencyUs, fast.maxLatencyUs,
+            fixed.meanIntervalUs, fixed.jitterUs, sync.meanIntervalUs, sync.jitterUs, fast.meanIntervalUs, fast.jitterUs);
+        TEST_MESSAGE(msg);
+
+        // Sent within a loop of the channels arriving, never too soon after the last frame,
+        // and the time between frames only varies as much as the packets do
+        TEST_ASSERT_LESS_OR_EQUAL(LOOP_US, sync.maxLatencyUs);
+        TEST_ASSERT_LESS_OR_EQUAL(LOOP_US, fast.maxLatencyUs);
+        TEST_ASSERT_GREATER_OR_EQUAL(SBUS_MIN_GAP_US, sync.minIntervalUs);
+        TEST_ASSERT_GREATER_OR_EQUAL(SBUS_MIN_GAP_US, fast.minIntervalUs);
+        TEST_ASSERT_LESS_OR_EQUAL(fixed.meanLatencyUs, sync.meanLatencyUs);  // 50Hz is always sent as it arrives
+        TEST_ASSERT_LESS_OR_EQUAL(50, sync.jitterUs);
+        TEST_ASSERT_LESS_OR_EQUAL(50, fast.jitterUs);
+        TEST_ASSERT_LESS_OR_EQUAL(sync.meanIntervalUs, fast.meanIntervalUs);
+    }
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_wire_time);
+    RUN_TEST(test_period_follows_packets);
+    RUN_TEST(test_keepalive);
+    RUN_TEST(test_packet_synchronous_latency_jitter);
+    UNITY_END();
+
+    return 0;
+}
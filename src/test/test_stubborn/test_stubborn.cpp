@@ -504,6 +504,152 @@ void test_stubborn_link_forlorn_receiver(void)
     receiver.Unlock();
 }
 
+void test_stubborn_window_sends_ahead(void)
+{
+    uint8_t mspSequence[20];
+    uint8_t buffer[100];
+    uint8_t data[ELRS4_MSP_BYTES_PER_CALL];
+    for (int i = 0; i < sizeof(mspSequence); i++)
+        mspSequence[i] = i;
+
+    receiver.setMaxPackageIndex(ELRS_MSP_MAX_PACKAGES);
+    receiver.ResetState();
+    receiver.SetDataToReceive(buffer, sizeof(buffer));
+    sender.setMaxPackageIndex(ELRS_MSP_MAX_PACKAGES);
+    sender.ResetState();
+
+    // Link stats from a receiver which supports SACK
+    sender.ConfirmCurrentPayload(receiver.GetCurrentConfirm(), receiver.GetCurrentSack());
+    sender.SetDataToTransmit(mspSequence, sizeof(mspSequence));
+
+    // The first package is sent non-windowed
+    TEST_ASSERT_EQUAL(1, sender.GetCurrentPayload(data, sizeof(data)));
+    TEST_ASSERT_EQUAL(1, sender.GetCurrentPayload(data, sizeof(data)));
+    receiver.ReceiveData(1, data, sizeof(data));
+    sender.ConfirmCurrentPayload(receiver.GetCurrentConfirm(), receiver.GetCurrentSack());
+
+    // Then 2 and 3 without waiting for a confirm, 4 is last so is held back
+    TEST_ASSERT_EQUAL(2, sender.GetCurrentPayload(data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&mspSequence[5], data, sizeof(data));
+    // 2 is lost
+    TEST_ASSERT_EQUAL(3, sender.GetCurrentPayload(data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&mspSequence[10], data, sizeof(data));
+    receiver.ReceiveData(3, data, sizeof(data));
+    TEST_ASSERT_EQUAL(2, sender.GetCurrentPayload(data, sizeof(data)));
+
+    // SACK says 2 is missing, 3 is received, so only 2 is resent
+    sender.ConfirmCurrentPayload(receiver.GetCurrentConfirm(), receiver.GetCurrentSack());
+    TEST_ASSERT_EQUAL(2, sender.GetCurrentPayload(data, sizeof(data)));
+    TEST_ASSERT_EQUAL(2, sender.GetCurrentPayload(data, sizeof(data)));
+    receiver.ReceiveData(2, data, sizeof(data));
+    sender.ConfirmCurrentPayload(receiver.GetCurrentConfirm(), receiver.GetCurrentSack());
+
+    // Last package
+    TEST_ASSERT_EQUAL(0, sender.GetCurrentPayload(data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&mspSequence[15], data, sizeof(data));
+    receiver.ReceiveData(0, data, sizeof(data));
+    sender.ConfirmCurrentPayload(receiver.GetCurrentConfirm(), receiver.GetCurrentSack());
+
+    TEST_ASSERT_EQUAL(false, sender.IsActive());
+    TEST_ASSERT_EQUAL(true, receiver.HasFinishedData());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(mspSequence, buffer, sizeof(mspSequence));
+}
+
+void test_stubborn_window_falls_back_without_sack(void)
+{
+    uint8_t mspSequence[20] = {0};
+    uint8_t data[ELRS4_MSP_BYTES_PER_CALL];
+
+    sender.setMaxPackageIndex(ELRS_MSP_MAX_PACKAGES);
+    sender.ResetState();
+    sender.ConfirmCurrentPayload(false, STUBBORN_SACK_PRESENT | (1 << STUBBORN_SACK_BASE_SHIFT));
+    sender.SetDataToTransmit(mspSequence, sizeof(mspSequence));
+    TEST_ASSERT_EQUAL(1, sender.GetCurrentPayload(data, sizeof(data)));
+    sender.ConfirmCurrentPayload(true, STUBBORN_SACK_PRESENT | (2 << STUBBORN_SACK_BASE_SHIFT));
+    TEST_ASSERT_EQUAL(2, sender.GetCurrentPayload(data, sizeof(data)));
+    TEST_ASSERT_EQUAL(3, sender.GetCurrentPayload(data, sizeof(data)));
+
+    // A receiver without SACK support, restart non-windowed with a RESYNC
+    sender.ConfirmCurrentPayload(true, 0);
+    TEST_ASSERT_EQUAL(ELRS_MSP_MAX_PACKAGES, sender.GetCurrentPayload(data, sizeof(data)));
+    sender.ConfirmCurrentPayload(false, 0);
+    TEST_ASSERT_EQUAL(1, sender.GetCurrentPayload(data, sizeof(data)));
+    sender.ConfirmCurrentPayload(true, 0);
+    TEST_ASSERT_EQUAL(2, sender.GetCurrentPayload(data, sizeof(data)));
+    TEST_ASSERT_EQUAL(2, sender.GetCurrentPayload(data, sizeof(data)));
+}
+
+/***
+ * Simulate MSP being sent on the uplink with the confirm coming back in link stats
+ * every few packets, with both directions losing packets at random. The link stats
+ * period is odd so the non-windowed resends of package 1 do not lock step with it.
+ * Returns the goodput in bytes per uplink packet.
+ ***/
+static double stubborn_goodput(double lossRate, bool sack)
+{
+    constexpr unsigned packets = 20000;
+    constexpr unsigned packetsPerLinkStats = 3;
+    uint8_t mspSequence[ELRS_MSP_BUFFER];
+    uint8_t buffer[ELRS_MSP_BUFFER];
+    uint8_t data[ELRS4_MSP_BYTES_PER_CALL];
+    uint32_t rng = 0x1234567;
+    unsigned bytesDelivered = 0;
+
+    receiver.setMaxPackageIndex(ELRS_MSP_MAX_PACKAGES);
+    receiver.ResetState();
+    receiver.SetDataToReceive(buffer, sizeof(buffer));
+    sender.setMaxPackageIndex(ELRS_MSP_MAX_PACKAGES);
+    sender.ResetState();
+    sender.UpdateTelemetryRate(0, 2, 1);
+
+    for (unsigned i = 0; i < packets; i++)
+    {
+        if (!sender.IsActive())
+        {
+            for (int b = 0; b < sizeof(mspSequence); b++)
+                mspSequence[b] = i + b;
+            sender.SetDataToTransmit(mspSequence, sizeof(mspSequence));
+        }
+
+        uint8_t packageIndex = sender.GetCurrentPayload(data, sizeof(data));
+        rng = rng * 1664525 + 1013904223;
+        if ((rng >> 8) % 1000 >= lossRate * 1000)
+        {
+            receiver.ReceiveData(packageIndex, data, sizeof(data));
+        }
+        if (receiver.HasFinishedData())
+        {
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(mspSequence, buffer, sizeof(mspSequence));
+            bytesDelivered += sizeof(mspSequence);
+            receiver.Unlock();
+        }
+
+        rng = rng * 1664525 + 1013904223;
+        if ((i % packetsPerLinkStats) == 0 && (rng >> 8) % 1000 >= lossRate * 1000)
+        {
+            sender.ConfirmCurrentPayload(receiver.GetCurrentConfirm(), sack ? receiver.GetCurrentSack() : 0);
+        }
+    }
+
+    return (double)bytesDelivered / packets;
+}
+
+void test_stubborn_window_goodput(void)
+{
+    const double lossRates[] = {0.0, 0.1, 0.2, 0.3};
+    for (double lossRate : lossRates)
+    {
+        double stopAndWait = stubborn_goodput(lossRate, false);
+        double windowed = stubborn_goodput(lossRate, true);
+        char msg[100];
+        snprintf(msg, sizeof(msg), "loss %2.0f%%: stop-and-wait %.2f B/pkt, windowed %.2f B/pkt",
+            lossRate * 100, stopAndWait, windowed);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(stopAndWait > 0);
+        TEST_ASSERT_TRUE(windowed > stopAndWait * 1.5);
+    }
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -524,6 +670,9 @@ int main(int argc, char **argv)
     RUN_TEST(test_stubborn_link_variable_size_per_call);
     RUN_TEST(test_stubborn_link_premature_advance);
     RUN_TEST(test_stubborn_link_forlorn_receiver);
+    RUN_TEST(test_stubborn_window_sends_ahead);
+    RUN_TEST(test_stubborn_window_falls_back_without_sack);
+    RUN_TEST(test_stubborn_window_goodput);
     UNITY_END();
 
     return 0;
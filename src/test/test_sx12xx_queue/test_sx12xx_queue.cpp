@@ -0,0 +1,175 @@
+#include <cstdint>
+#include <SX12xxCommandQueue.h>
+#include <unity.h>
+#include <vector>
+
+using namespace std;
+
+// A model of the SPI bus and BUSY lines of two radios. A radio stays busy for
+// `busyCycles` polls after each command it is sent.
+class MockBus
+{
+public:
+    uint32_t busyCycles = 4;
+    uint32_t busy[2] = {0, 0};
+    uint32_t waits = 0;
+    uint32_t waitCycles = 0;
+    uint32_t transactions = 0;
+    uint32_t writesWhileBusy = 0;
+    uint32_t unalignedWrites = 0;
+    vector<vector<uint8_t>> written;
+
+    bool WaitOnBusy(SX12XX_Radio_Number_t radioNumber)
+    {
+        waits++;
+        while (((radioNumber & SX12XX_Radio_1) && busy[0]) || ((radioNumber & SX12XX_Radio_2) && busy[1]))
+        {
+            waitCycles++;
+            if (busy[0]) busy[0]--;
+            if (busy[1]) busy[1]--;
+        }
+        return true;
+    }
+
+    void WriteRaw(uint8_t *buffer, uint8_t size, SX12XX_Radio_Number_t radioNumber)
+    {
+        transactions++;
+        if (((uintptr_t)buffer & 3) != 0)
+            unalignedWrites++;
+        for (int i = 0; i < 2; i++)
+        {
+            if (radioNumber & (1 << i))
+            {
+                if (busy[i])
+                    writesWhileBusy++;
+                busy[i] = busyCycles;
+            }
+        }
+        written.push_back(vector<uint8_t>(buffer, buffer + size));
+    }
+
+    void BusyDelay(uint32_t duration) {}
+};
+
+typedef SX12xxCommandQueue<3, 28> TestQueue;
+
+static const uint8_t setFs[] = {0x00};
+static const uint8_t setTx[] = {0x02, 0xFF, 0xFF};
+static const uint8_t payload[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D};
+
+static void add_write_buffer(TestQueue &queue, SX12XX_Radio_Number_t radioNumber)
+{
+    uint8_t *buf = queue.add(radioNumber, sizeof(payload) + 2);
+    TEST_ASSERT_NOT_NULL(buf);
+    buf[0] = 0x1A;
+    buf[1] = 0x00;
+    memcpy(buf + 2, payload, sizeof(payload));
+}
+
+void test_queue_layout(void)
+{
+    TestQueue queue;
+    MockBus bus;
+
+    TEST_ASSERT_TRUE(queue.add(SX12XX_Radio_1, 0xC1, setFs, sizeof(setFs)));
+    add_write_buffer(queue, SX12XX_Radio_1);
+    TEST_ASSERT_TRUE(queue.add(SX12XX_Radio_1, 0x83, setTx, sizeof(setTx)));
+    TEST_ASSERT_EQUAL(3, queue.count());
+    queue.execute(bus);
+
+    TEST_ASSERT_EQUAL(3, bus.transactions);
+    TEST_ASSERT_EQUAL(0, bus.unalignedWrites);
+    TEST_ASSERT_EQUAL(2, bus.written[0].size());
+    TEST_ASSERT_EQUAL(0xC1, bus.written[0][0]);
+    TEST_ASSERT_EQUAL(sizeof(payload) + 2, bus.written[1].size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, &bus.written[1][2], sizeof(payload));
+    TEST_ASSERT_EQUAL(4, bus.written[2].size());
+    TEST_ASSERT_EQUAL(0x83, bus.written[2][0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(setTx, &bus.written[2][1], sizeof(setTx));
+}
+
+void test_queue_full(void)
+{
+    TestQueue queue;
+
+    add_write_buffer(queue, SX12XX_Radio_1); // 16 bytes
+    TEST_ASSERT_NOT_NULL(queue.add(SX12XX_Radio_1, 5)); // 8 bytes
+    TEST_ASSERT_NULL(queue.add(SX12XX_Radio_1, 5)); // no room for another 8
+    TEST_ASSERT_NOT_NULL(queue.add(SX12XX_Radio_1, 4));
+    TEST_ASSERT_NULL(queue.add(SX12XX_Radio_1, 0)); // no more commands
+    TEST_ASSERT_EQUAL(3, queue.count());
+
+    queue.clear();
+    TEST_ASSERT_EQUAL(0, queue.count());
+    TEST_ASSERT_NOT_NULL(queue.add(SX12XX_Radio_1, 28));
+}
+
+// Diversity TX: idle radio to FS, then load and start the TX radio
+void test_queue_dual_radio_tx(void)
+{
+    TestQueue queue;
+    MockBus bus;
+    bus.busy[0] = 2;
+    bus.busy[1] = 3;
+
+    TEST_ASSERT_TRUE(queue.add(SX12XX_Radio_2, 0xC1, setFs, sizeof(setFs), 70));
+    add_write_buffer(queue, SX12XX_Radio_1);
+    TEST_ASSERT_TRUE(queue.add(SX12XX_Radio_1, 0x83, setTx, sizeof(setTx), 100));
+    queue.execute(bus);
+
+    // Both radios up front, then only radio 1 between the buffer and SetTx
+    TEST_ASSERT_EQUAL(3, bus.transactions);
+    TEST_ASSERT_EQUAL(2, bus.waits);
+    TEST_ASSERT_EQUAL(3 + bus.busyCycles, bus.waitCycles);
+    TEST_ASSERT_EQUAL(0, bus.writesWhileBusy);
+}
+
+void test_queue_same_radio_waits_each_command(void)
+{
+    TestQueue queue;
+    MockBus bus;
+
+    add_write_buffer(queue, SX12XX_Radio_All);
+    TEST_ASSERT_TRUE(queue.add(SX12XX_Radio_All, 0x83, setTx, sizeof(setTx)));
+    queue.execute(bus);
+
+    TEST_ASSERT_EQUAL(2, bus.transactions);
+    TEST_ASSERT_EQUAL(2, bus.waits);
+    TEST_ASSERT_EQUAL(bus.busyCycles, bus.waitCycles);
+    TEST_ASSERT_EQUAL(0, bus.writesWhileBusy);
+
+    // Running the plan again waits for the SetTx from the previous run first
+    bus.waits = 0;
+    bus.waitCycles = 0;
+    queue.execute(bus);
+    TEST_ASSERT_EQUAL(2, bus.waits);
+    TEST_ASSERT_EQUAL(2 * bus.busyCycles, bus.waitCycles);
+    TEST_ASSERT_EQUAL(0, bus.writesWhileBusy);
+}
+
+void test_queue_empty(void)
+{
+    TestQueue queue;
+    MockBus bus;
+
+    queue.execute(bus);
+    TEST_ASSERT_EQUAL(0, bus.transactions);
+    TEST_ASSERT_EQUAL(0, bus.waits);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_layout);
+    RUN_TEST(test_queue_full);
+    RUN_TEST(test_queue_dual_radio_tx);
+    RUN_TEST(test_queue_same_radio_waits_each_command);
+    RUN_TEST(test_queue_empty);
+    UNITY_END();
+
+    return 0;
+}
@@ -237,6 +237,65 @@ void test_function_add_type_with_zero_crc(void)
     }
 }
 
+void test_function_skip_unchanged(void)
+{
+    telemetry.ResetState();
+    uint8_t batterySequence[] = {0xEC,10,CRSF_FRAMETYPE_BATTERY_SENSOR,0,0,0,0,0,0,0,0,109};
+    uint8_t* data;
+    uint8_t receivedLength;
+
+    sendData(batterySequence, sizeof(batterySequence));
+    TEST_ASSERT_EQUAL(true, telemetry.GetNextPayload(&receivedLength, &data, 1000));
+    // Sending done
+    TEST_ASSERT_EQUAL(false, telemetry.GetNextPayload(&receivedLength, &data, 1000));
+
+    // The same battery frame again is not sent until the keepalive time
+    sendData(batterySequence, sizeof(batterySequence));
+    TEST_ASSERT_EQUAL(0, telemetry.UpdatedPayloadCount());
+    TEST_ASSERT_EQUAL(false, telemetry.GetNextPayload(&receivedLength, &data, 1000 + TELEMETRY_UNCHANGED_RESEND_MS - 1));
+    TEST_ASSERT_EQUAL(true, telemetry.GetNextPayload(&receivedLength, &data, 1000 + TELEMETRY_UNCHANGED_RESEND_MS));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(batterySequence, data, sizeof(batterySequence));
+
+    TEST_ASSERT_EQUAL(false, telemetry.GetNextPayload(&receivedLength, &data, 3000));
+    TEST_ASSERT_EQUAL(2, telemetry.PayloadSentCount(CRSF_FRAMETYPE_BATTERY_SENSOR));
+}
+
+void test_function_schedule_interval_and_age(void)
+{
+    telemetry.ResetState();
+    uint8_t batterySequence[] = {0xEC,10,CRSF_FRAMETYPE_BATTERY_SENSOR,0,0,0,0,0,0,0,0,109};
+    uint8_t attitudeSequence[] = {0xEC,8,CRSF_FRAMETYPE_ATTITUDE,0,0,0,0,0,0,48};
+    uint8_t attitudeSequence2[] = {0xEC,8,CRSF_FRAMETYPE_ATTITUDE,1,0,0,0,0,0,168};
+    uint8_t* data;
+    uint8_t receivedLength;
+    uint32_t now = 10000;
+
+    // Battery has been sent recently, attitude has not
+    sendData(batterySequence, sizeof(batterySequence));
+    telemetry.GetNextPayload(&receivedLength, &data, now);
+    telemetry.GetNextPayload(&receivedLength, &data, now);
+    batterySequence[3] = 1;
+    batterySequence[11] = 46;
+    sendData(batterySequence, sizeof(batterySequence));
+    sendData(attitudeSequence, sizeof(attitudeSequence));
+
+    // Attitude is due, battery isn't, so attitude goes first even though battery has waited longer
+    now += 50;
+    TEST_ASSERT_EQUAL(true, telemetry.GetNextPayload(&receivedLength, &data, now));
+    TEST_ASSERT_EQUAL(CRSF_FRAMETYPE_ATTITUDE, data[CRSF_TELEMETRY_TYPE_INDEX]);
+
+    // Battery goes next, then the attitude which was updated while battery was being sent
+    TEST_ASSERT_EQUAL(true, telemetry.GetNextPayload(&receivedLength, &data, now));
+    TEST_ASSERT_EQUAL(CRSF_FRAMETYPE_BATTERY_SENSOR, data[CRSF_TELEMETRY_TYPE_INDEX]);
+    sendData(attitudeSequence2, sizeof(attitudeSequence2));
+    TEST_ASSERT_EQUAL(true, telemetry.GetNextPayload(&receivedLength, &data, now));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(attitudeSequence2, data, sizeof(attitudeSequence2));
+
+    TEST_ASSERT_EQUAL(false, telemetry.GetNextPayload(&receivedLength, &data, now));
+    TEST_ASSERT_EQUAL(2, telemetry.PayloadSentCount(CRSF_FRAMETYPE_BATTERY_SENSOR));
+    TEST_ASSERT_EQUAL(2, telemetry.PayloadSentCount(CRSF_FRAMETYPE_ATTITUDE));
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -255,6 +314,8 @@ int main(int argc, char **argv)
     RUN_TEST(test_function_store_unknown_type_two_slots);
     RUN_TEST(test_function_store_ardupilot_status_text);
     RUN_TEST(test_function_add_type_with_zero_crc);
+    RUN_TEST(test_function_skip_unchanged);
+    RUN_TEST(test_function_schedule_interval_and_age);
     UNITY_END();
 
     return 0;
@@ -0,0 +1,214 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <telemetry_compact.h>
+#include <unity.h>
+
+#include "CRSF.h"
+
+static uint8_t makeFrame(uint8_t type, void const *payload, uint8_t payloadLen, uint8_t *frame)
+{
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    frame[CRSF_TELEMETRY_LENGTH_INDEX] = CRSF_FRAME_SIZE(payloadLen);
+    frame[CRSF_TELEMETRY_TYPE_INDEX] = type;
+    memcpy(&frame[CRSF_TELEMETRY_TYPE_INDEX + 1], payload, payloadLen);
+    frame[CRSF_TELEMETRY_TYPE_INDEX + 1 + payloadLen] = crsf_crc.calc(&frame[CRSF_TELEMETRY_TYPE_INDEX], payloadLen + 1);
+    return CRSF_FRAME_NOT_COUNTED_BYTES + CRSF_FRAME_SIZE(payloadLen);
+}
+
+static void putBE(uint8_t *dst, uint32_t val, uint8_t len)
+{
+    for (int8_t i = len - 1; i >= 0; --i)
+    {
+        dst[i] = val & 0xff;
+        val >>= 8;
+    }
+}
+
+/***
+ * A stream of frames like a plane flying a wide circle, with GPS at 10Hz and attitude and
+ * battery interleaved. `i` is the frame number.
+ ***/
+static uint8_t makeFlightFrame(unsigned i, uint8_t *frame)
+{
+    unsigned const t = i / 3;
+    switch (i % 3)
+    {
+    case 0:
+    {
+        uint8_t gps[CRSF_FRAME_GPS_PAYLOAD_SIZE];
+        putBE(&gps[0], 473977420 + t * 173 - (t * t) / 40, 4);  // lat
+        putBE(&gps[4], 85455940 + t * 201 + (t * t) / 55, 4);   // lon
+        putBE(&gps[8], 720 + (t % 7), 2);                       // groundspeed
+        putBE(&gps[10], (4500 + t * 30) % 36000, 2);            // heading
+        putBE(&gps[12], 1120 + t / 10, 2);                      // altitude
+        gps[14] = 14 + (t / 50) % 2;                            // sats
+        return makeFrame(CRSF_FRAMETYPE_GPS, gps, sizeof(gps), frame);
+    }
+    case 1:
+    {
+        uint8_t att[CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE];
+        putBE(&att[0], (uint16_t)(int16_t)(800 + (t % 23) * 3), 2);   // pitch
+        putBE(&att[2], (uint16_t)(int16_t)(-2500 + (t % 17) * 5), 2); // roll
+        putBE(&att[4], (uint16_t)(int16_t)(t * 52 % 31416), 2);       // yaw
+        return makeFrame(CRSF_FRAMETYPE_ATTITUDE, att, sizeof(att), frame);
+    }
+    default:
+    {
+        uint8_t batt[CRSF_FRAME_BATTERY_SENSOR_PAYLOAD_SIZE];
+        putBE(&batt[0], 164 - t / 100, 2);      // voltage
+        putBE(&batt[2], 182 + (t % 5), 2);      // current
+        putBE(&batt[4], 350 + t / 4, 3);        // capacity
+        batt[7] = 80 - t / 200;                 // remaining
+        return makeFrame(CRSF_FRAMETYPE_BATTERY_SENSOR, batt, sizeof(batt), frame);
+    }
+    }
+}
+
+void test_compact_round_trip(void)
+{
+    TelemetryCompactEncoder encoder;
+    TelemetryCompactDecoder decoder;
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    uint8_t encoded[CRSF_FRAME_SIZE_MAX];
+    uint8_t decoded[CRSF_FRAME_SIZE_MAX];
+    unsigned fullBytes = 0;
+    unsigned compactBytes = 0;
+    unsigned gpsFullBytes = 0;
+    unsigned gpsCompactBytes = 0;
+
+    for (unsigned i = 0; i < 3000; i++)
+    {
+        uint8_t const frameSize = makeFlightFrame(i, frame);
+        uint8_t const encodedSize = encoder.Encode(frame, encoded);
+        TEST_ASSERT_NOT_EQUAL(0, encodedSize);
+        TEST_ASSERT_TRUE(encodedSize <= frameSize);
+        TEST_ASSERT_TRUE(TelemetryCompact::IsCompact(encoded));
+
+        memset(decoded, 0, sizeof(decoded));
+        TEST_ASSERT_TRUE(decoder.Decode(encoded, decoded));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, decoded, frameSize);
+
+        fullBytes += frameSize;
+        compactBytes += encodedSize;
+        if (frame[CRSF_TELEMETRY_TYPE_INDEX] == CRSF_FRAMETYPE_GPS)
+        {
+            gpsFullBytes += frameSize;
+            gpsCompactBytes += encodedSize;
+        }
+    }
+
+    char msg[100];
+    snprintf(msg, sizeof(msg), "all frames %u -> %u bytes (%.0f%%), GPS %u -> %u bytes (%.0f%%)",
+        fullBytes, compactBytes, 100.0 * compactBytes / fullBytes,
+        gpsFullBytes, gpsCompactBytes, 100.0 * gpsCompactBytes / gpsFullBytes);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(compactBytes * 10 < fullBytes * 6);
+}
+
+void test_compact_unsupported_type_unchanged(void)
+{
+    TelemetryCompactEncoder encoder;
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    uint8_t encoded[CRSF_FRAME_SIZE_MAX];
+    char const flightMode[] = "ACRO";
+
+    makeFrame(CRSF_FRAMETYPE_FLIGHT_MODE, flightMode, sizeof(flightMode), frame);
+    TEST_ASSERT_EQUAL(0, encoder.Encode(frame, encoded));
+    TEST_ASSERT_FALSE(TelemetryCompact::IsCompact(frame));
+}
+
+void test_compact_lost_frame_waits_for_keyframe(void)
+{
+    TelemetryCompactEncoder encoder;
+    TelemetryCompactDecoder decoder;
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    uint8_t encoded[CRSF_FRAME_SIZE_MAX];
+    uint8_t decoded[CRSF_FRAME_SIZE_MAX];
+    unsigned i = 0;
+
+    // Keyframe and a delta of every type
+    for (; i < 6; i++)
+    {
+        makeFlightFrame(i, frame);
+        encoder.Encode(frame, encoded);
+        TEST_ASSERT_TRUE(decoder.Decode(encoded, decoded));
+    }
+
+    // A GPS delta is lost
+    makeFlightFrame(i++, frame);
+    encoder.Encode(frame, encoded);
+    TEST_ASSERT_EQUAL(TLM_COMPACT_DELTA, encoded[0] & TLM_COMPACT_DELTA);
+
+    // The following GPS deltas are dropped until a keyframe, the other types are unaffected
+    unsigned gpsDropped = 0;
+    for (; i < 3 * 2 * TLM_COMPACT_KEYFRAME_INTERVAL; i++)
+    {
+        uint8_t const frameSize = makeFlightFrame(i, frame);
+        encoder.Encode(frame, encoded);
+        if (decoder.Decode(encoded, decoded))
+        {
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, decoded, frameSize);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(CRSF_FRAMETYPE_GPS, frame[CRSF_TELEMETRY_TYPE_INDEX]);
+            TEST_ASSERT_EQUAL(TLM_COMPACT_DELTA, encoded[0] & TLM_COMPACT_DELTA);
+            TEST_ASSERT_EQUAL(gpsDropped, (i - 6) / 3 - 1);
+            gpsDropped++;
+        }
+    }
+    TEST_ASSERT_EQUAL(TLM_COMPACT_KEYFRAME_INTERVAL - 2, gpsDropped);
+}
+
+void test_compact_stays_enabled_for_connection(void)
+{
+    TelemetryCompactEncoder encoder;
+    TelemetryCompactDecoder decoder;
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    uint8_t encoded[CRSF_FRAME_SIZE_MAX];
+    uint8_t decoded[CRSF_FRAME_SIZE_MAX];
+    unsigned i = 0;
+
+    // Nothing is compact until the TX asks
+    makeFlightFrame(i++, frame);
+    TEST_ASSERT_EQUAL(0, encoder.EncodeIfEnabled(frame, encoded));
+
+    // A TX which can't decode this version
+    encoder.HandleRequest(TLM_COMPACT_VERSION + 1);
+    makeFlightFrame(i++, frame);
+    TEST_ASSERT_EQUAL(0, encoder.EncodeIfEnabled(frame, encoded));
+
+    // The request is only sent once per connection, every frame after it must be compact
+    encoder.HandleRequest(TLM_COMPACT_VERSION);
+    for (; i < 300; i++)
+    {
+        uint8_t const frameSize = makeFlightFrame(i, frame);
+        uint8_t const size = encoder.EncodeIfEnabled(frame, encoded);
+        TEST_ASSERT_NOT_EQUAL(0, size);
+        TEST_ASSERT_TRUE(TelemetryCompact::IsCompact(encoded));
+        TEST_ASSERT_TRUE(decoder.Decode(encoded, decoded));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, decoded, frameSize);
+    }
+
+    // Until the connection is lost
+    encoder.Disable();
+    makeFlightFrame(i++, frame);
+    TEST_ASSERT_EQUAL(0, encoder.EncodeIfEnabled(frame, encoded));
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_compact_round_trip);
+    RUN_TEST(test_compact_unsupported_type_unchanged);
+    RUN_TEST(test_compact_lost_frame_waits_for_keyframe);
+    RUN_TEST(test_compact_stays_enabled_for_connection);
+    UNITY_END();
+
+    return 0;
+}
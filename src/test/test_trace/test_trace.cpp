@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <trace.h>
+#include <unity.h>
+
+void test_trace_read_in_order(void)
+{
+    TraceBuffer<8> trace;
+    uint32_t cursor = 0;
+    uint32_t lost = 0;
+    trace_entry_t entry;
+
+    TEST_ASSERT_FALSE(trace.read(cursor, entry, lost));
+    trace.record(TRACE_TIMER_TICK, 100);
+    trace.record(TRACE_RX_DONE, 250);
+
+    TEST_ASSERT_TRUE(trace.read(cursor, entry, lost));
+    TEST_ASSERT_EQUAL(TRACE_TIMER_TICK, entry.event);
+    TEST_ASSERT_EQUAL(100, entry.timestamp);
+    TEST_ASSERT_TRUE(trace.read(cursor, entry, lost));
+    TEST_ASSERT_EQUAL(TRACE_RX_DONE, entry.event);
+    TEST_ASSERT_EQUAL(250, entry.timestamp);
+    TEST_ASSERT_FALSE(trace.read(cursor, entry, lost));
+    TEST_ASSERT_EQUAL(0, lost);
+}
+
+void test_trace_overwrite_counts_lost(void)
+{
+    TraceBuffer<8> trace;
+    uint32_t cursor = 0;
+    uint32_t lost = 0;
+    trace_entry_t entry;
+
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        trace.record(TRACE_TIMER_TOCK, i);
+    }
+
+    // Only the newest 8 are left
+    for (uint32_t i = 12; i < 20; i++)
+    {
+        TEST_ASSERT_TRUE(trace.read(cursor, entry, lost));
+        TEST_ASSERT_EQUAL(i, entry.timestamp);
+        TEST_ASSERT_EQUAL(12, lost);
+    }
+    TEST_ASSERT_FALSE(trace.read(cursor, entry, lost));
+
+    // Reading continues from the cursor once caught up
+    lost = 0;
+    trace.record(TRACE_TX_DONE, 20);
+    TEST_ASSERT_TRUE(trace.read(cursor, entry, lost));
+    TEST_ASSERT_EQUAL(TRACE_TX_DONE, entry.event);
+    TEST_ASSERT_EQUAL(20, entry.timestamp);
+    TEST_ASSERT_EQUAL(0, lost);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_trace_read_in_order);
+    RUN_TEST(test_trace_overwrite_counts_lost);
+    UNITY_END();
+
+    return 0;
+}